@@ -13,12 +13,12 @@
 #include "base/trace_event/trace_flush.h"
 
 namespace {
-std::shared_ptr<base::SequencedTaskRunner> tr1;
-std::shared_ptr<base::SequencedTaskRunner> tr2;
+base::scoped_refptr<base::SequencedTaskRunner> tr1;
+base::scoped_refptr<base::SequencedTaskRunner> tr2;
 }  // namespace
 
-void Task1(std::shared_ptr<base::TaskRunner> current,
-           std::shared_ptr<base::TaskRunner> next,
+void Task1(base::scoped_refptr<base::TaskRunner> current,
+           base::scoped_refptr<base::TaskRunner> next,
            base::WaitableEvent* five_left_event,
            base::AutoSignaller finished_event,
            int n) {
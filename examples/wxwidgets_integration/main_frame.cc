@@ -3,7 +3,7 @@
 #include "wx/msgdlg.h"
 #include "wx/panel.h"
 
-MainFrame::MainFrame(std::shared_ptr<base::SequencedTaskRunner> task_runner)
+MainFrame::MainFrame(base::scoped_refptr<base::SequencedTaskRunner> task_runner)
     : wxFrame(nullptr,
               wxID_ANY,
               "wxWidgets integration example",
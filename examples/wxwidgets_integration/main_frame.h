@@ -10,13 +10,13 @@
 
 class MainFrame : public wxFrame {
  public:
-  MainFrame(std::shared_ptr<base::SequencedTaskRunner> task_runner);
+  MainFrame(base::scoped_refptr<base::SequencedTaskRunner> task_runner);
 
  private:
   void OnButtonClicked(wxCommandEvent& event);
   void ShowMessageBox();
 
-  std::shared_ptr<base::SequencedTaskRunner> task_runner_;
+  base::scoped_refptr<base::SequencedTaskRunner> task_runner_;
   wxButton* m_button;
 
   base::WeakPtr<MainFrame> weak_this_;
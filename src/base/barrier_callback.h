@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
@@ -39,6 +43,68 @@ class BarrierCallbackHelper {
   std::size_t required_run_count_;
   OnceCallback<void(CallbackArgumentsType)> callback_;
 };
+
+// Results can be written to pre-sized slots of a vector concurrently, as long
+// as its elements are default constructible and are not packed into bits.
+template <typename ElementType, typename ArgumentsStorageType>
+struct HasBarrierSlots : std::false_type {};
+
+template <typename ElementType, typename ValueType, typename Allocator>
+struct HasBarrierSlots<ElementType, std::vector<ValueType, Allocator>>
+    : std::bool_constant<std::is_default_constructible_v<ValueType> &&
+                         std::is_assignable_v<ValueType&, ElementType> &&
+                         !std::is_same_v<ValueType, bool>> {};
+
+template <typename ElementType, typename CallbackArgumentsType>
+inline constexpr bool kHasBarrierSlots =
+    HasBarrierSlots<ElementType,
+                    traits::RemoveCVRefT<CallbackArgumentsType>>::value;
+
+// Lock-free version of `BarrierCallbackHelper`. Each run writes its element to
+// its own slot (either the next free one or one chosen by the caller), so only
+// the counters are shared between concurrent runs.
+template <typename ElementType, typename CallbackArgumentsType>
+class BarrierCallbackSlotsHelper {
+ public:
+  BarrierCallbackSlotsHelper(size_t required_run_count,
+                             OnceCallback<void(CallbackArgumentsType)> callback)
+      : arguments_(required_run_count),
+        next_slot_index_(0),
+        remaining_run_count_(required_run_count),
+        callback_(std::move(callback)) {}
+
+  void Run(ElementType element) {
+    const size_t index =
+        next_slot_index_.fetch_add(1, std::memory_order_relaxed);
+    RunAt(index, std::forward<ElementType>(element));
+  }
+
+  void RunAt(size_t index, ElementType element) {
+    // Writing out of bounds or to already handed over slots would corrupt
+    // memory, so these are checked in release builds as well.
+    CHECK_GT(remaining_run_count_.load(std::memory_order_acquire), 0u)
+        << "Barrier callback run more times than required";
+    CHECK_LT(index, arguments_.size());
+    arguments_[index] = std::forward<ElementType>(element);
+
+    // Whoever fills the last slot observes writes to all the other ones.
+    const size_t previous_remaining_run_count =
+        remaining_run_count_.fetch_sub(1, std::memory_order_acq_rel);
+    CHECK_GT(previous_remaining_run_count, 0u)
+        << "Barrier callback run more times than required";
+    if (previous_remaining_run_count == 1) {
+      std::move(callback_).Run(std::move(arguments_));
+    }
+  }
+
+ private:
+  using ArgumentsStorageType = traits::RemoveCVRefT<CallbackArgumentsType>;
+
+  ArgumentsStorageType arguments_;
+  std::atomic<size_t> next_slot_index_;
+  std::atomic<size_t> remaining_run_count_;
+  OnceCallback<void(CallbackArgumentsType)> callback_;
+};
 }  // namespace detail
 
 template <typename ElementType, typename CallbackArgumentsType>
@@ -50,8 +116,10 @@ RepeatingCallback<void(ElementType)> BarrierCallback(
     return {};
   }
 
-  using Helper =
-      detail::BarrierCallbackHelper<ElementType, CallbackArgumentsType>;
+  using Helper = std::conditional_t<
+      detail::kHasBarrierSlots<ElementType, CallbackArgumentsType>,
+      detail::BarrierCallbackSlotsHelper<ElementType, CallbackArgumentsType>,
+      detail::BarrierCallbackHelper<ElementType, CallbackArgumentsType>>;
   return BindRepeating(
       &Helper::Run,
       Owned(std::make_unique<Helper>(required_run_count, std::move(callback))));
@@ -66,4 +134,38 @@ RepeatingCallback<void(ElementType)> BarrierCallback(
       OnceCallback<void(CallbackArgumentsType)>{std::move(callback)});
 }
 
+// Same as `BarrierCallback()`, but each run passes the index at which its
+// element is stored, so that the elements are passed to |callback| in the
+// order chosen by the caller (e.g. the order in which the work was posted)
+// rather than in the order of runs. Each index in [0, |required_run_count|)
+// must be used exactly once.
+template <typename ElementType, typename CallbackArgumentsType>
+RepeatingCallback<void(size_t, ElementType)> IndexedBarrierCallback(
+    size_t required_run_count,
+    OnceCallback<void(CallbackArgumentsType)> callback) {
+  static_assert(detail::kHasBarrierSlots<ElementType, CallbackArgumentsType>,
+                "IndexedBarrierCallback requires a std::vector of default "
+                "constructible elements (other than bool)");
+
+  if (required_run_count == 0) {
+    std::move(callback).Run(CallbackArgumentsType{});
+    return {};
+  }
+
+  using Helper =
+      detail::BarrierCallbackSlotsHelper<ElementType, CallbackArgumentsType>;
+  return BindRepeating(
+      &Helper::RunAt,
+      Owned(std::make_unique<Helper>(required_run_count, std::move(callback))));
+}
+
+template <typename ElementType, typename CallbackArgumentsType>
+RepeatingCallback<void(size_t, ElementType)> IndexedBarrierCallback(
+    size_t required_run_count,
+    RepeatingCallback<void(CallbackArgumentsType)> callback) {
+  return IndexedBarrierCallback<ElementType>(
+      required_run_count,
+      OnceCallback<void(CallbackArgumentsType)>{std::move(callback)});
+}
+
 }  // namespace base
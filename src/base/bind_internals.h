@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -42,15 +43,25 @@ using BindResultType =
 
 class BindAccessHelper {
  public:
-  template <typename CallbackType, typename ImplType>
-  static CallbackType Create(ImplType impl) {
-    return CallbackType{std::move(impl)};
+  template <typename CallbackType,
+            typename StateType,
+            bool is_repeating,
+            typename... Arguments>
+  static CallbackType Create(Arguments&&... arguments) {
+    using ImplType = typename CallbackType::ImplType;
+    return CallbackType{ImplType::template Create<StateType, is_repeating>(
+        std::forward<Arguments>(arguments)...)};
   }
 
   template <typename CallbackType>
   static auto ExtractImpl(CallbackType callback) {
     return std::move(callback.impl_);
   }
+
+  template <typename StateType, bool is_repeating, typename CallbackType>
+  static StateType* GetStateIf(CallbackType& callback) {
+    return callback.impl_.template GetStateIf<StateType, is_repeating>();
+  }
 };
 
 //
@@ -161,7 +172,7 @@ struct FunctorTraits {
 template <typename FunctorType>
 struct IgnoreResultType {
   template <typename... ArgumentsType>
-  void operator()(ArgumentsType&&... arguments) {
+  void operator()(ArgumentsType&&... arguments) const {
     static_cast<void>(
         std::invoke(functor, std::forward<ArgumentsType>(arguments)...));
   }
@@ -385,19 +396,43 @@ struct WrapTypesHelper<std::tuple<FunctorTypes...>, std::tuple<ArgTypes...>> {
 };
 
 //
-// Callback implementation
+// Cancellation traits: methods bound to a `WeakPtr` receiver are cancelled
+// once it is invalidated, callbacks bound as functors forward the queries.
 //
 
-template <typename DerivedType, typename ReturnType, typename... ArgumentTypes>
-class RepeatingCallbackCrtpImpl
-    : public RepeatingCallbackInterface<ReturnType, ArgumentTypes...> {
- public:
-  std::unique_ptr<RepeatingCallbackInterface<ReturnType, ArgumentTypes...>>
-  Clone() const override {
-    const auto* this_derived = static_cast<const DerivedType*>(this);
-    return std::make_unique<DerivedType>(*this_derived);
-  }
-};
+template <typename T>
+struct IsWeakPtr : std::false_type {};
+
+template <typename T>
+struct IsWeakPtr<WeakPtr<T>> : std::true_type {};
+
+template <typename T>
+struct IsCallbackFunctor : std::false_type {};
+
+template <typename ReturnType, typename... ArgumentTypes>
+struct IsCallbackFunctor<OnceCallback<ReturnType(ArgumentTypes...)>>
+    : std::true_type {};
+
+template <typename ReturnType, typename... ArgumentTypes>
+struct IsCallbackFunctor<RepeatingCallback<ReturnType(ArgumentTypes...)>>
+    : std::true_type {};
+
+template <typename FunctorType, typename BoundArgumentsTupleType>
+struct IsWeakMethod : std::false_type {};
+
+template <typename FunctorType,
+          typename FirstBoundArgumentType,
+          typename... BoundArgumentTypes>
+struct IsWeakMethod<
+    FunctorType,
+    std::tuple<FirstBoundArgumentType, BoundArgumentTypes...>>
+    : std::bool_constant<std::is_member_function_pointer_v<FunctorType> &&
+                         IsWeakPtr<FirstBoundArgumentType>::value> {};
+
+//
+// Callback state: functor with its bound arguments. It is stored (inline, if
+// possible) and invoked by `CallbackImpl` through a static operations table.
+//
 
 template <bool is_repeating,
           typename FunctorTraits,
@@ -420,38 +455,45 @@ class FunctorCallback<is_repeating,
                       FunctorType,
                       ReturnType,
                       std::tuple<BoundArgumentTypes...>,
-                      std::tuple<RunArgumentTypes...>>
-    : public std::conditional_t<
-          is_repeating,
-          RepeatingCallbackCrtpImpl<
-              FunctorCallback<is_repeating,
-                              FunctorTraits,
-                              FunctorType,
-                              ReturnType,
-                              std::tuple<BoundArgumentTypes...>,
-                              std::tuple<RunArgumentTypes...>>,
-              ReturnType,
-              RunArgumentTypes...>,
-          OnceCallbackInterface<ReturnType, RunArgumentTypes...>> {
+                      std::tuple<RunArgumentTypes...>> {
  public:
   using RawFunctorType = traits::RemoveCVRefT<FunctorType>;
 
+  static constexpr bool kIsWeakMethod =
+      IsWeakMethod<RawFunctorType, std::tuple<BoundArgumentTypes...>>::value;
+  static constexpr bool kIsCancellable =
+      kIsWeakMethod || IsCallbackFunctor<RawFunctorType>::value;
+
   FunctorCallback(FunctorType&& functor,
                   std::tuple<BoundArgumentTypes...>&& bound_arguments)
       : functor_(std::forward<FunctorType>(functor)),
         bound_arguments_(std::move(bound_arguments)) {}
 
-  ReturnType Run(RunArgumentTypes... arguments) override {
-    if constexpr (is_repeating) {
-      return FunctorTraits::Invoke(
-          functor_, std::make_index_sequence<sizeof...(BoundArgumentTypes)>{},
-          bound_arguments_, std::forward<RunArgumentTypes>(arguments)...);
+  // Used by repeating callbacks, whose state may be shared between copies.
+  ReturnType Run(RunArgumentTypes... arguments) const {
+    return FunctorTraits::Invoke(
+        functor_, std::make_index_sequence<sizeof...(BoundArgumentTypes)>{},
+        bound_arguments_, std::forward<RunArgumentTypes>(arguments)...);
+  }
+
+  ReturnType RunOnce(RunArgumentTypes... arguments) {
+    return FunctorTraits::Invoke(
+        std::move(functor_),
+        std::make_index_sequence<sizeof...(BoundArgumentTypes)>{},
+        std::move(bound_arguments_),
+        std::forward<RunArgumentTypes>(arguments)...);
+  }
+
+  bool QueryCancellation(CancellationQueryMode mode) const {
+    if constexpr (kIsWeakMethod) {
+      const auto& receiver = std::get<0>(bound_arguments_);
+      return mode == CancellationQueryMode::kIsCancelled
+                 ? !receiver
+                 : receiver.MaybeValid();
     } else {
-      return FunctorTraits::Invoke(
-          std::move(functor_),
-          std::make_index_sequence<sizeof...(BoundArgumentTypes)>{},
-          std::move(bound_arguments_),
-          std::forward<RunArgumentTypes>(arguments)...);
+      return mode == CancellationQueryMode::kIsCancelled
+                 ? functor_.IsCancelled()
+                 : functor_.MaybeValid();
     }
   }
 
@@ -494,12 +536,12 @@ auto Bind(Functor&& functor, Arguments&&... arguments) {
                      RemainingArgumentsType>;
 
   // 3. Create the callback object.
-  return BindAccessHelper::Create<ResultType>(
-      std::make_unique<
-          FunctorCallback<is_repeating, FunctorTraits, Functor,
-                          typename FunctorTraits::ReturnType,
-                          BoundArgumentsType, RemainingArgumentsType>>(
-          std::forward<Functor>(functor), std::move(bound_args)));
+  using StateType =
+      FunctorCallback<is_repeating, FunctorTraits, Functor,
+                      typename FunctorTraits::ReturnType, BoundArgumentsType,
+                      RemainingArgumentsType>;
+  return BindAccessHelper::Create<ResultType, StateType, is_repeating>(
+      std::forward<Functor>(functor), std::move(bound_args));
 }
 
 }  // namespace detail
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include "base/callback.h"
 #include "base/task_runner.h"
@@ -9,65 +10,75 @@
 namespace base {
 
 namespace detail {
-template <typename Callback, typename... Arguments>
-class BindPostTaskHelper {
+// Callback state of `BindPostTask()`. Task runner, location and the target
+// callback are all kept in the state itself, so binding allocates only once
+// and each invocation allocates (at most) the posted task.
+template <typename CallbackType, typename... Arguments>
+class BindPostTaskState {
  public:
-  BindPostTaskHelper(std::shared_ptr<TaskRunner> task_runner,
-                     Callback callback,
-                     SourceLocation location)
+  BindPostTaskState(scoped_refptr<TaskRunner> task_runner,
+                    CallbackType callback,
+                    SourceLocation location)
       : task_runner_(std::move(task_runner)),
         callback_(std::move(callback)),
-        location_(std::move(location)) {}
+        location_(location) {}
 
-  void Run(Arguments... arguments) {
-    if constexpr (traits::IsOnceCallbackV<Callback>) {
-      task_runner_->PostTask(location_,
-                             BindOnce(std::move(callback_),
-                                      std::forward<Arguments>(arguments)...));
+  // Used by (copies of) repeating callbacks that don't own the state.
+  void Run(Arguments... arguments) const {
+    task_runner_->PostTask(location_,
+                           MakeTask(CallbackType{callback_},
+                                    std::forward<Arguments>(arguments)...));
+  }
+
+  void RunOnce(Arguments... arguments) {
+    task_runner_->PostTask(location_,
+                           MakeTask(std::move(callback_),
+                                    std::forward<Arguments>(arguments)...));
+  }
+
+ private:
+  static OnceClosure MakeTask(CallbackType callback, Arguments... arguments) {
+    if constexpr (sizeof...(Arguments) == 0) {
+      // Callbacks without arguments are posted as-is, without a new state.
+      return OnceClosure{std::move(callback)};
     } else {
-      task_runner_->PostTask(
-          location_,
-          BindOnce(callback_, std::forward<Arguments>(arguments)...));
+      return BindOnce(std::move(callback),
+                      std::forward<Arguments>(arguments)...);
     }
   }
 
- private:
-  std::shared_ptr<TaskRunner> task_runner_;
-  Callback callback_;
+  scoped_refptr<TaskRunner> task_runner_;
+  CallbackType callback_;
   SourceLocation location_;
 };
 }  // namespace detail
 
 template <typename Return, typename... Arguments>
 OnceCallback<Return(Arguments...)> BindPostTask(
-    std::shared_ptr<TaskRunner> task_runner,
+    scoped_refptr<TaskRunner> task_runner,
     OnceCallback<Return(Arguments...)> callback,
     SourceLocation location) {
   static_assert(std::is_same_v<Return, void>,
                 "Cannot BindPostTask callback with non-void return type");
 
-  using Helper = detail::BindPostTaskHelper<OnceCallback<Return(Arguments...)>,
-                                            Arguments...>;
-  return BindOnce(&Helper::Run, base::Owned(std::make_unique<Helper>(
-                                    std::move(task_runner), std::move(callback),
-                                    std::move(location))));
+  using CallbackType = OnceCallback<Return(Arguments...)>;
+  using StateType = detail::BindPostTaskState<CallbackType, Arguments...>;
+  return detail::BindAccessHelper::Create<CallbackType, StateType, false>(
+      std::move(task_runner), std::move(callback), location);
 }
 
 template <typename Return, typename... Arguments>
 RepeatingCallback<Return(Arguments...)> BindPostTask(
-    std::shared_ptr<TaskRunner> task_runner,
+    scoped_refptr<TaskRunner> task_runner,
     RepeatingCallback<Return(Arguments...)> callback,
     SourceLocation location) {
   static_assert(std::is_same_v<Return, void>,
                 "Cannot BindPostTask callback with non-void return type");
 
-  using Helper =
-      detail::BindPostTaskHelper<RepeatingCallback<Return(Arguments...)>,
-                                 Arguments...>;
-  return BindRepeating(
-      &Helper::Run,
-      base::Owned(std::make_unique<Helper>(
-          std::move(task_runner), std::move(callback), std::move(location))));
+  using CallbackType = RepeatingCallback<Return(Arguments...)>;
+  using StateType = detail::BindPostTaskState<CallbackType, Arguments...>;
+  return detail::BindAccessHelper::Create<CallbackType, StateType, true>(
+      std::move(task_runner), std::move(callback), location);
 }
 
 template <typename Return, typename... Arguments>
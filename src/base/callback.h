@@ -1,6 +1,6 @@
 #pragma once
 
-#include <memory>
+#include <utility>
 
 #include "base/bind.h"
 #include "base/callback_iface.h"
@@ -25,8 +25,8 @@ template <typename ReturnType, typename... ArgumentTypes>
 class OnceCallback<ReturnType(ArgumentTypes...)> {
  public:
   OnceCallback() = default;
-  OnceCallback(OnceCallback&& other) = default;
-  OnceCallback& operator=(OnceCallback&&) = default;
+  OnceCallback(OnceCallback&& other) noexcept = default;
+  OnceCallback& operator=(OnceCallback&&) noexcept = default;
 
   OnceCallback(RepeatingCallback<ReturnType(ArgumentTypes...)> callback)
       : OnceCallback(
@@ -34,20 +34,50 @@ class OnceCallback<ReturnType(ArgumentTypes...)> {
 
   explicit operator bool() const { return !!impl_; }
 
+  // Returns true if the callback is known to be a no-op, e.g. it invokes a
+  // method bound to an already invalidated `WeakPtr`. Must be called on the
+  // sequence the callback is bound to.
+  bool IsCancelled() const { return impl_.IsCancelled(); }
+
+  // Returns false if the callback is known to be cancelled. Unlike
+  // `IsCancelled()`, it may be called from any sequence, but it may return
+  // true for a callback that is already cancelled (e.g. when its `WeakPtr` is
+  // being invalidated concurrently).
+  bool MaybeValid() const { return impl_.MaybeValid(); }
+
   ReturnType Run(ArgumentTypes... arguments) && {
     OnceCallback callback = std::move(*this);
-    return callback.impl_->Run(std::forward<ArgumentTypes>(arguments)...);
+    return callback.impl_.RunOnce(std::forward<ArgumentTypes>(arguments)...);
   }
 
   template <typename ThenReturn, typename... ThenArguments>
   OnceCallback<ThenReturn(ArgumentTypes...)> Then(
       OnceCallback<ThenReturn(ThenArguments...)> then) && {
-    return BindOnce(
-        &detail::ThenHelper<ReturnType,
-                            OnceCallback<ReturnType(ArgumentTypes...)>,
-                            OnceCallback<ThenReturn(ThenArguments...)>,
-                            ArgumentTypes...>::Invoke,
-        std::move(*this), std::move(then));
+    if constexpr (detail::kIsThenChainable<ReturnType> &&
+                  detail::kIsThenChainable<ThenReturn>) {
+      using ChainType = detail::ThenChain<ArgumentTypes...>;
+      using ResultType = OnceCallback<ThenReturn(ArgumentTypes...)>;
+      using ResultStateType =
+          detail::ThenChainState<ThenReturn, ArgumentTypes...>;
+
+      OnceCallback callback = std::move(*this);
+      auto* state = detail::BindAccessHelper::GetStateIf<
+          detail::ThenChainState<ReturnType, ArgumentTypes...>, false>(
+          callback);
+
+      ChainType* chain = state ? state->TakeChain()
+                               : ChainType::Create(std::move(callback));
+      chain = ChainType::template Append<ReturnType>(chain, std::move(then));
+      return detail::BindAccessHelper::Create<ResultType, ResultStateType,
+                                              false>(chain);
+    } else {
+      return BindOnce(
+          &detail::ThenHelper<ReturnType,
+                              OnceCallback<ReturnType(ArgumentTypes...)>,
+                              OnceCallback<ThenReturn(ThenArguments...)>,
+                              ArgumentTypes...>::Invoke,
+          std::move(*this), std::move(then));
+    }
   }
 
   template <typename ThenReturn, typename... ThenArguments>
@@ -61,13 +91,11 @@ class OnceCallback<ReturnType(ArgumentTypes...)> {
  private:
   friend class detail::BindAccessHelper;
 
-  explicit OnceCallback(
-      std::unique_ptr<
-          detail::OnceCallbackInterface<ReturnType, ArgumentTypes...>> impl)
-      : impl_(std::move(impl)) {}
+  using ImplType = detail::CallbackImpl<ReturnType, ArgumentTypes...>;
+
+  explicit OnceCallback(ImplType impl) : impl_(std::move(impl)) {}
 
-  std::unique_ptr<detail::OnceCallbackInterface<ReturnType, ArgumentTypes...>>
-      impl_;
+  ImplType impl_;
 };
 
 //
@@ -83,26 +111,24 @@ template <typename ReturnType, typename... ArgumentTypes>
 class RepeatingCallback<ReturnType(ArgumentTypes...)> {
  public:
   RepeatingCallback() = default;
-  RepeatingCallback(RepeatingCallback&&) = default;
-  RepeatingCallback& operator=(RepeatingCallback&&) = default;
-
-  RepeatingCallback(const RepeatingCallback& other)
-      : impl_(CloneImpl(other.impl_)) {}
-
-  RepeatingCallback& operator=(const RepeatingCallback& other) {
-    impl_ = CloneImpl(other.impl_);
-    return *this;
-  }
+  RepeatingCallback(RepeatingCallback&&) noexcept = default;
+  RepeatingCallback& operator=(RepeatingCallback&&) noexcept = default;
+  RepeatingCallback(const RepeatingCallback&) = default;
+  RepeatingCallback& operator=(const RepeatingCallback&) = default;
 
   explicit operator bool() const { return !!impl_; }
 
+  // See `OnceCallback::IsCancelled()` and `OnceCallback::MaybeValid()`.
+  bool IsCancelled() const { return impl_.IsCancelled(); }
+  bool MaybeValid() const { return impl_.MaybeValid(); }
+
   ReturnType Run(ArgumentTypes... arguments) const& {
-    return impl_->Run(std::forward<ArgumentTypes>(arguments)...);
+    return impl_.Run(std::forward<ArgumentTypes>(arguments)...);
   }
 
   ReturnType Run(ArgumentTypes... arguments) && {
     RepeatingCallback callback = std::move(*this);
-    return callback.Run(std::forward<ArgumentTypes>(arguments)...);
+    return callback.impl_.RunOnce(std::forward<ArgumentTypes>(arguments)...);
   }
 
   template <typename ThenReturn, typename... ThenArguments>
@@ -140,23 +166,11 @@ class RepeatingCallback<ReturnType(ArgumentTypes...)> {
  private:
   friend class detail::BindAccessHelper;
 
-  explicit RepeatingCallback(
-      std::unique_ptr<
-          detail::RepeatingCallbackInterface<ReturnType, ArgumentTypes...>>
-          impl)
-      : impl_(std::move(impl)) {}
+  using ImplType = detail::CallbackImpl<ReturnType, ArgumentTypes...>;
 
-  using ImplPtr = std::unique_ptr<
-      detail::RepeatingCallbackInterface<ReturnType, ArgumentTypes...>>;
-
-  static ImplPtr CloneImpl(const ImplPtr& impl) {
-    if (impl) {
-      return impl->Clone();
-    }
-    return {};
-  }
+  explicit RepeatingCallback(ImplType impl) : impl_(std::move(impl)) {}
 
-  ImplPtr impl_;
+  ImplType impl_;
 };
 
 //
@@ -1,27 +1,441 @@
 #pragma once
 
-#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base/memory/pool_allocator.h"
 
 namespace base {
 namespace detail {
 
-template <typename ReturnType, typename... ArgumentTypes>
-class OnceCallbackInterface {
+template <typename T>
+struct IsTriviallyRelocatable
+    : std::bool_constant<std::is_trivially_move_constructible_v<T> &&
+                         std::is_trivially_destructible_v<T>> {};
+
+//
+// Type-erased storage of a callback's state (functor with bound arguments).
+//
+// States that are small enough and can be moved without throwing are kept
+// inline, so binding e.g. a function pointer with a few arguments does not
+// allocate. Bigger states are allocated on the heap and only the pointer to
+// them is stored.
+//
+
+class CallbackStorage {
  public:
-  OnceCallbackInterface() = default;
-  OnceCallbackInterface(const OnceCallbackInterface&) = default;
-  virtual ~OnceCallbackInterface() = default;
+  static constexpr size_t kInlineSize = 48;
+
+  template <typename StateType>
+  static constexpr bool kIsStoredInline =
+      sizeof(StateType) <= kInlineSize &&
+      alignof(StateType) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<StateType>;
+
+  // States that can be moved around by copying the storage's bytes: either
+  // heap-allocated ones or trivially relocatable ones stored inline.
+  template <typename StateType>
+  static constexpr bool kIsBitwiseRelocatable =
+      !kIsStoredInline<StateType> || IsTriviallyRelocatable<StateType>::value;
+
+  CallbackStorage() = default;
+  CallbackStorage(const CallbackStorage&) = delete;
+  CallbackStorage& operator=(const CallbackStorage&) = delete;
+
+  template <typename StateType>
+  StateType* Get() {
+    if constexpr (kIsStoredInline<StateType>) {
+      return std::launder(reinterpret_cast<StateType*>(inline_));
+    } else {
+      return static_cast<StateType*>(heap_);
+    }
+  }
+
+  template <typename StateType>
+  const StateType* Get() const {
+    return const_cast<CallbackStorage*>(this)->Get<StateType>();
+  }
+
+  template <typename StateType, typename... Arguments>
+  void Emplace(Arguments&&... arguments) {
+    if constexpr (kIsStoredInline<StateType>) {
+      new (inline_) StateType(std::forward<Arguments>(arguments)...);
+    } else {
+      heap_ = New<StateType>(std::forward<Arguments>(arguments)...);
+    }
+  }
+
+  template <typename StateType>
+  void Destroy() noexcept {
+    if constexpr (kIsStoredInline<StateType>) {
+      Get<StateType>()->~StateType();
+    } else {
+      Delete(Get<StateType>());
+    }
+  }
+
+  // Heap-allocated states are pooled, as they are often freed on a different
+  // thread than the one that allocated them.
+  template <typename T, typename... Arguments>
+  static T* New(Arguments&&... arguments) {
+    if constexpr (alignof(T) <= alignof(std::max_align_t)) {
+      return new (PoolAllocator::Allocate(sizeof(T)))
+          T(std::forward<Arguments>(arguments)...);
+    } else {
+      return new T(std::forward<Arguments>(arguments)...);
+    }
+  }
+
+  template <typename T>
+  static void Delete(T* ptr) noexcept {
+    if constexpr (alignof(T) <= alignof(std::max_align_t)) {
+      ptr->~T();
+      PoolAllocator::Free(ptr, sizeof(T));
+    } else {
+      delete ptr;
+    }
+  }
+
+  // Moves the state from |from| to |to|, leaving |from| empty.
+  template <typename StateType>
+  static void Relocate(CallbackStorage& from, CallbackStorage& to) noexcept {
+    to.Emplace<StateType>(std::move(*from.Get<StateType>()));
+    from.Destroy<StateType>();
+  }
+
+  static void RelocateBitwise(CallbackStorage& from,
+                              CallbackStorage& to) noexcept {
+    std::memcpy(to.inline_, from.inline_, kInlineSize);
+  }
+
+ private:
+  union {
+    void* heap_;
+    alignas(std::max_align_t) unsigned char inline_[kInlineSize];
+  };
+};
+
+//
+// Handle to a repeating callback's state shared by all copies of that
+// callback. The state is immutable (it's run through const reference) unless
+// the handle is its sole owner, so copying a callback is O(1) regardless of
+// what has been bound to it.
+//
+
+template <typename StateType>
+class SharedCallbackState {
+ public:
+  template <typename... Arguments>
+  explicit SharedCallbackState(Arguments&&... arguments)
+      : data_(CallbackStorage::New<Data>(
+            std::forward<Arguments>(arguments)...)) {}
+
+  SharedCallbackState(const SharedCallbackState& other) : data_(other.data_) {
+    data_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  SharedCallbackState(SharedCallbackState&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)) {}
+
+  SharedCallbackState& operator=(const SharedCallbackState&) = delete;
+  SharedCallbackState& operator=(SharedCallbackState&&) = delete;
+
+  ~SharedCallbackState() {
+    if (data_ &&
+        data_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      CallbackStorage::Delete(data_);
+    }
+  }
+
+  bool HasOneRef() const {
+    return data_->ref_count.load(std::memory_order_acquire) == 1;
+  }
+
+  const StateType& Get() const { return data_->state; }
+
+  // Must only be used by the sole owner of the state.
+  StateType& GetMutable() { return data_->state; }
+
+ private:
+  struct Data {
+    template <typename... Arguments>
+    explicit Data(Arguments&&... arguments)
+        : state(std::forward<Arguments>(arguments)...) {}
+
+    std::atomic<size_t> ref_count{1};
+    StateType state;
+  };
+
+  Data* data_;
+};
+
+template <typename StateType>
+struct IsTriviallyRelocatable<SharedCallbackState<StateType>>
+    : std::true_type {};
+
+//
+// Cancellation of callbacks' states (e.g. methods bound to a `WeakPtr`).
+//
+
+enum class CancellationQueryMode {
+  // Precise answer, must be queried on the sequence the callback is bound to.
+  kIsCancelled,
+  // May be queried from any sequence, but may report a cancelled callback as
+  // still valid.
+  kMaybeValid,
+};
 
-  virtual ReturnType Run(ArgumentTypes...) = 0;
+// States that can be cancelled declare `static constexpr bool kIsCancellable`
+// and implement `bool QueryCancellation(CancellationQueryMode mode) const`,
+// which returns whether the state is cancelled or may still be valid,
+// depending on |mode|.
+template <typename StateType, typename = void>
+struct IsCancellableState : std::false_type {};
+
+template <typename StateType>
+struct IsCancellableState<StateType,
+                          std::void_t<decltype(StateType::kIsCancellable)>>
+    : std::bool_constant<StateType::kIsCancellable> {};
+
+//
+// Static operations table of a callback's state. It is used instead of a
+// virtual interface, so that the state does not need a vtable pointer and
+// can be stored inline.
+//
+
+template <typename ReturnType, typename... ArgumentTypes>
+struct CallbackOps {
+  // Runs the state without modifying it. Only set for repeating callbacks.
+  ReturnType (*run)(const CallbackStorage& storage, ArgumentTypes... arguments);
+  // Runs the state by a callback that is about to be destroyed, so the bound
+  // arguments may be moved out of the state (if it is not shared).
+  ReturnType (*run_once)(CallbackStorage& storage, ArgumentTypes... arguments);
+  // Not set for bitwise relocatable states.
+  void (*relocate)(CallbackStorage& from, CallbackStorage& to) noexcept;
+  // Only set for repeating callbacks.
+  void (*copy)(const CallbackStorage& from, CallbackStorage& to);
+  void (*destroy)(CallbackStorage& storage) noexcept;
+  // Not set for states that can never be cancelled.
+  bool (*query_cancellation)(const CallbackStorage& storage,
+                             CancellationQueryMode mode);
+};
+
+// Repeating callbacks' states that are cheap to copy are stored directly, all
+// others are shared between copies of the callback.
+template <typename StateType, bool is_repeating>
+inline constexpr bool kIsStateShared =
+    is_repeating && !(CallbackStorage::kIsStoredInline<StateType> &&
+                      std::is_trivially_copy_constructible_v<StateType> &&
+                      std::is_trivially_destructible_v<StateType>);
+
+template <typename StateType,
+          bool is_repeating,
+          typename ReturnType,
+          typename... ArgumentTypes>
+struct CallbackOpsFor {
+  using StoredType = std::conditional_t<kIsStateShared<StateType, is_repeating>,
+                                        SharedCallbackState<StateType>,
+                                        StateType>;
+
+  static ReturnType Run(const CallbackStorage& storage,
+                        ArgumentTypes... arguments) {
+    if constexpr (kIsStateShared<StateType, is_repeating>) {
+      return storage.Get<StoredType>()->Get().Run(
+          std::forward<ArgumentTypes>(arguments)...);
+    } else {
+      return storage.Get<StoredType>()->Run(
+          std::forward<ArgumentTypes>(arguments)...);
+    }
+  }
+
+  static ReturnType RunOnce(CallbackStorage& storage,
+                            ArgumentTypes... arguments) {
+    if constexpr (kIsStateShared<StateType, is_repeating>) {
+      StoredType& shared_state = *storage.Get<StoredType>();
+      if (!shared_state.HasOneRef()) {
+        return shared_state.Get().Run(
+            std::forward<ArgumentTypes>(arguments)...);
+      }
+      return shared_state.GetMutable().RunOnce(
+          std::forward<ArgumentTypes>(arguments)...);
+    } else {
+      return storage.Get<StoredType>()->RunOnce(
+          std::forward<ArgumentTypes>(arguments)...);
+    }
+  }
+
+  static void Copy(const CallbackStorage& from, CallbackStorage& to) {
+    to.Emplace<StoredType>(*from.Get<StoredType>());
+  }
+
+  static void Destroy(CallbackStorage& storage) noexcept {
+    storage.Destroy<StoredType>();
+  }
+
+  static bool QueryCancellation(const CallbackStorage& storage,
+                                CancellationQueryMode mode) {
+    if constexpr (kIsStateShared<StateType, is_repeating>) {
+      return storage.Get<StoredType>()->Get().QueryCancellation(mode);
+    } else {
+      return storage.Get<StoredType>()->QueryCancellation(mode);
+    }
+  }
+
+  static constexpr auto GetRun() {
+    if constexpr (is_repeating) {
+      return &Run;
+    } else {
+      return nullptr;
+    }
+  }
+
+  static constexpr auto GetRelocate() {
+    if constexpr (CallbackStorage::kIsBitwiseRelocatable<StoredType>) {
+      return nullptr;
+    } else {
+      return &CallbackStorage::Relocate<StoredType>;
+    }
+  }
+
+  static constexpr auto GetCopy() {
+    if constexpr (is_repeating) {
+      return &Copy;
+    } else {
+      return nullptr;
+    }
+  }
+
+  static constexpr auto GetQueryCancellation() {
+    if constexpr (IsCancellableState<StateType>::value) {
+      return &QueryCancellation;
+    } else {
+      return nullptr;
+    }
+  }
+
+  static constexpr CallbackOps<ReturnType, ArgumentTypes...> kOps = {
+      GetRun(), &RunOnce, GetRelocate(), GetCopy(), &Destroy,
+      GetQueryCancellation()};
 };
 
+//
+// Callback implementation shared by `OnceCallback` and `RepeatingCallback`.
+//
+
 template <typename ReturnType, typename... ArgumentTypes>
-class RepeatingCallbackInterface
-    : public OnceCallbackInterface<ReturnType, ArgumentTypes...> {
+class CallbackImpl {
  public:
-  virtual std::unique_ptr<
-      RepeatingCallbackInterface<ReturnType, ArgumentTypes...>>
-  Clone() const = 0;
+  template <typename StateType, bool is_repeating, typename... Arguments>
+  static CallbackImpl Create(Arguments&&... arguments) {
+    using OpsFor =
+        CallbackOpsFor<StateType, is_repeating, ReturnType, ArgumentTypes...>;
+
+    CallbackImpl impl;
+    impl.storage_.template Emplace<typename OpsFor::StoredType>(
+        std::forward<Arguments>(arguments)...);
+    impl.ops_ = &OpsFor::kOps;
+    return impl;
+  }
+
+  CallbackImpl() = default;
+
+  CallbackImpl(CallbackImpl&& other) noexcept { MoveFrom(other); }
+
+  CallbackImpl& operator=(CallbackImpl&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  CallbackImpl(const CallbackImpl& other) : ops_(other.ops_) {
+    if (ops_) {
+      ops_->copy(other.storage_, storage_);
+    }
+  }
+
+  CallbackImpl& operator=(const CallbackImpl& other) {
+    if (this != &other) {
+      CallbackImpl copy{other};
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  ~CallbackImpl() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  // Returns the state if it was created with the same parameters, or nullptr
+  // otherwise.
+  template <typename StateType, bool is_repeating>
+  StateType* GetStateIf() {
+    using OpsFor =
+        CallbackOpsFor<StateType, is_repeating, ReturnType, ArgumentTypes...>;
+    static_assert(
+        std::is_same_v<typename OpsFor::StoredType, StateType>,
+        "Only states that are stored directly can be accessed");
+
+    if (ops_ != &OpsFor::kOps) {
+      return nullptr;
+    }
+    return storage_.template Get<StateType>();
+  }
+
+  // Null callbacks are reported as cancelled, as there is nothing to run.
+  bool IsCancelled() const {
+    if (!ops_) {
+      return true;
+    }
+    return ops_->query_cancellation &&
+           ops_->query_cancellation(storage_,
+                                    CancellationQueryMode::kIsCancelled);
+  }
+
+  bool MaybeValid() const {
+    if (!ops_) {
+      return false;
+    }
+    return !ops_->query_cancellation ||
+           ops_->query_cancellation(storage_,
+                                    CancellationQueryMode::kMaybeValid);
+  }
+
+  ReturnType Run(ArgumentTypes... arguments) const {
+    return ops_->run(storage_, std::forward<ArgumentTypes>(arguments)...);
+  }
+
+  // Must only be called on an object that will be destroyed right after.
+  ReturnType RunOnce(ArgumentTypes... arguments) {
+    return ops_->run_once(storage_, std::forward<ArgumentTypes>(arguments)...);
+  }
+
+ private:
+  void MoveFrom(CallbackImpl& other) noexcept {
+    if (other.ops_) {
+      if (other.ops_->relocate) {
+        other.ops_->relocate(other.storage_, storage_);
+      } else {
+        CallbackStorage::RelocateBitwise(other.storage_, storage_);
+      }
+      ops_ = std::exchange(other.ops_, nullptr);
+    }
+  }
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  CallbackStorage storage_;
+  const CallbackOps<ReturnType, ArgumentTypes...>* ops_ = nullptr;
 };
 
 }  // namespace detail
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "base/callback_forward.h"
+#include "base/callback_iface.h"
+#include "base/memory/pool_allocator.h"
 #include "base/type_traits.h"
 
 namespace base {
@@ -13,7 +22,7 @@ struct ThenHelper {
   static auto Invoke(FirstCallback first,
                      SecondCallback second,
                      FirstArguments... arguments) {
-    if constexpr (std::is_same_v<FirstReturnType, void>) {
+    if constexpr (std::is_void_v<FirstReturnType>) {
       std::move(first).Run(std::forward<FirstArguments>(arguments)...);
       return std::move(second).Run();
     } else {
@@ -23,5 +32,248 @@ struct ThenHelper {
   }
 };
 
+//
+// Flattened chain of `OnceCallback::Then()` stages.
+//
+// All stages of a chain are kept in a single (pooled) allocation and each
+// stage passes its result directly to the next one. Appending a stage to a
+// callback that already holds a chain moves the chain instead of wrapping it,
+// so `BindOnce(...).Then(...).Then(...)` doesn't nest callbacks. The
+// allocation is sized for the stages it holds and grows geometrically, so the
+// most common two-stage chains (e.g. tasks posted with replies) stay small.
+//
+
+// Intermediate and final results are passed between stages by pointer, so
+// only object types (or nothing) can be chained this way.
+template <typename T>
+inline constexpr bool kIsThenChainable =
+    std::is_void_v<T> || std::is_object_v<T>;
+
+// Stages are stored right after the chain object.
+template <typename... ArgumentTypes>
+class alignas(std::max_align_t) ThenChain {
+ public:
+  ThenChain(const ThenChain&) = delete;
+  ThenChain& operator=(const ThenChain&) = delete;
+
+  template <typename FirstReturnType>
+  static ThenChain* Create(
+      OnceCallback<FirstReturnType(ArgumentTypes...)> first) {
+    ThenChain* chain =
+        Allocate(&RunFirst<FirstReturnType>, kInitialCapacity);
+    chain->EmplaceStage(std::move(first));
+    return chain;
+  }
+
+  static void Destroy(ThenChain* chain) noexcept {
+    for (size_t index = 0; index < chain->size_; ++index) {
+      Stage& stage = chain->GetStage(index);
+      stage.relocate(stage, nullptr);
+      stage.~Stage();
+    }
+    const size_t capacity = chain->capacity_;
+    chain->~ThenChain();
+    PoolAllocator::Free(chain, GetAllocationSize(capacity));
+  }
+
+  // Returns the chain with |next| appended, which is moved to a new allocation
+  // if there was no room for it. |InputType| is the result type of the
+  // current last stage.
+  template <typename InputType, typename ReturnType, typename... ThenArguments>
+  static ThenChain* Append(ThenChain* chain,
+                           OnceCallback<ReturnType(ThenArguments...)> next) {
+    if (chain->size_ == chain->capacity_) {
+      chain = Grow(chain);
+    }
+    chain->EmplaceStage(std::move(next))->run =
+        &RunNext<InputType, ReturnType, ThenArguments...>;
+    return chain;
+  }
+
+  // |ReturnType| must be the result type of the last stage.
+  template <typename ReturnType>
+  ReturnType Run(ArgumentTypes... arguments) {
+    if constexpr (std::is_void_v<ReturnType>) {
+      run_first_(*this, nullptr, std::forward<ArgumentTypes>(arguments)...);
+    } else {
+      std::optional<ReturnType> result;
+      run_first_(*this, &result, std::forward<ArgumentTypes>(arguments)...);
+      return std::move(*result);
+    }
+  }
+
+ private:
+  using RunFirstFunction = void (*)(ThenChain& chain,
+                                    void* result,
+                                    ArgumentTypes... arguments);
+
+  struct Stage {
+    alignas(CallbackImpl<void>) unsigned char callback[sizeof(
+        CallbackImpl<void>)];
+    // Not used for the first stage, as it takes different arguments.
+    void (*run)(ThenChain& chain, size_t index, void* input, void* result);
+    // Moves the callback to |to| (unless it's null) and destroys it.
+    void (*relocate)(Stage& from, Stage* to) noexcept;
+  };
+
+  static_assert(alignof(Stage) <= alignof(std::max_align_t) &&
+                sizeof(ThenChain*) <= alignof(std::max_align_t));
+
+  static constexpr size_t kInitialCapacity = 2;
+
+  ThenChain(RunFirstFunction run_first, size_t capacity)
+      : run_first_(run_first), capacity_(capacity) {}
+  ~ThenChain() = default;
+
+  static constexpr size_t GetAllocationSize(size_t capacity) {
+    return sizeof(ThenChain) + capacity * sizeof(Stage);
+  }
+
+  static ThenChain* Allocate(RunFirstFunction run_first, size_t capacity) {
+    return new (PoolAllocator::Allocate(GetAllocationSize(capacity)))
+        ThenChain(run_first, capacity);
+  }
+
+  static ThenChain* Grow(ThenChain* chain) {
+    ThenChain* grown = Allocate(chain->run_first_, 2 * chain->capacity_);
+    for (size_t index = 0; index < chain->size_; ++index) {
+      Stage& from = chain->GetStage(index);
+      Stage* to = new (grown->GetStageStorage(index)) Stage;
+      from.relocate(from, to);
+      to->run = from.run;
+      to->relocate = from.relocate;
+      from.~Stage();
+    }
+    grown->size_ = std::exchange(chain->size_, 0);
+    Destroy(chain);
+    return grown;
+  }
+
+  void* GetStageStorage(size_t index) {
+    return reinterpret_cast<unsigned char*>(this + 1) + index * sizeof(Stage);
+  }
+
+  Stage& GetStage(size_t index) {
+    return *std::launder(static_cast<Stage*>(GetStageStorage(index)));
+  }
+
+  template <typename CallbackType>
+  static CallbackType& GetCallback(Stage& stage) {
+    return *std::launder(reinterpret_cast<CallbackType*>(stage.callback));
+  }
+
+  template <typename CallbackType>
+  static void RelocateCallback(Stage& from, Stage* to) noexcept {
+    CallbackType& callback = GetCallback<CallbackType>(from);
+    if (to) {
+      new (to->callback) CallbackType(std::move(callback));
+    }
+    callback.~CallbackType();
+  }
+
+  template <typename CallbackType>
+  Stage* EmplaceStage(CallbackType callback) {
+    static_assert(sizeof(CallbackType) <= sizeof(Stage::callback) &&
+                  alignof(CallbackType) <= alignof(Stage));
+    Stage* stage = new (GetStageStorage(size_)) Stage;
+    new (stage->callback) CallbackType(std::move(callback));
+    stage->run = nullptr;
+    stage->relocate = &RelocateCallback<CallbackType>;
+    ++size_;
+    return stage;
+  }
+
+  // Passes |value| to the stage at |index| or, if there are no more stages,
+  // stores it as the chain's result.
+  template <typename ValueType>
+  void Forward(size_t index, ValueType* value, void* result) {
+    if (index < size_) {
+      GetStage(index).run(*this, index, value, result);
+    } else if constexpr (!std::is_void_v<ValueType>) {
+      static_cast<std::optional<ValueType>*>(result)->emplace(
+          std::move(*value));
+    }
+  }
+
+  template <typename ReturnType,
+            typename... CallbackArguments,
+            typename... RunArguments>
+  void RunAndForward(OnceCallback<ReturnType(CallbackArguments...)>& callback,
+                     size_t next_index,
+                     void* result,
+                     RunArguments&&... arguments) {
+    if constexpr (std::is_void_v<ReturnType>) {
+      std::move(callback).Run(std::forward<RunArguments>(arguments)...);
+      Forward<void>(next_index, nullptr, result);
+    } else {
+      ReturnType value =
+          std::move(callback).Run(std::forward<RunArguments>(arguments)...);
+      Forward(next_index, &value, result);
+    }
+  }
+
+  template <typename ReturnType>
+  static void RunFirst(ThenChain& chain,
+                       void* result,
+                       ArgumentTypes... arguments) {
+    using CallbackType = OnceCallback<ReturnType(ArgumentTypes...)>;
+    chain.RunAndForward(GetCallback<CallbackType>(chain.GetStage(0)), 1,
+                        result, std::forward<ArgumentTypes>(arguments)...);
+  }
+
+  template <typename InputType, typename ReturnType, typename... ThenArguments>
+  static void RunNext(ThenChain& chain,
+                      size_t index,
+                      void* input,
+                      void* result) {
+    using CallbackType = OnceCallback<ReturnType(ThenArguments...)>;
+    auto& callback = GetCallback<CallbackType>(chain.GetStage(index));
+    if constexpr (std::is_void_v<InputType>) {
+      chain.RunAndForward(callback, index + 1, result);
+    } else {
+      chain.RunAndForward(callback, index + 1, result,
+                          std::move(*static_cast<InputType*>(input)));
+    }
+  }
+
+  RunFirstFunction run_first_;
+  size_t size_ = 0;
+  size_t capacity_;
+};
+
+// Callback state owning a chain whose last stage returns |ReturnType|.
+template <typename ReturnType, typename... ArgumentTypes>
+class ThenChainState {
+ public:
+  using ChainType = ThenChain<ArgumentTypes...>;
+
+  explicit ThenChainState(ChainType* chain) : chain_(chain) {}
+
+  ThenChainState(ThenChainState&& other) noexcept
+      : chain_(std::exchange(other.chain_, nullptr)) {}
+
+  ThenChainState& operator=(ThenChainState&&) = delete;
+
+  ~ThenChainState() {
+    if (chain_) {
+      ChainType::Destroy(chain_);
+    }
+  }
+
+  ChainType* TakeChain() { return std::exchange(chain_, nullptr); }
+
+  ReturnType RunOnce(ArgumentTypes... arguments) {
+    return chain_->template Run<ReturnType>(
+        std::forward<ArgumentTypes>(arguments)...);
+  }
+
+ private:
+  ChainType* chain_;
+};
+
+template <typename ReturnType, typename... ArgumentTypes>
+struct IsTriviallyRelocatable<ThenChainState<ReturnType, ArgumentTypes...>>
+    : std::true_type {};
+
 }  // namespace detail
 }  // namespace base
@@ -0,0 +1,37 @@
+#include "base/callback_list.h"
+
+namespace base {
+
+CallbackListSubscription::CallbackListSubscription() = default;
+
+CallbackListSubscription::CallbackListSubscription(OnceClosure remove_closure)
+    : remove_closure_(std::move(remove_closure)) {}
+
+CallbackListSubscription::CallbackListSubscription(
+    CallbackListSubscription&& other)
+    : remove_closure_(std::move(other.remove_closure_)) {}
+
+CallbackListSubscription::~CallbackListSubscription() {
+  Run();
+}
+
+CallbackListSubscription& CallbackListSubscription::operator=(
+    CallbackListSubscription&& other) {
+  if (this != &other) {
+    Run();
+    remove_closure_ = std::move(other.remove_closure_);
+  }
+  return *this;
+}
+
+CallbackListSubscription::operator bool() const {
+  return !!remove_closure_;
+}
+
+void CallbackListSubscription::Run() {
+  if (remove_closure_) {
+    std::move(remove_closure_).Run();
+  }
+}
+
+}  // namespace base
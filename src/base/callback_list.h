@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <utility>
+
+#include "base/auto_reset.h"
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/logging.h"
+#include "base/memory/pool_allocator.h"
+
+namespace base {
+
+template <typename Signature>
+class OnceCallbackList;
+template <typename Signature>
+class RepeatingCallbackList;
+
+namespace detail {
+template <typename CallbackListImpl>
+class CallbackListBase;
+}  // namespace detail
+
+// Handle of a callback added to a `{Once,Repeating}CallbackList`. Destroying
+// it removes the callback from the list (if the list still exists).
+class CallbackListSubscription {
+ public:
+  CallbackListSubscription();
+  CallbackListSubscription(CallbackListSubscription&& other);
+  ~CallbackListSubscription();
+
+  CallbackListSubscription& operator=(CallbackListSubscription&& other);
+
+  explicit operator bool() const;
+
+ private:
+  template <typename CallbackListImpl>
+  friend class detail::CallbackListBase;
+
+  explicit CallbackListSubscription(OnceClosure remove_closure);
+
+  void Run();
+
+  OnceClosure remove_closure_;
+};
+
+namespace detail {
+
+template <typename CallbackListImpl>
+struct CallbackListTraits;
+
+template <typename Signature>
+struct CallbackListTraits<OnceCallbackList<Signature>> {
+  using CallbackType = OnceCallback<Signature>;
+};
+
+template <typename Signature>
+struct CallbackListTraits<RepeatingCallbackList<Signature>> {
+  using CallbackType = RepeatingCallback<Signature>;
+};
+
+// List of callbacks which can be notified all at once. Callbacks are stored
+// in list nodes (allocated from the `PoolAllocator`), so subscribing and
+// unsubscribing are O(1) and callbacks are never copied or moved around.
+//
+// Callbacks may be added and removed (also by themselves) while the list is
+// being notified. Removed and run `OnceCallback`s are only marked as such and
+// the list is compacted after the outermost `Notify()` returns. Callbacks
+// added during notification will be run by it as well.
+//
+// Not thread-safe - the list and all its subscriptions must be used on a
+// single sequence.
+template <typename CallbackListImpl>
+class CallbackListBase {
+ public:
+  using CallbackType =
+      typename CallbackListTraits<CallbackListImpl>::CallbackType;
+
+  CallbackListBase() = default;
+  CallbackListBase(const CallbackListBase&) = delete;
+  CallbackListBase& operator=(const CallbackListBase&) = delete;
+
+  ~CallbackListBase() {
+    // Destroying the list from one of its callbacks is not supported.
+    DCHECK(!iterating_);
+  }
+
+  CallbackListSubscription Add(CallbackType callback) {
+    DCHECK(callback);
+    callbacks_.push_back(Entry{std::move(callback), EntryState::kActive});
+    return CallbackListSubscription{
+        BindOnce(&CallbackListBase::CancelCallbackIfAlive,
+                 std::weak_ptr<CallbackListBase*>{self_},
+                 std::prev(callbacks_.end()))};
+  }
+
+  // Returns true if there are no callbacks that would be run by `Notify()`.
+  bool empty() const {
+    return callbacks_.size() == inactive_callbacks_count_;
+  }
+
+  template <typename... RunArguments>
+  void Notify(RunArguments&&... arguments) {
+    {
+      AutoReset<bool> iterating{&iterating_, true};
+
+      // No entry is erased from `callbacks_` while iterating (new ones are
+      // only appended), so the iterator stays valid.
+      for (auto it = callbacks_.begin(); it != callbacks_.end(); ++it) {
+        if (it->state == EntryState::kActive) {
+          // Arguments are not forwarded, as they are passed to many callbacks.
+          static_cast<CallbackListImpl*>(this)->RunCallback(*it, arguments...);
+        }
+      }
+    }
+
+    if (!iterating_ && inactive_callbacks_count_ > 0) {
+      Compact();
+    }
+  }
+
+ protected:
+  enum class EntryState {
+    kActive,
+    // Entry of a `OnceCallback` that was already run, stored in `callbacks_`
+    // until the list is compacted.
+    kRan,
+    // Entry of a `OnceCallback` that was already run, stored in
+    // `spent_callbacks_` until its subscription is destroyed.
+    kSpent,
+    // Removed during notification, waiting for the list's compaction.
+    kRemoved,
+  };
+
+  struct Entry {
+    CallbackType callback;
+    EntryState state;
+  };
+
+  void MarkAsRan(Entry& entry) {
+    DCHECK(entry.state == EntryState::kActive);
+    entry.state = EntryState::kRan;
+    ++inactive_callbacks_count_;
+  }
+
+ private:
+  using Entries = std::list<Entry, PoolStlAllocator<Entry>>;
+
+  static void CancelCallbackIfAlive(
+      const std::weak_ptr<CallbackListBase*>& weak_self,
+      typename Entries::iterator it) {
+    if (auto self = weak_self.lock()) {
+      (*self)->CancelCallback(it);
+    }
+  }
+
+  void CancelCallback(typename Entries::iterator it) {
+    DCHECK(it->state != EntryState::kRemoved);
+
+    if (it->state == EntryState::kSpent) {
+      spent_callbacks_.erase(it);
+    } else if (iterating_) {
+      // The callback may be running right now, so it must not be destroyed
+      // until the notification is done.
+      if (it->state == EntryState::kActive) {
+        ++inactive_callbacks_count_;
+      }
+      it->state = EntryState::kRemoved;
+    } else {
+      // Ran entries are moved to `spent_callbacks_` once notification is done.
+      DCHECK(it->state == EntryState::kActive);
+      callbacks_.erase(it);
+    }
+  }
+
+  void Compact() {
+    for (auto it = callbacks_.begin(); it != callbacks_.end();) {
+      auto current = it++;
+      if (current->state == EntryState::kRemoved) {
+        callbacks_.erase(current);
+      } else if (current->state == EntryState::kRan) {
+        // Keep the entry alive, as its subscription still refers to it.
+        current->state = EntryState::kSpent;
+        spent_callbacks_.splice(spent_callbacks_.end(), callbacks_, current);
+      }
+    }
+    inactive_callbacks_count_ = 0;
+  }
+
+  Entries callbacks_;
+  Entries spent_callbacks_;
+  bool iterating_ = false;
+  // Number of `callbacks_` entries that are either ran or removed.
+  size_t inactive_callbacks_count_ = 0;
+  // Expires along with the list, so outstanding subscriptions become no-ops.
+  // `WeakPtr<>` is not used, so lists can be used also outside of sequences.
+  const std::shared_ptr<CallbackListBase*> self_ =
+      std::make_shared<CallbackListBase*>(this);
+};
+
+}  // namespace detail
+
+// List of `OnceCallback`s. Each callback is run at most once - by the first
+// `Notify()` that follows its addition - and then dropped from the list.
+template <typename Signature>
+class OnceCallbackList
+    : public detail::CallbackListBase<OnceCallbackList<Signature>> {
+ private:
+  using Base = detail::CallbackListBase<OnceCallbackList<Signature>>;
+  friend Base;
+
+  template <typename... RunArguments>
+  void RunCallback(typename Base::Entry& entry, RunArguments&&... arguments) {
+    this->MarkAsRan(entry);
+    std::move(entry.callback).Run(std::forward<RunArguments>(arguments)...);
+  }
+};
+
+// List of `RepeatingCallback`s which are run on every `Notify()` until their
+// subscriptions are destroyed.
+template <typename Signature>
+class RepeatingCallbackList
+    : public detail::CallbackListBase<RepeatingCallbackList<Signature>> {
+ private:
+  using Base = detail::CallbackListBase<RepeatingCallbackList<Signature>>;
+  friend Base;
+
+  template <typename... RunArguments>
+  void RunCallback(typename Base::Entry& entry, RunArguments&&... arguments) {
+    entry.callback.Run(std::forward<RunArguments>(arguments)...);
+  }
+};
+
+using OnceClosureList = OnceCallbackList<void()>;
+using RepeatingClosureList = RepeatingCallbackList<void()>;
+
+}  // namespace base
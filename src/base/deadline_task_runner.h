@@ -0,0 +1,26 @@
+#pragma once
+
+#include "base/callback.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_ticks.h"
+
+namespace base {
+
+// Sequenced task runner that additionally allows posting tasks with an
+// absolute deadline. Pending tasks with a deadline are executed in
+// earliest-deadline-first order across all task runners that share the same
+// executors (e.g. the same thread pool), but tasks from a single sequence are
+// still executed in the order they were posted. Tasks without a deadline
+// (including ones posted with a deadline task runner's `PostTask()`) are
+// executed only when no task with a deadline can be executed instead.
+class DeadlineTaskRunner : public SequencedTaskRunner {
+ public:
+  // Deadline is only used to order tasks - tasks are executed even if their
+  // deadline has already passed.
+  virtual bool PostTaskWithDeadline(SourceLocation location,
+                                    OnceClosure task,
+                                    TimeTicks deadline) = 0;
+};
+
+}  // namespace base
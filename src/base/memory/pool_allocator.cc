@@ -0,0 +1,456 @@
+#include "base/memory/pool_allocator.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#include "base/logging.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kSlabSize = 64 * 1024;
+
+// Block sizes grow by |kMinBlockSize| up to 128 bytes and by a quarter of the
+// previous power of two above it, so that rounding a request up to its size
+// class wastes at most ~20% of the block.
+constexpr size_t kBlockSizes[] = {16,  32,  48,  64,  80,  96,  112,
+                                  128, 160, 192, 224, 256, 320, 384,
+                                  448, 512, 640, 768, 896, 1024};
+constexpr size_t kSizeClassesCount = std::size(kBlockSizes);
+
+// Every this many allocations, a thread cache drains remote frees (even if it
+// doesn't run out of blocks) and returns slabs that stayed empty for at least
+// |kEmptySlabReleaseDelay| to the system.
+constexpr uint32_t kMaintenanceInterval = 256;
+constexpr std::chrono::steady_clock::duration kEmptySlabReleaseDelay =
+    std::chrono::seconds(1);
+
+static_assert(kBlockSizes[0] == PoolAllocator::kMinBlockSize,
+              "Smallest size class must match the minimal block size");
+static_assert(kBlockSizes[kSizeClassesCount - 1] ==
+                  PoolAllocator::kMaxPooledSize,
+              "Size classes must cover all pooled sizes");
+static_assert(PoolAllocator::kMinBlockSize >= alignof(std::max_align_t),
+              "Blocks must be suitably aligned for any object");
+
+// Maps sizes, rounded up to a multiple of |kMinBlockSize|, to size classes.
+constexpr auto kSizeClassesLookup = []() {
+  std::array<uint8_t, PoolAllocator::kMaxPooledSize /
+                              PoolAllocator::kMinBlockSize +
+                          1>
+      lookup = {};
+  size_t size_class = 0;
+  for (size_t idx = 0; idx < lookup.size(); ++idx) {
+    while (kBlockSizes[size_class] < idx * PoolAllocator::kMinBlockSize) {
+      ++size_class;
+    }
+    lookup[idx] = static_cast<uint8_t>(size_class);
+  }
+  return lookup;
+}();
+
+size_t GetSizeClass(size_t size) {
+  return kSizeClassesLookup[(size + PoolAllocator::kMinBlockSize - 1) /
+                            PoolAllocator::kMinBlockSize];
+}
+
+constexpr size_t GetBlockSize(size_t size_class) {
+  return kBlockSizes[size_class];
+}
+
+void IncrementRelaxed(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+  // Only the owner of the counter modifies it, so there is no need for an
+  // atomic read-modify-write operation.
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+void DecrementRelaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) - value,
+                std::memory_order_relaxed);
+}
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+class ThreadCache;
+
+// Placed at the beginning of each slab, which is aligned to its size, so that
+// it can be found from any block's address. All blocks in a slab are of the
+// same size class. Everything but |owner| and |size_class| is modified only
+// by the owning thread.
+struct Slab {
+  ThreadCache* owner;
+  size_t size_class;
+  // Blocks that were freed back to this slab.
+  FreeBlock* free_list = nullptr;
+  // Blocks that were never handed out.
+  char* unused_begin = nullptr;
+  char* unused_end = nullptr;
+  size_t allocated_blocks = 0;
+  // Approximate time since which the slab is empty.
+  std::chrono::steady_clock::time_point empty_since = {};
+  // Links in the owner's list of slabs that have blocks to hand out.
+  bool is_available = false;
+  Slab* prev = nullptr;
+  Slab* next = nullptr;
+};
+
+Slab* GetSlab(void* ptr) {
+  return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) &
+                                 ~(kSlabSize - 1));
+}
+
+class ThreadCache {
+ public:
+  ThreadCache() : last_maintenance_time_(std::chrono::steady_clock::now()) {}
+
+  void* Allocate(size_t size_class) {
+    MaybeDoMaintenance();
+
+    Slab* slab = available_slabs_[size_class].head;
+    if (!slab) {
+      DrainRemoteFrees();
+      slab = available_slabs_[size_class].head;
+      if (!slab) {
+        slab = CreateSlab(size_class);
+      }
+    }
+
+    void* block;
+    if (FreeBlock* free_block = slab->free_list) {
+      slab->free_list = free_block->next;
+      block = free_block;
+    } else {
+      block = slab->unused_begin;
+      slab->unused_begin += GetBlockSize(size_class);
+    }
+    ++slab->allocated_blocks;
+    if (!slab->free_list && slab->unused_begin == slab->unused_end) {
+      RemoveAvailableSlab(slab);
+    }
+
+    IncrementRelaxed(allocations_);
+    IncrementRelaxed(allocated_bytes_, GetBlockSize(size_class));
+    return block;
+  }
+
+  // Must be called on the thread owning this cache.
+  void FreeLocal(void* ptr) {
+    ReturnBlock(ptr);
+    IncrementRelaxed(frees_);
+  }
+
+  // May be called from any thread.
+  void FreeRemote(void* ptr) {
+    auto* block = static_cast<FreeBlock*>(ptr);
+    FreeBlock* head = remote_frees_.load(std::memory_order_relaxed);
+    do {
+      block->next = head;
+    } while (!remote_frees_.compare_exchange_weak(
+        head, block, std::memory_order_release, std::memory_order_relaxed));
+    remote_frees_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns all empty slabs to the system. Must be called on the thread
+  // owning this cache (or while no thread owns it).
+  void Trim() {
+    DrainRemoteFrees();
+    for (size_t size_class = 0; size_class < kSizeClassesCount; ++size_class) {
+      ReleaseEmptySlabs(size_class,
+                        std::chrono::steady_clock::time_point::max());
+    }
+  }
+
+  void AddStats(PoolAllocator::Stats& stats) const {
+    const uint64_t remote_frees =
+        remote_frees_count_.load(std::memory_order_relaxed);
+    stats.allocations += allocations_.load(std::memory_order_relaxed);
+    stats.allocated_bytes += allocated_bytes_.load(std::memory_order_relaxed);
+    stats.frees += frees_.load(std::memory_order_relaxed) + remote_frees;
+    stats.remote_frees += remote_frees;
+    stats.reserved_bytes += reserved_bytes_.load(std::memory_order_relaxed);
+    stats.thread_caches += 1;
+  }
+
+ private:
+  struct SlabList {
+    Slab* head = nullptr;
+    Slab* tail = nullptr;
+  };
+
+  void MaybeDoMaintenance() {
+    if (++operations_since_maintenance_ < kMaintenanceInterval) {
+      return;
+    }
+    operations_since_maintenance_ = 0;
+    last_maintenance_time_ = std::chrono::steady_clock::now();
+
+    DrainRemoteFrees();
+    for (size_t size_class = 0; size_class < kSizeClassesCount; ++size_class) {
+      ReleaseEmptySlabs(size_class,
+                        last_maintenance_time_ - kEmptySlabReleaseDelay);
+    }
+  }
+
+  void DrainRemoteFrees() {
+    if (!remote_frees_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    FreeBlock* block =
+        remote_frees_.exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+      FreeBlock* next = block->next;
+      ReturnBlock(block);
+      block = next;
+    }
+  }
+
+  void ReturnBlock(void* ptr) {
+    Slab* slab = GetSlab(ptr);
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = slab->free_list;
+    slab->free_list = block;
+
+    DCHECK_GT(slab->allocated_blocks, 0u);
+    if (--slab->allocated_blocks > 0) {
+      if (!slab->is_available) {
+        AddAvailableSlab(slab, /*at_tail=*/false);
+      }
+      return;
+    }
+
+    // Empty slabs are kept at the end of the list, so that partially used
+    // slabs are filled up first and empty ones can be released.
+    RemoveAvailableSlab(slab);
+    AddAvailableSlab(slab, /*at_tail=*/true);
+    slab->empty_since = last_maintenance_time_;
+  }
+
+  Slab* CreateSlab(size_t size_class) {
+    char* memory = static_cast<char*>(
+        ::operator new(kSlabSize, std::align_val_t{kSlabSize}));
+    auto* slab = new (memory) Slab{this, size_class};
+
+    const size_t block_size = GetBlockSize(size_class);
+    const size_t header_size =
+        (sizeof(Slab) + PoolAllocator::kMinBlockSize - 1) /
+        PoolAllocator::kMinBlockSize * PoolAllocator::kMinBlockSize;
+    slab->unused_begin = memory + header_size;
+    slab->unused_end = slab->unused_begin +
+                       (kSlabSize - header_size) / block_size * block_size;
+
+    AddAvailableSlab(slab, /*at_tail=*/true);
+    IncrementRelaxed(reserved_bytes_, kSlabSize);
+    return slab;
+  }
+
+  // Releases empty slabs (which are at the end of the list) that are empty
+  // since before |empty_before|.
+  void ReleaseEmptySlabs(size_t size_class,
+                         std::chrono::steady_clock::time_point empty_before) {
+    Slab* slab = available_slabs_[size_class].tail;
+    while (slab && slab->allocated_blocks == 0) {
+      Slab* prev = slab->prev;
+      if (slab->empty_since < empty_before) {
+        RemoveAvailableSlab(slab);
+        slab->~Slab();
+        ::operator delete(slab, std::align_val_t{kSlabSize});
+        DecrementRelaxed(reserved_bytes_, kSlabSize);
+      }
+      slab = prev;
+    }
+  }
+
+  void AddAvailableSlab(Slab* slab, bool at_tail) {
+    SlabList& list = available_slabs_[slab->size_class];
+    slab->is_available = true;
+    if (at_tail) {
+      slab->prev = list.tail;
+      slab->next = nullptr;
+    } else {
+      slab->prev = nullptr;
+      slab->next = list.head;
+    }
+    (slab->prev ? slab->prev->next : list.head) = slab;
+    (slab->next ? slab->next->prev : list.tail) = slab;
+  }
+
+  void RemoveAvailableSlab(Slab* slab) {
+    if (!slab->is_available) {
+      return;
+    }
+    SlabList& list = available_slabs_[slab->size_class];
+    (slab->prev ? slab->prev->next : list.head) = slab->next;
+    (slab->next ? slab->next->prev : list.tail) = slab->prev;
+    slab->is_available = false;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+  }
+
+  // Slabs which have free or unused blocks. Partially used ones come first
+  // (most recently freed to first), followed by empty ones.
+  std::array<SlabList, kSizeClassesCount> available_slabs_ = {};
+  uint32_t operations_since_maintenance_ = 0;
+  std::chrono::steady_clock::time_point last_maintenance_time_;
+
+  std::atomic<uint64_t> allocations_{0};
+  std::atomic<uint64_t> allocated_bytes_{0};
+  std::atomic<uint64_t> frees_{0};
+  std::atomic<uint64_t> reserved_bytes_{0};
+
+  // Blocks freed by other threads. Separated from the data above, as it is
+  // modified by other threads.
+  alignas(64) std::atomic<FreeBlock*> remote_frees_{nullptr};
+  std::atomic<uint64_t> remote_frees_count_{0};
+};
+
+// Keeps all thread caches. Caches are never destroyed, as other threads may
+// still use blocks allocated from them. Caches of exited threads are reused.
+class ThreadCacheRegistry {
+ public:
+  static ThreadCacheRegistry& GetInstance() {
+    static auto* instance = new ThreadCacheRegistry();
+    return *instance;
+  }
+
+  ThreadCache* Acquire() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    if (!released_caches_.empty()) {
+      ThreadCache* cache = released_caches_.back();
+      released_caches_.pop_back();
+      return cache;
+    }
+    all_caches_.push_back(new ThreadCache());
+    return all_caches_.back();
+  }
+
+  void Release(ThreadCache* cache) {
+    cache->Trim();
+
+    std::lock_guard<std::mutex> guard{mutex_};
+    released_caches_.push_back(cache);
+  }
+
+  // Released caches are not used by any thread, so they can be trimmed while
+  // the lock is held.
+  void TrimReleasedCaches() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    for (ThreadCache* cache : released_caches_) {
+      cache->Trim();
+    }
+  }
+
+  void AddStats(PoolAllocator::Stats& stats) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    for (const ThreadCache* cache : all_caches_) {
+      cache->AddStats(stats);
+    }
+  }
+
+  // Used by threads whose own cache has already been released (e.g. while
+  // destroying other thread-local objects).
+  void* AllocateFromSharedCache(size_t size_class) {
+    std::lock_guard<std::mutex> guard{shared_cache_mutex_};
+    if (!shared_cache_) {
+      shared_cache_ = Acquire();
+    }
+    return shared_cache_->Allocate(size_class);
+  }
+
+ private:
+  ThreadCacheRegistry() = default;
+
+  std::mutex mutex_;
+  std::vector<ThreadCache*> all_caches_;
+  std::vector<ThreadCache*> released_caches_;
+
+  std::mutex shared_cache_mutex_;
+  ThreadCache* shared_cache_ = nullptr;
+};
+
+std::atomic<uint64_t> g_unpooled_allocations{0};
+
+thread_local ThreadCache* g_current_thread_cache = nullptr;
+thread_local bool g_current_thread_cache_released = false;
+
+struct ThreadCacheReleaser {
+  ~ThreadCacheReleaser() {
+    ThreadCacheRegistry::GetInstance().Release(g_current_thread_cache);
+    g_current_thread_cache = nullptr;
+    g_current_thread_cache_released = true;
+  }
+};
+
+ThreadCache* GetCurrentThreadCache() {
+  if (g_current_thread_cache || g_current_thread_cache_released) {
+    return g_current_thread_cache;
+  }
+
+  static thread_local ThreadCacheReleaser releaser;
+  static_cast<void>(releaser);
+  g_current_thread_cache = ThreadCacheRegistry::GetInstance().Acquire();
+  return g_current_thread_cache;
+}
+
+}  // namespace
+
+// static
+void* PoolAllocator::Allocate(size_t size) {
+  if (size > kMaxPooledSize) {
+    g_unpooled_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+
+  const size_t size_class = GetSizeClass(size);
+  if (ThreadCache* cache = GetCurrentThreadCache()) {
+    return cache->Allocate(size_class);
+  }
+  return ThreadCacheRegistry::GetInstance().AllocateFromSharedCache(
+      size_class);
+}
+
+// static
+void PoolAllocator::Free(void* ptr, size_t size) {
+  if (!ptr) {
+    return;
+  }
+  if (size > kMaxPooledSize) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  const Slab* slab = GetSlab(ptr);
+  DCHECK_EQ(slab->size_class, GetSizeClass(size));
+  if (slab->owner == g_current_thread_cache) {
+    slab->owner->FreeLocal(ptr);
+  } else {
+    slab->owner->FreeRemote(ptr);
+  }
+}
+
+// static
+void PoolAllocator::Trim() {
+  if (ThreadCache* cache = GetCurrentThreadCache()) {
+    cache->Trim();
+  }
+  ThreadCacheRegistry::GetInstance().TrimReleasedCaches();
+}
+
+// static
+PoolAllocator::Stats PoolAllocator::GetStats() {
+  Stats stats;
+  ThreadCacheRegistry::GetInstance().AddStats(stats);
+  stats.unpooled_allocations =
+      g_unpooled_allocations.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace base
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace base {
+
+// Thread-caching allocator of small memory blocks, used for short-lived
+// objects that are often allocated on one thread and freed on another (e.g.
+// callbacks' states and posted tasks).
+//
+// Blocks are grouped into size classes (spaced by at most 25%) and carved out
+// of slabs owned by a per-thread cache, so allocations and frees done on the
+// owning thread don't need any synchronization. Blocks freed on other threads
+// are pushed onto a lock-free list of the owning cache, which is drained
+// periodically and whenever the cache runs out of blocks of a size class.
+// Requests bigger than `kMaxPooledSize` are passed to the global
+// `operator new`.
+//
+// Slabs whose blocks were all freed are kept for a while and returned to the
+// system once the owning thread allocates and frees enough blocks without
+// needing them (or on `Trim()`). Caches of exited threads are kept, along with
+// all blocks they own, and are adopted by new threads.
+class PoolAllocator {
+ public:
+  static constexpr size_t kMinBlockSize = 16;
+  static constexpr size_t kMaxPooledSize = 1024;
+
+  struct Stats {
+    // Number of blocks allocated from and returned to the pool.
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    // Total size of blocks allocated from the pool (rounded up to their size
+    // classes).
+    uint64_t allocated_bytes = 0;
+    // Number of blocks returned from a thread other than the owning one.
+    uint64_t remote_frees = 0;
+    // Number of allocations too big to be pooled.
+    uint64_t unpooled_allocations = 0;
+    // Total size of slabs reserved by all thread caches.
+    uint64_t reserved_bytes = 0;
+    // Number of thread caches (live or waiting to be adopted).
+    uint64_t thread_caches = 0;
+  };
+
+  // Returned memory is aligned to at least `alignof(std::max_align_t)`.
+  static void* Allocate(size_t size);
+  // |size| must be the same as the one passed to `Allocate()`.
+  static void Free(void* ptr, size_t size);
+
+  // Returns empty slabs of the current thread's cache and of caches of exited
+  // threads to the system.
+  static void Trim();
+
+  // Statistics summed over all thread caches. Counters of each cache are
+  // updated without synchronization, so the result may be slightly stale.
+  static Stats GetStats();
+};
+
+// Standard allocator adapter for containers whose nodes should be pooled.
+template <typename T>
+class PoolStlAllocator {
+ public:
+  using value_type = T;
+
+  PoolStlAllocator() = default;
+
+  template <typename U>
+  PoolStlAllocator(const PoolStlAllocator<U>& /*other*/) {}
+
+  T* allocate(size_t count) {
+    if (count > kMaxCount) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T*>(PoolAllocator::Allocate(count * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    PoolAllocator::Free(ptr, count * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const PoolStlAllocator<U>& /*other*/) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const PoolStlAllocator<U>& /*other*/) const {
+    return false;
+  }
+
+ private:
+  static constexpr size_t kMaxCount = SIZE_MAX / sizeof(T);
+};
+
+}  // namespace base
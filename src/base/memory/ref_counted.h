@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace base {
+
+// Base class of objects with an intrusive, thread-safe reference counter that
+// are owned by `scoped_refptr<T>`s. The object is deleted (as `T`) when its
+// last reference is released, so `T` has to have a virtual destructor if it's
+// used as a base class of the actual objects.
+//
+// class MyObject : public base::RefCountedThreadSafe<MyObject> { ... };
+// auto object = base::MakeRefCounted<MyObject>(...);
+template <typename T>
+class RefCountedThreadSafe {
+ public:
+  RefCountedThreadSafe(const RefCountedThreadSafe&) = delete;
+  RefCountedThreadSafe& operator=(const RefCountedThreadSafe&) = delete;
+
+  void AddRef() const { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  void Release() const {
+    const size_t previous_ref_count =
+        ref_count_.fetch_sub(1, std::memory_order_acq_rel);
+    DCHECK_GT(previous_ref_count, 0u);
+    if (previous_ref_count == 1) {
+      delete static_cast<const T*>(this);
+    }
+  }
+
+  bool HasOneRef() const {
+    return ref_count_.load(std::memory_order_acquire) == 1;
+  }
+
+ protected:
+  RefCountedThreadSafe() = default;
+  ~RefCountedThreadSafe() = default;
+
+ private:
+  mutable std::atomic_size_t ref_count_{0};
+};
+
+template <typename T, typename... Arguments>
+scoped_refptr<T> MakeRefCounted(Arguments&&... arguments) {
+  return WrapRefCounted(new T(std::forward<Arguments>(arguments)...));
+}
+
+}  // namespace base
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+
+template <typename T>
+class scoped_refptr;
+
+template <typename T>
+scoped_refptr<T> WrapRefCounted(T* ptr);
+
+// Smart pointer to an intrusively ref-counted object (e.g. one deriving from
+// `RefCountedThreadSafe<T>`). Unlike `std::shared_ptr<T>` it's a single
+// pointer and the object is allocated together with its reference counter.
+template <typename T>
+class scoped_refptr {
+ public:
+  using element_type = T;
+
+  constexpr scoped_refptr() = default;
+  constexpr scoped_refptr(std::nullptr_t) {}
+
+  // Takes a new reference to |ptr|.
+  scoped_refptr(T* ptr) : ptr_(ptr) {
+    if (ptr_) {
+      ptr_->AddRef();
+    }
+  }
+
+  scoped_refptr(const scoped_refptr& other) : scoped_refptr(other.ptr_) {}
+
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  scoped_refptr(const scoped_refptr<U>& other) : scoped_refptr(other.get()) {}
+
+  scoped_refptr(scoped_refptr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  scoped_refptr(scoped_refptr<U>&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+  ~scoped_refptr() {
+    if (ptr_) {
+      ptr_->Release();
+    }
+  }
+
+  scoped_refptr& operator=(std::nullptr_t) {
+    reset();
+    return *this;
+  }
+
+  scoped_refptr& operator=(scoped_refptr other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  void reset() { scoped_refptr().swap(*this); }
+
+  void swap(scoped_refptr& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+  T* get() const { return ptr_; }
+  T& operator*() const { return *ptr_; }
+  T* operator->() const { return ptr_; }
+
+  explicit operator bool() const { return ptr_ != nullptr; }
+
+ private:
+  template <typename U>
+  friend class scoped_refptr;
+
+  T* ptr_ = nullptr;
+};
+
+template <typename T>
+scoped_refptr<T> WrapRefCounted(T* ptr) {
+  return scoped_refptr<T>(ptr);
+}
+
+template <typename T, typename U>
+bool operator==(const scoped_refptr<T>& lhs, const scoped_refptr<U>& rhs) {
+  return lhs.get() == rhs.get();
+}
+
+template <typename T, typename U>
+bool operator!=(const scoped_refptr<T>& lhs, const scoped_refptr<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename U>
+bool operator==(const scoped_refptr<T>& lhs, const U* rhs) {
+  return lhs.get() == rhs;
+}
+
+template <typename T, typename U>
+bool operator!=(const scoped_refptr<T>& lhs, const U* rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T>
+bool operator==(const scoped_refptr<T>& lhs, std::nullptr_t) {
+  return !lhs;
+}
+
+template <typename T>
+bool operator==(std::nullptr_t, const scoped_refptr<T>& rhs) {
+  return !rhs;
+}
+
+template <typename T>
+bool operator!=(const scoped_refptr<T>& lhs, std::nullptr_t) {
+  return !!lhs;
+}
+
+template <typename T>
+bool operator!=(std::nullptr_t, const scoped_refptr<T>& rhs) {
+  return !!rhs;
+}
+
+template <typename T, typename U>
+bool operator<(const scoped_refptr<T>& lhs, const scoped_refptr<U>& rhs) {
+  return std::less<>{}(lhs.get(), rhs.get());
+}
+
+}  // namespace base
+
+namespace std {
+
+template <typename T>
+struct hash<base::scoped_refptr<T>> {
+  size_t operator()(const base::scoped_refptr<T>& ptr) const {
+    return hash<T*>{}(ptr.get());
+  }
+};
+
+}  // namespace std
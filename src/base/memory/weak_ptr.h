@@ -2,9 +2,9 @@
 
 #include <atomic>
 #include <cstddef>
-#include <memory>
 #include <utility>
 
+#include "base/memory/ref_counted.h"
 #include "base/sequence_checker.h"
 
 namespace base {
@@ -15,13 +15,41 @@ template <typename T>
 class WeakPtrFactory;
 
 namespace detail {
-struct WeakPtrControlBlock {
-  WeakPtrControlBlock() : weak_count(0) {
-    DETACH_FROM_SEQUENCE(sequence_checker);
+// Validity flag shared by a `WeakPtrFactory` and all `WeakPtr`s it handed out.
+// It's invalidated (but not reallocated) by the factory, so checking it on the
+// owning sequence is a plain load.
+class WeakReferenceFlag : public RefCountedThreadSafe<WeakReferenceFlag> {
+ public:
+  WeakReferenceFlag() { DETACH_FROM_SEQUENCE(sequence_checker_); }
+
+  bool IsValid() const {
+    const bool is_valid = is_valid_.load(std::memory_order_relaxed);
+    if (is_valid) {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    }
+    return is_valid;
   }
 
-  std::atomic_size_t weak_count;
-  SEQUENCE_CHECKER(sequence_checker);
+  // May be called from any sequence, but may return stale result.
+  bool MaybeValid() const { return is_valid_.load(std::memory_order_relaxed); }
+
+  void Invalidate() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    InvalidateOnAnySequence();
+  }
+
+  void InvalidateOnAnySequence() {
+    is_valid_.store(false, std::memory_order_relaxed);
+  }
+
+  void DetachFromSequence() { DETACH_FROM_SEQUENCE(sequence_checker_); }
+
+ private:
+  friend class RefCountedThreadSafe<WeakReferenceFlag>;
+  ~WeakReferenceFlag() = default;
+
+  std::atomic_bool is_valid_{true};
+  SEQUENCE_CHECKER(sequence_checker_);
 };
 }  // namespace detail
 
@@ -30,33 +58,31 @@ class WeakPtr {
  public:
   WeakPtr() : ptr_(nullptr) {}
   explicit WeakPtr(std::nullptr_t) : WeakPtr() {}
-  ~WeakPtr() { DecreaseWeakCount(); }
 
-  WeakPtr(const WeakPtr& other)
-      : ptr_(other.ptr_), control_block_(other.control_block_) {
-    IncreaseWeakCount();
-  }
+  WeakPtr(const WeakPtr& other) = default;
+
+  WeakPtr(WeakPtr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)),
+        flag_(std::move(other.flag_)) {}
 
   template <typename U>
-  WeakPtr(const WeakPtr<U>& other)
-      : ptr_(other.ptr_), control_block_(other.control_block_) {
-    IncreaseWeakCount();
-  }
+  WeakPtr(const WeakPtr<U>& other) : ptr_(other.ptr_), flag_(other.flag_) {}
 
   template <typename U>
   WeakPtr(WeakPtr<U>&& other)
       : ptr_(std::exchange(other.ptr_, nullptr)),
-        control_block_(std::exchange(other.control_block_, {})) {}
+        flag_(std::move(other.flag_)) {}
+
+  WeakPtr& operator=(const WeakPtr& other) = default;
+
+  WeakPtr& operator=(WeakPtr&& other) noexcept {
+    return operator=<T>(std::move(other));
+  }
 
   template <typename U>
   WeakPtr& operator=(const WeakPtr<U>& other) {
-    if (reinterpret_cast<uintptr_t>(this) !=
-        reinterpret_cast<uintptr_t>(&other)) {
-      DecreaseWeakCount();
-      ptr_ = other.ptr_;
-      control_block_ = other.control_block_;
-      IncreaseWeakCount();
-    }
+    ptr_ = other.ptr_;
+    flag_ = other.flag_;
     return *this;
   }
 
@@ -64,9 +90,8 @@ class WeakPtr {
   WeakPtr& operator=(WeakPtr<U>&& other) {
     if (reinterpret_cast<uintptr_t>(this) !=
         reinterpret_cast<uintptr_t>(&other)) {
-      DecreaseWeakCount();
       ptr_ = std::exchange(other.ptr_, nullptr);
-      control_block_ = std::exchange(other.control_block_, {});
+      flag_ = std::move(other.flag_);
     }
     return *this;
   }
@@ -83,48 +108,22 @@ class WeakPtr {
 
   explicit operator bool() const { return (Get() != nullptr); }
 
-  T* Get() const {
-    if (auto control_block = control_block_.lock()) {
-      DCHECK_CALLED_ON_VALID_SEQUENCE(control_block->sequence_checker);
-      return ptr_;
-    }
-    return nullptr;
-  }
+  T* Get() const { return (flag_ && flag_->IsValid()) ? ptr_ : nullptr; }
 
-  bool MaybeValid() const { return !control_block_.expired(); }
+  bool MaybeValid() const { return flag_ && flag_->MaybeValid(); }
 
-  bool WasInvalidated() const {
-    if (auto control_block = control_block_.lock()) {
-      DCHECK_CALLED_ON_VALID_SEQUENCE(control_block->sequence_checker);
-      return false;
-    }
-    return !!ptr_;
-  }
+  bool WasInvalidated() const { return flag_ && !flag_->IsValid(); }
 
  private:
   friend class WeakPtrFactory<T>;
   template <typename U>
   friend class WeakPtr;
 
-  WeakPtr(T* ptr, std::weak_ptr<detail::WeakPtrControlBlock> control_block)
-      : ptr_(ptr), control_block_(std::move(control_block)) {
-    IncreaseWeakCount();
-  }
-
-  void IncreaseWeakCount() {
-    if (auto control_block = control_block_.lock()) {
-      ++(control_block->weak_count);
-    }
-  }
-
-  void DecreaseWeakCount() {
-    if (auto control_block = control_block_.lock()) {
-      --(control_block->weak_count);
-    }
-  }
+  WeakPtr(T* ptr, scoped_refptr<detail::WeakReferenceFlag> flag)
+      : ptr_(ptr), flag_(std::move(flag)) {}
 
   T* ptr_;
-  std::weak_ptr<detail::WeakPtrControlBlock> control_block_;
+  scoped_refptr<detail::WeakReferenceFlag> flag_;
 };
 
 template <typename T>
@@ -150,10 +149,14 @@ bool operator!=(std::nullptr_t, const WeakPtr<T>& weak_ptr) {
 template <typename T>
 class WeakPtrFactory {
  public:
-  explicit WeakPtrFactory(T* ptr)
-      : ptr_(ptr),
-        control_block_(std::make_shared<detail::WeakPtrControlBlock>()) {
-    DCHECK(ptr_);
+  explicit WeakPtrFactory(T* ptr) : ptr_(ptr) { DCHECK(ptr_); }
+
+  ~WeakPtrFactory() {
+    if (flag_) {
+      // Unlike `InvalidateWeakPtrs()`, the factory may be destroyed on any
+      // sequence.
+      flag_->InvalidateOnAnySequence();
+    }
   }
 
   WeakPtrFactory(const WeakPtrFactory&) = delete;
@@ -162,26 +165,27 @@ class WeakPtrFactory {
   WeakPtrFactory& operator=(WeakPtrFactory&&) = delete;
 
   WeakPtr<T> GetWeakPtr() const {
-    if (!HasWeakPtrs()) {
-      DETACH_FROM_SEQUENCE(control_block_->sequence_checker);
+    if (!flag_) {
+      // The flag is allocated lazily, so invalidation doesn't allocate.
+      flag_ = MakeRefCounted<detail::WeakReferenceFlag>();
+    } else if (!HasWeakPtrs()) {
+      flag_->DetachFromSequence();
     }
-    return WeakPtr<T>{ptr_, control_block_};
+    return WeakPtr<T>{ptr_, flag_};
   }
 
   void InvalidateWeakPtrs() {
-    DCHECK(control_block_);
-    DCHECK_CALLED_ON_VALID_SEQUENCE(control_block_->sequence_checker);
-    control_block_ = std::make_shared<detail::WeakPtrControlBlock>();
+    if (flag_) {
+      flag_->Invalidate();
+      flag_.reset();
+    }
   }
 
-  bool HasWeakPtrs() const {
-    DCHECK(control_block_);
-    return (control_block_->weak_count > 0);
-  }
+  bool HasWeakPtrs() const { return flag_ && !flag_->HasOneRef(); }
 
  protected:
   T* const ptr_;
-  std::shared_ptr<detail::WeakPtrControlBlock> control_block_;
+  mutable scoped_refptr<detail::WeakReferenceFlag> flag_;
 };
 
 }  // namespace base
@@ -1,20 +1,53 @@
 #include "base/message_loop/message_loop_impl.h"
 
+#include <algorithm>
+#include <optional>
+
+#include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/sequenced_task_runner_helpers.h"
-#include "base/threading/delayed_task_manager_shared_instance.h"
+#include "base/threading/sequence_local_storage_map.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 
 namespace base {
 
 namespace {
 
+// Upper bound of the deadline given to idle tasks, so that the thread stays
+// responsive to work that cannot be predicted (e.g. tasks posted from other
+// threads).
+const TimeDelta kMaxIdlePeriod = Milliseconds(50);
+
+// Message loop that is executing a task on the current thread (if any).
+thread_local const MessageLoopImpl* g_current_message_loop = nullptr;
+
+// Idle tasks should finish before the next delayed task that the executor
+// could run becomes ready.
+TimeTicks ComputeIdleTaskDeadline(MessagePump& message_pump,
+                                  MessagePump::ExecutorId executor_id) {
+  auto deadline = TimeTicks::Now() + kMaxIdlePeriod;
+  if (auto next_wake_up = message_pump.GetNextDelayedWakeUp(executor_id)) {
+    deadline = std::min(deadline, *next_wake_up);
+  }
+  return deadline;
+}
+
 void RunTask(MessagePump::PendingTask&& pending_task, bool set_scoped_handles) {
   if (pending_task.sequence_id && set_scoped_handles) {
     const auto scoped_sequence_id =
         detail::ScopedSequenceIdSetter{*pending_task.sequence_id};
-    const auto scoped_task_runner_handle =
-        SequencedTaskRunnerHandle{pending_task.target_task_runner.lock()};
+
+    std::optional<SequencedTaskRunnerHandle> scoped_task_runner_handle;
+    std::optional<detail::ScopedSequenceLocalStorageMapSetter>
+        scoped_sequence_local_storage;
+    if (pending_task.target_task_runner) {
+      if (auto* sequence_local_storage_map =
+              pending_task.target_task_runner->GetSequenceLocalStorageMap()) {
+        scoped_sequence_local_storage.emplace(*sequence_local_storage_map);
+      }
+      scoped_task_runner_handle.emplace(
+          std::move(pending_task.target_task_runner));
+    }
 
     std::move(pending_task.task).Run();
   } else {
@@ -25,7 +58,7 @@ void RunTask(MessagePump::PendingTask&& pending_task, bool set_scoped_handles) {
 }  // namespace
 
 MessageLoopImpl::MessageLoopImpl(MessagePump::ExecutorId executor_id,
-                                 std::shared_ptr<MessagePump> message_pump,
+                                 scoped_refptr<MessagePump> message_pump,
                                  bool set_scoped_handles)
     : set_scoped_handles_(set_scoped_handles),
       executor_id_(executor_id),
@@ -35,8 +68,15 @@ MessageLoopImpl::MessageLoopImpl(MessagePump::ExecutorId executor_id,
 // TODO: maybe should RunUntilIdle() based on input options?
 MessageLoopImpl::~MessageLoopImpl() = default;
 
+// static
+bool MessageLoopImpl::ShouldYieldCurrentTask() {
+  return g_current_message_loop &&
+         g_current_message_loop->message_pump_->HasPendingTasks(
+             g_current_message_loop->executor_id_);
+}
+
 bool MessageLoopImpl::RunOnce() {
-  return DoRunOnce(true);
+  return DoRunOnce(true) || (!is_stopped_ && DoIdleWork());
 }
 
 void MessageLoopImpl::RunUntilIdle() {
@@ -59,14 +99,39 @@ void MessageLoopImpl::Stop(MessagePump::PendingTask last_task) {
 bool MessageLoopImpl::DoRunOnce(bool wait_for_task) {
   if (auto pending_task =
           message_pump_->GetNextPendingTask(executor_id_, wait_for_task)) {
-    RunTask(std::move(pending_task), set_scoped_handles_);
+    RunTaskOnCurrentThread(std::move(pending_task));
+    return true;
+  }
+  return false;
+}
+
+bool MessageLoopImpl::DoIdleWork() {
+  if (auto idle_task = message_pump_->GetNextIdleTask(executor_id_)) {
+    RunTaskOnCurrentThread(
+        {BindOnce(std::move(idle_task.task),
+                  ComputeIdleTaskDeadline(*message_pump_, executor_id_)),
+         std::move(idle_task.sequence_id),
+         std::move(idle_task.allowed_executor_id),
+         std::move(idle_task.target_task_runner)});
     return true;
   }
   return false;
 }
 
+void MessageLoopImpl::RunTaskOnCurrentThread(
+    MessagePump::PendingTask pending_task) {
+  // Nested loops (e.g. `base::RunLoop` run from within a task) restore the
+  // outer one once their task is finished.
+  const AutoReset<const MessageLoopImpl*> current_message_loop(
+      &g_current_message_loop, this);
+  RunTask(std::move(pending_task), set_scoped_handles_);
+}
+
 void MessageLoopImpl::RunUntilIdleOrStop() {
-  while (!is_stopped_ && DoRunOnce(true)) {
+  // Idle tasks are run only if there is no other work that could be done
+  // instead. Blocking wait returns early if only idle work is available.
+  while (!is_stopped_ &&
+         (DoRunOnce(false) || DoIdleWork() || DoRunOnce(true))) {
   }
 }
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <atomic>
-#include <memory>
 
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_pump.h"
@@ -11,10 +10,15 @@ namespace base {
 class MessageLoopImpl : public MessageLoop {
  public:
   MessageLoopImpl(MessagePump::ExecutorId executor_id,
-                  std::shared_ptr<MessagePump> message_pump,
+                  scoped_refptr<MessagePump> message_pump,
                   bool set_scoped_handles = true);
   ~MessageLoopImpl() override;
 
+  // Returns true if the task currently executed on this thread by a message
+  // loop should yield, because its message pump has other pending tasks that
+  // could be executed instead. Returns false if called outside of such task.
+  static bool ShouldYieldCurrentTask();
+
   // MessageLoop
   bool RunOnce() override;
   void RunUntilIdle() override;
@@ -23,11 +27,13 @@ class MessageLoopImpl : public MessageLoop {
 
  private:
   bool DoRunOnce(bool wait_for_task);
+  bool DoIdleWork();
+  void RunTaskOnCurrentThread(MessagePump::PendingTask pending_task);
   void RunUntilIdleOrStop();
 
   const bool set_scoped_handles_;
   const MessagePump::ExecutorId executor_id_;
-  std::shared_ptr<MessagePump> message_pump_;
+  scoped_refptr<MessagePump> message_pump_;
   std::atomic_bool is_stopped_;
 };
 
@@ -4,32 +4,115 @@
 #include <optional>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/sequence_id.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_ticks.h"
 
 namespace base {
 
-class SequencedTaskRunner;
-
-class MessagePump {
+class MessagePump : public RefCountedThreadSafe<MessagePump> {
  public:
   using ExecutorId = uintptr_t;  // TODO: make it better!
 
+  // Tasks that were not started before their expiration time are dropped and
+  // |on_dropped| (if set) is executed instead of them.
+  struct TaskExpiry {
+    TimeTicks expiration_time;
+    OnceClosure on_dropped;
+    SourceLocation location;
+  };
+
+  // Tasks from the same group are executed by at most |max_concurrency|
+  // executors at once.
+  struct ConcurrencyLimit {
+    uint64_t group_id;
+    size_t max_concurrency;
+  };
+
   struct PendingTask {
     explicit operator bool() const { return !!task; }
 
     OnceClosure task;
     std::optional<SequenceId> sequence_id;
     std::optional<ExecutorId> allowed_executor_id;
-    std::weak_ptr<SequencedTaskRunner> target_task_runner;
+    scoped_refptr<SequencedTaskRunner> target_task_runner;
+    // Tasks with a deadline are executed in earliest-deadline-first order
+    // (with respect to the order of tasks within each sequence) before tasks
+    // without one.
+    std::optional<TimeTicks> deadline = {};
+    // Held out of line, as most of the tasks don't expire.
+    std::unique_ptr<TaskExpiry> expiry = {};
+    std::optional<ConcurrencyLimit> concurrency_limit = {};
+  };
+
+  // Idle tasks are given a deadline by which they should finish so that they
+  // won't delay any other (already known) work.
+  using IdleTaskCallback = OnceCallback<void(TimeTicks deadline)>;
+
+  struct PendingIdleTask {
+    explicit operator bool() const { return !!task; }
+
+    IdleTaskCallback task;
+    std::optional<SequenceId> sequence_id;
+    std::optional<ExecutorId> allowed_executor_id;
+    scoped_refptr<SequencedTaskRunner> target_task_runner;
+    // Where the task was posted from.
+    SourceLocation location = FROM_HERE;
   };
 
   virtual ~MessagePump() = default;
 
+  // If |wait_for_task| is set, blocks until there is a task that can be
+  // executed by given executor. Returns an empty task if the pump has been
+  // stopped or if there is only idle work available for given executor.
   virtual PendingTask GetNextPendingTask(ExecutorId executor_id,
                                          bool wait_for_task) = 0;
   virtual bool QueuePendingTask(PendingTask pending_task) = 0;
 
+  // Returns an idle task only if there are no other pending tasks that could
+  // be executed by given executor. Pumps that do not support idle tasks never
+  // queue them.
+  virtual PendingIdleTask GetNextIdleTask(ExecutorId /*executor_id*/) {
+    return {};
+  }
+  virtual bool QueueIdleTask(PendingIdleTask /*pending_idle_task*/) {
+    return false;
+  }
+
+  // Delayed tasks are kept outside of the pump until they are ready to run.
+  // Their owners (e.g. `DelayedTaskManager`) inform the pump about them, so
+  // that idle tasks are given deadlines that won't delay them. Each added
+  // wake-up must be removed once its task was queued to the pump or dropped.
+  virtual void AddDelayedWakeUp(
+      TimeTicks /*run_time*/,
+      std::optional<ExecutorId> /*allowed_executor_id*/) {}
+  virtual void RemoveDelayedWakeUp(
+      TimeTicks /*run_time*/,
+      std::optional<ExecutorId> /*allowed_executor_id*/) {}
+
+  // Returns the earliest time at which a delayed task that given executor
+  // could execute will be queued, if there is any.
+  virtual std::optional<TimeTicks> GetNextDelayedWakeUp(
+      ExecutorId /*executor_id*/) {
+    return {};
+  }
+
+  // Returns true if there is a pending task that given executor could execute
+  // instead of the one it's currently executing (including tasks that wait for
+  // the current one to finish, e.g. because they are from the same sequence).
+  // Used to decide whether long-running tasks should yield. Pumps that can't
+  // tell always return false.
+  virtual bool HasPendingTasks(ExecutorId /*executor_id*/) { return false; }
+
   virtual void Stop(PendingTask last_task) = 0;
+
+  // Destroys all the tasks that are still queued. Called by the owner of the
+  // pump once it was stopped and none of its executors runs tasks anymore.
+  // Queued tasks keep their task runners (and therefore the pump) alive, so
+  // they have to be dropped explicitly.
+  virtual void DropPendingTasks() {}
 };
 
 }  // namespace base
@@ -1,85 +1,633 @@
 #include "base/message_loop/message_pump_impl.h"
 
 #include <algorithm>
+#include <atomic>
+#include <utility>
 
 #include "base/logging.h"
+#include "base/threading/dropped_task_counters.h"
 
 namespace base {
 
-MessagePumpImpl::MessagePumpImpl(size_t executors_count) : stopped_(false) {
+namespace {
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+struct PumpsRegistry {
+  std::mutex mutex;
+  std::condition_variable cond_var;
+  std::vector<MessagePumpImpl*> pumps;
+  // Incremented (under |mutex|) whenever idle waiters are notified.
+  uint64_t notifications_count = 0;
+  std::atomic<size_t> waiters_count{0};
+};
+
+PumpsRegistry& GetPumpsRegistry() {
+  // Leaked on purpose, so that pumps can be destroyed during static
+  // de-initialization.
+  static auto* registry = new PumpsRegistry();
+  return *registry;
+}
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+// Cancelled tasks are swept from the queue whenever it doubles in size since
+// the last sweep (but not before it holds at least this many tasks), so that
+// the cost of sweeps is amortized over posted tasks.
+constexpr size_t kMinPendingTasksCountToSweep = 64;
+
+}  // namespace
+
+MessagePumpImpl::MessagePumpImpl(size_t executors_count)
+    : stopped_(false),
+      busy_executors_count_(0),
+      generation_(0),
+      deadline_tasks_count_(0),
+      next_sweep_pending_tasks_count_(kMinPendingTasksCountToSweep),
+      is_deadline_index_built_(false) {
   active_sequences_.resize(executors_count);
+  active_concurrency_groups_.resize(executors_count);
+  busy_executors_.resize(executors_count, false);
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  auto& registry = GetPumpsRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.pumps.push_back(this);
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+}
+
+MessagePumpImpl::~MessagePumpImpl() {
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  auto& registry = GetPumpsRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.pumps.erase(
+      std::find(registry.pumps.begin(), registry.pumps.end(), this));
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+}
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+// static
+bool MessagePumpImpl::WaitForAllPumpsIdleForTesting() {
+  auto& registry = GetPumpsRegistry();
+  std::unique_lock<std::mutex> registry_lock(registry.mutex);
+
+  // Pumps that change their state after they were checked below see the
+  // waiter and notify it once the registry lock is released by `wait()`.
+  ++registry.waiters_count;
+  const uint64_t notifications_count = registry.notifications_count;
+
+  // Pumps are checked one by one, so a task running in a pump that was not
+  // checked yet could post a new task to an already checked one. Such posts
+  // are detected by comparing generations of all pumps once again.
+  std::vector<uint64_t> generations;
+  bool all_pumps_idle = true;
+  bool has_unclaimed_tasks = false;
+  for (auto* pump : registry.pumps) {
+    std::lock_guard<std::mutex> guard(pump->mutex_);
+    if (!pump->IsIdle_Locked()) {
+      all_pumps_idle = false;
+      // Tasks of pumps without busy executors are about to be picked up (or
+      // are meant for the calling thread), so there is no point in waiting.
+      has_unclaimed_tasks |= (pump->busy_executors_count_ == 0);
+    }
+    generations.push_back(pump->generation_);
+  }
+
+  if (all_pumps_idle) {
+    for (size_t idx = 0; idx < registry.pumps.size(); ++idx) {
+      auto* pump = registry.pumps[idx];
+      std::lock_guard<std::mutex> guard(pump->mutex_);
+      if (pump->generation_ != generations[idx] || !pump->IsIdle_Locked()) {
+        all_pumps_idle = false;
+        has_unclaimed_tasks = true;
+        break;
+      }
+    }
+  }
+
+  if (!all_pumps_idle && !has_unclaimed_tasks) {
+    registry.cond_var.wait(registry_lock, [&]() {
+      return registry.notifications_count != notifications_count;
+    });
+  }
+
+  --registry.waiters_count;
+  return all_pumps_idle;
+}
+
+// static
+bool MessagePumpImpl::HasIdleWaiters() {
+  return GetPumpsRegistry().waiters_count.load() > 0;
 }
 
+// static
+void MessagePumpImpl::NotifyIdleWaiters() {
+  auto& registry = GetPumpsRegistry();
+  {
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    ++registry.notifications_count;
+  }
+  registry.cond_var.notify_all();
+}
+
+void MessagePumpImpl::NotifyIdleWaitersIfIdle_Locked(
+    std::unique_lock<std::mutex>& lock) {
+  if (HasIdleWaiters() && IsIdle_Locked()) {
+    // Pumps are locked after the registry, so the lock has to be released.
+    lock.unlock();
+    NotifyIdleWaiters();
+    lock.lock();
+  }
+}
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
 MessagePumpImpl::PendingTask MessagePumpImpl::GetNextPendingTask(
     ExecutorId executor_id,
     bool wait_for_task) {
+  // Declared before the lock, so that dropped tasks are destroyed after the
+  // lock is released (their destruction might post new tasks).
+  DroppedTasks dropped_tasks;
   std::unique_lock<std::mutex> lock(mutex_);
 
   // Executor asks for a next pending task only if it finished processing last
   // one. Based on that we can unblock processing of tasks from the same
   // sequence the last executor's task was.
-  DCHECK_LT(executor_id, active_sequences_.size());
-  active_sequences_[executor_id].reset();
+  MarkExecutorIdle_Locked(executor_id);
 
-  if (auto pending_task = GetNextPendingTask_Locked(executor_id)) {
+  if (auto pending_task =
+          GetNextPendingTask_Locked(executor_id, dropped_tasks)) {
     return pending_task;
   }
 
-  if (!wait_for_task) {
-    return {};
-  }
+  while (true) {
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+    // The executor has nothing to do, so the pump might have become idle.
+    NotifyIdleWaitersIfIdle_Locked(lock);
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+    if (!wait_for_task) {
+      return {};
+    }
 
-  cond_var_.wait(lock, [&]() {
-    return (stopped_ || HasAllowedPendingTasks_Locked(executor_id));
-  });
-  return GetNextPendingTask_Locked(executor_id);
+    cond_var_.wait(lock, [&]() {
+      return (stopped_ || HasAllowedPendingTasks_Locked(executor_id) ||
+              HasAllowedPendingIdleTasks_Locked(executor_id));
+    });
+    if (auto pending_task =
+            GetNextPendingTask_Locked(executor_id, dropped_tasks)) {
+      return pending_task;
+    }
+    // All the available tasks might have expired.
+    if (stopped_ || HasAllowedPendingIdleTasks_Locked(executor_id)) {
+      return {};
+    }
+  }
 }
 
 bool MessagePumpImpl::QueuePendingTask(PendingTask pending_task) {
   bool task_queued = false;
+  // Declared before the lock, so that cancelled tasks are destroyed after the
+  // lock is released.
+  std::vector<PendingTask> cancelled_tasks;
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  bool notify_idle_waiters = false;
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
 
   {
     std::lock_guard<std::mutex> guard(mutex_);
     if (!stopped_) {
-      pending_tasks_.push_back(std::move(pending_task));
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+      notify_idle_waiters = HasIdleWaiters() && IsIdle_Locked();
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+      PushPendingTask_Locked(std::move(pending_task));
       task_queued = true;
+
+      if (pending_tasks_.size() >= next_sweep_pending_tasks_count_) {
+        SweepCancelledPendingTasks_Locked(cancelled_tasks);
+      }
     }
   }
 
   cond_var_.notify_one();
 
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  // The pump was idle, so the task might have to be run by the waiter itself.
+  if (notify_idle_waiters) {
+    NotifyIdleWaiters();
+  }
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
   return task_queued;
 }
 
+MessagePumpImpl::PendingIdleTask MessagePumpImpl::GetNextIdleTask(
+    ExecutorId executor_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  MarkExecutorIdle_Locked(executor_id);
+
+  // Idle tasks never compete with regular ones.
+  if (stopped_ || HasAllowedPendingTasks_Locked(executor_id)) {
+    return {};
+  }
+
+  const auto allowed_idle_task_iter =
+      FindFirstAllowedPendingIdleTaskIter_Locked(executor_id);
+  if (allowed_idle_task_iter == pending_idle_tasks_.end()) {
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+    NotifyIdleWaitersIfIdle_Locked(lock);
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+    return {};
+  }
+
+  PendingIdleTask idle_task = std::move(*allowed_idle_task_iter);
+  pending_idle_tasks_.erase(allowed_idle_task_iter);
+
+  MarkExecutorBusy_Locked(executor_id, idle_task.sequence_id);
+
+  return idle_task;
+}
+
+bool MessagePumpImpl::QueueIdleTask(PendingIdleTask pending_idle_task) {
+  bool task_queued = false;
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!stopped_) {
+      pending_idle_tasks_.push_back(std::move(pending_idle_task));
+      task_queued = true;
+    }
+  }
+
+  // Idle tasks are usually bound to a specific executor, so we have to make
+  // sure that the right one will wake up.
+  cond_var_.notify_all();
+
+  return task_queued;
+}
+
+void MessagePumpImpl::AddDelayedWakeUp(
+    TimeTicks run_time,
+    std::optional<ExecutorId> allowed_executor_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  delayed_wake_ups_[allowed_executor_id].insert(run_time);
+}
+
+void MessagePumpImpl::RemoveDelayedWakeUp(
+    TimeTicks run_time,
+    std::optional<ExecutorId> allowed_executor_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& run_times = delayed_wake_ups_[allowed_executor_id];
+  const auto run_time_iter = run_times.find(run_time);
+  DCHECK(run_time_iter != run_times.end());
+  run_times.erase(run_time_iter);
+}
+
+std::optional<TimeTicks> MessagePumpImpl::GetNextDelayedWakeUp(
+    ExecutorId executor_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  std::optional<TimeTicks> next_wake_up;
+  for (const auto& allowed_executor_id :
+       {std::optional<ExecutorId>{}, std::make_optional(executor_id)}) {
+    const auto run_times_iter = delayed_wake_ups_.find(allowed_executor_id);
+    if (run_times_iter == delayed_wake_ups_.end() ||
+        run_times_iter->second.empty()) {
+      continue;
+    }
+    const auto run_time = *run_times_iter->second.begin();
+    next_wake_up = next_wake_up ? std::min(*next_wake_up, run_time) : run_time;
+  }
+  return next_wake_up;
+}
+
+bool MessagePumpImpl::HasPendingTasks(ExecutorId executor_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  DCHECK_LT(executor_id, active_sequences_.size());
+
+  if (stopped_ || pending_tasks_.empty()) {
+    return false;
+  }
+
+  // Tasks blocked only by the task that given executor is currently processing
+  // would be unblocked if it yielded, so they are taken into account as well.
+  const auto active_sequence =
+      std::exchange(active_sequences_[executor_id], std::nullopt);
+  const auto active_concurrency_group =
+      std::exchange(active_concurrency_groups_[executor_id], std::nullopt);
+
+  // Idle executors pick up the tasks that they can run on their own, so
+  // yielding helps only if there are more of such tasks than idle executors or
+  // if a task can be run only by given executor (or only once it yields).
+  const size_t idle_executors_count =
+      busy_executors_.size() - busy_executors_count_;
+  size_t tasks_for_idle_executors_count = 0;
+  bool has_pending_tasks = false;
+  for (const PendingTask& task : pending_tasks_) {
+    // Tasks known to be cancelled will be dropped without running.
+    if (!task.task.MaybeValid() ||
+        !IsPendingTaskAllowed_Locked(task, executor_id)) {
+      continue;
+    }
+    const bool needs_executor =
+        task.allowed_executor_id ||
+        (task.sequence_id && task.sequence_id == active_sequence) ||
+        (task.concurrency_limit &&
+         task.concurrency_limit->group_id == active_concurrency_group);
+    if (needs_executor ||
+        ++tasks_for_idle_executors_count > idle_executors_count) {
+      has_pending_tasks = true;
+      break;
+    }
+  }
+
+  active_sequences_[executor_id] = active_sequence;
+  active_concurrency_groups_[executor_id] = active_concurrency_group;
+
+  return has_pending_tasks;
+}
+
 void MessagePumpImpl::Stop(PendingTask last_task) {
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  bool notify_idle_waiters = false;
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
   {
     std::lock_guard<std::mutex> guard(mutex_);
     if (!stopped_ && last_task) {
-      pending_tasks_.push_back(std::move(last_task));
+      PushPendingTask_Locked(std::move(last_task));
     }
     stopped_ = true;
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+    // Stopped pumps are considered idle.
+    notify_idle_waiters = HasIdleWaiters();
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
   }
 
   cond_var_.notify_all();
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  if (notify_idle_waiters) {
+    NotifyIdleWaiters();
+  }
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
 }
 
-MessagePumpImpl::PendingTask MessagePumpImpl::GetNextPendingTask_Locked(
-    ExecutorId executor_id) {
-  const auto allowed_pending_task_iter =
-      FindFirstAllowedPendingTaskIter_Locked(executor_id);
-  if (allowed_pending_task_iter == pending_tasks_.end()) {
-    return {};
+void MessagePumpImpl::DropPendingTasks() {
+  // Tasks are destroyed after the lock is released, as their destruction
+  // might post new tasks.
+  PendingTaskList dropped_tasks;
+  PendingIdleTaskList dropped_idle_tasks;
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    DCHECK(stopped_);
+    dropped_tasks.swap(pending_tasks_);
+    dropped_idle_tasks.swap(pending_idle_tasks_);
+    deadline_tasks_count_ = 0;
+    next_sweep_pending_tasks_count_ = kMinPendingTasksCountToSweep;
+    is_deadline_index_built_ = false;
+    deadline_tasks_.clear();
+    sequence_tasks_.clear();
   }
+}
 
-  PendingTask task = std::move(*allowed_pending_task_iter);
-  pending_tasks_.erase(allowed_pending_task_iter);
+void MessagePumpImpl::MarkExecutorIdle_Locked(ExecutorId executor_id) {
+  // Executor asks for a next task only if it finished processing last one.
+  // Based on that we can unblock processing of tasks from the same sequence
+  // the last executor's task was.
+  DCHECK_LT(executor_id, active_sequences_.size());
+  active_sequences_[executor_id].reset();
+  active_concurrency_groups_[executor_id].reset();
 
+  if (busy_executors_[executor_id]) {
+    busy_executors_[executor_id] = false;
+    --busy_executors_count_;
+  }
+}
+
+void MessagePumpImpl::MarkExecutorBusy_Locked(
+    ExecutorId executor_id,
+    std::optional<SequenceId> sequence_id,
+    std::optional<uint64_t> concurrency_group_id) {
   // Mark that requesting executor is now processing task from given sequence.
-  active_sequences_[executor_id] = task.sequence_id;
+  active_sequences_[executor_id] = std::move(sequence_id);
+  active_concurrency_groups_[executor_id] = concurrency_group_id;
+
+  busy_executors_[executor_id] = true;
+  ++busy_executors_count_;
+}
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+bool MessagePumpImpl::IsIdle_Locked() const {
+  return stopped_ || (pending_tasks_.empty() && busy_executors_count_ == 0);
+}
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+MessagePumpImpl::DroppedTasks::~DroppedTasks() {
+  for (const auto& location : expired_task_locations) {
+    DroppedTaskCounters::RecordDroppedTask(location);
+  }
+}
+
+MessagePumpImpl::PendingTask MessagePumpImpl::GetNextPendingTask_Locked(
+    ExecutorId executor_id,
+    DroppedTasks& dropped_tasks) {
+  while (true) {
+    const auto allowed_pending_task_iter =
+        deadline_tasks_count_ > 0
+            ? FindEarliestDeadlinePendingTaskIter_Locked(executor_id)
+            : FindFirstAllowedPendingTaskIter_Locked(executor_id);
+    if (allowed_pending_task_iter == pending_tasks_.end()) {
+      return {};
+    }
+
+    PendingTask task = TakePendingTask_Locked(allowed_pending_task_iter);
+
+    // Cancelled tasks would be no-ops, so they are dropped (along with their
+    // expiration notifications) without occupying an executor.
+    if (!task.task.MaybeValid()) {
+      dropped_tasks.tasks.push_back(std::move(task));
+      continue;
+    }
+
+    if (task.expiry && task.expiry->expiration_time <= TimeTicks::Now()) {
+      dropped_tasks.expired_task_locations.push_back(task.expiry->location);
+      if (!task.expiry->on_dropped) {
+        dropped_tasks.tasks.push_back(std::move(task));
+        continue;
+      }
+      // Notification about dropped task is executed as a regular task
+      // within the same sequence.
+      PendingTask expired_task;
+      expired_task.task =
+          std::exchange(task.task, std::move(task.expiry->on_dropped));
+      dropped_tasks.tasks.push_back(std::move(expired_task));
+    }
 
+    MarkExecutorBusy_Locked(
+        executor_id, task.sequence_id,
+        task.concurrency_limit
+            ? std::make_optional(task.concurrency_limit->group_id)
+            : std::nullopt);
+
+    return task;
+  }
+}
+
+void MessagePumpImpl::PushPendingTask_Locked(PendingTask pending_task) {
+  if (pending_task.deadline) {
+    ++deadline_tasks_count_;
+  }
+  pending_tasks_.push_back(std::move(pending_task));
+  ++generation_;
+
+  if (is_deadline_index_built_) {
+    IndexPendingTask_Locked(std::prev(pending_tasks_.end()), generation_);
+  } else if (pending_tasks_.back().deadline) {
+    RebuildDeadlineIndex_Locked();
+  }
+}
+
+MessagePumpImpl::PendingTask MessagePumpImpl::TakePendingTask_Locked(
+    PendingTaskIter task_iter) {
+  if (is_deadline_index_built_) {
+    UnindexPendingTask_Locked(task_iter);
+  }
+  if (task_iter->deadline) {
+    --deadline_tasks_count_;
+  }
+
+  PendingTask task = std::move(*task_iter);
+  pending_tasks_.erase(task_iter);
+
+  if (pending_tasks_.empty()) {
+    next_sweep_pending_tasks_count_ = kMinPendingTasksCountToSweep;
+    DCHECK(deadline_tasks_.empty() && sequence_tasks_.empty());
+    is_deadline_index_built_ = false;
+  }
   return task;
 }
 
+bool MessagePumpImpl::DeadlineTaskKey::operator<(
+    const DeadlineTaskKey& other) const {
+  return deadline < other.deadline ||
+         (deadline == other.deadline && order < other.order);
+}
+
+void MessagePumpImpl::RebuildDeadlineIndex_Locked() {
+  deadline_tasks_.clear();
+  sequence_tasks_.clear();
+
+  // Queued tasks are given consecutive orders up to the current generation,
+  // so that tasks queued later get higher ones.
+  uint64_t order = generation_ - pending_tasks_.size();
+  for (auto task_iter = pending_tasks_.begin();
+       task_iter != pending_tasks_.end(); ++task_iter) {
+    IndexPendingTask_Locked(task_iter, ++order);
+  }
+  is_deadline_index_built_ = true;
+}
+
+void MessagePumpImpl::IndexPendingTask_Locked(PendingTaskIter task_iter,
+                                              uint64_t order) {
+  if (!task_iter->sequence_id) {
+    if (task_iter->deadline) {
+      IndexDeadlineTask_Locked(task_iter, order);
+    }
+    return;
+  }
+
+  auto& sequence_tasks = sequence_tasks_[*task_iter->sequence_id];
+  sequence_tasks.push_back({task_iter, order});
+  if (sequence_tasks.size() == 1 && task_iter->deadline) {
+    IndexDeadlineTask_Locked(task_iter, order);
+  }
+}
+
+void MessagePumpImpl::UnindexPendingTask_Locked(PendingTaskIter task_iter) {
+  if (!task_iter->sequence_id) {
+    if (task_iter->deadline) {
+      UnindexDeadlineTask_Locked(task_iter);
+    }
+    return;
+  }
+
+  const auto sequence_tasks_iter =
+      sequence_tasks_.find(*task_iter->sequence_id);
+  DCHECK(sequence_tasks_iter != sequence_tasks_.end());
+  auto& sequence_tasks = sequence_tasks_iter->second;
+
+  // Tasks are taken from the front of their sequences, unless they expired.
+  const auto sequence_task_iter =
+      std::find_if(sequence_tasks.begin(), sequence_tasks.end(),
+                   [&](const SequenceTask& sequence_task) {
+                     return sequence_task.task_iter == task_iter;
+                   });
+  DCHECK(sequence_task_iter != sequence_tasks.end());
+  if (sequence_task_iter != sequence_tasks.begin()) {
+    sequence_tasks.erase(sequence_task_iter);
+    return;
+  }
+
+  if (task_iter->deadline) {
+    UnindexDeadlineTask_Locked(task_iter);
+  }
+  sequence_tasks.pop_front();
+  if (sequence_tasks.empty()) {
+    sequence_tasks_.erase(sequence_tasks_iter);
+    return;
+  }
+
+  // Next task of the sequence can be executed now.
+  const auto& next_task = sequence_tasks.front();
+  if (next_task.task_iter->deadline) {
+    IndexDeadlineTask_Locked(next_task.task_iter, next_task.order);
+  }
+}
+
+void MessagePumpImpl::IndexDeadlineTask_Locked(PendingTaskIter task_iter,
+                                               uint64_t order) {
+  deadline_tasks_.emplace(DeadlineTaskKey{*task_iter->deadline, order},
+                          task_iter);
+}
+
+void MessagePumpImpl::UnindexDeadlineTask_Locked(PendingTaskIter task_iter) {
+  // Tasks with equal deadlines are rare, so they are searched linearly.
+  auto deadline_task_iter =
+      deadline_tasks_.lower_bound(DeadlineTaskKey{*task_iter->deadline, 0});
+  while (deadline_task_iter != deadline_tasks_.end() &&
+         deadline_task_iter->second != task_iter) {
+    ++deadline_task_iter;
+  }
+  DCHECK(deadline_task_iter != deadline_tasks_.end());
+  deadline_tasks_.erase(deadline_task_iter);
+}
+
+void MessagePumpImpl::SweepCancelledPendingTasks_Locked(
+    std::vector<PendingTask>& cancelled_tasks) {
+  for (auto task_iter = pending_tasks_.begin();
+       task_iter != pending_tasks_.end();) {
+    if (task_iter->task.MaybeValid()) {
+      ++task_iter;
+      continue;
+    }
+    if (task_iter->deadline) {
+      --deadline_tasks_count_;
+    }
+    cancelled_tasks.push_back(std::move(*task_iter));
+    task_iter = pending_tasks_.erase(task_iter);
+  }
+
+  next_sweep_pending_tasks_count_ =
+      std::max(2 * pending_tasks_.size(), kMinPendingTasksCountToSweep);
+
+  // Swept tasks might have been anywhere in their sequences.
+  if (is_deadline_index_built_) {
+    RebuildDeadlineIndex_Locked();
+  }
+}
+
 bool MessagePumpImpl::HasAllowedPendingTasks_Locked(ExecutorId executor_id) {
   return FindFirstAllowedPendingTaskIter_Locked(executor_id) !=
          pending_tasks_.end();
@@ -88,17 +636,61 @@ bool MessagePumpImpl::HasAllowedPendingTasks_Locked(ExecutorId executor_id) {
 MessagePumpImpl::PendingTaskIter
 MessagePumpImpl::FindFirstAllowedPendingTaskIter_Locked(
     ExecutorId executor_id) {
-  // Pending task is allowed for a given executor if:
-  // - task is assigned to that executor or is not assigned to any,
-  // - no executor is currently processing a task from the same sequence.
-  const auto is_pending_task_allowed = [&](const PendingTask& task) {
+  return std::find_if(pending_tasks_.begin(), pending_tasks_.end(),
+                      [&](const PendingTask& task) {
+                        return IsPendingTaskAllowed_Locked(task, executor_id);
+                      });
+}
+
+MessagePumpImpl::PendingTaskIter
+MessagePumpImpl::FindEarliestDeadlinePendingTaskIter_Locked(
+    ExecutorId executor_id) {
+  DCHECK(is_deadline_index_built_);
+
+  // Tasks that can't be executed by given executor right now (e.g. because
+  // their sequences are already processed by other executors) are skipped.
+  for (const auto& [key, task_iter] : deadline_tasks_) {
+    if (IsPendingTaskAllowed_Locked(*task_iter, executor_id)) {
+      return task_iter;
+    }
+  }
+
+  // Tasks without a deadline are executed in FIFO order.
+  return FindFirstAllowedPendingTaskIter_Locked(executor_id);
+}
+
+bool MessagePumpImpl::HasAllowedPendingIdleTasks_Locked(
+    ExecutorId executor_id) {
+  return FindFirstAllowedPendingIdleTaskIter_Locked(executor_id) !=
+         pending_idle_tasks_.end();
+}
+
+MessagePumpImpl::PendingIdleTaskIter
+MessagePumpImpl::FindFirstAllowedPendingIdleTaskIter_Locked(
+    ExecutorId executor_id) {
+  const auto is_idle_task_allowed = [&](const PendingIdleTask& task) {
     return (task.allowed_executor_id.value_or(executor_id) == executor_id) &&
            (!task.sequence_id ||
             !IsTaskFromSequenceCurrentlyProcessed_Locked(*task.sequence_id));
   };
 
-  return std::find_if(pending_tasks_.begin(), pending_tasks_.end(),
-                      is_pending_task_allowed);
+  return std::find_if(pending_idle_tasks_.begin(), pending_idle_tasks_.end(),
+                      is_idle_task_allowed);
+}
+
+bool MessagePumpImpl::IsPendingTaskAllowed_Locked(
+    const PendingTask& task,
+    ExecutorId executor_id) const {
+  // Pending task is allowed for a given executor if:
+  // - task is assigned to that executor or is not assigned to any,
+  // - no executor is currently processing a task from the same sequence,
+  // - the limit of concurrently processed tasks from the same concurrency
+  //   group (if any) is not reached yet.
+  return (task.allowed_executor_id.value_or(executor_id) == executor_id) &&
+         (!task.sequence_id ||
+          !IsTaskFromSequenceCurrentlyProcessed_Locked(*task.sequence_id)) &&
+         (!task.concurrency_limit ||
+          !IsConcurrencyLimitReached_Locked(*task.concurrency_limit));
 }
 
 bool MessagePumpImpl::IsTaskFromSequenceCurrentlyProcessed_Locked(
@@ -110,4 +702,13 @@ bool MessagePumpImpl::IsTaskFromSequenceCurrentlyProcessed_Locked(
                      });
 }
 
+bool MessagePumpImpl::IsConcurrencyLimitReached_Locked(
+    const ConcurrencyLimit& concurrency_limit) const {
+  const auto active_count = std::count(active_concurrency_groups_.begin(),
+                                       active_concurrency_groups_.end(),
+                                       concurrency_limit.group_id);
+  return static_cast<size_t>(active_count) >=
+         concurrency_limit.max_concurrency;
+}
+
 }  // namespace base
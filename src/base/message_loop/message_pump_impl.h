@@ -1,11 +1,16 @@
 #pragma once
 
 #include <condition_variable>
+#include <deque>
 #include <list>
+#include <map>
 #include <mutex>
 #include <optional>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
+#include "base/memory/pool_allocator.h"
 #include "base/message_loop/message_pump.h"
 
 namespace base {
@@ -13,29 +18,142 @@ namespace base {
 class MessagePumpImpl : public MessagePump {
  public:
   explicit MessagePumpImpl(size_t executors_count);
+  ~MessagePumpImpl() override;
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  // Blocks until, in all existing pumps that were not stopped, there are no
+  // pending (non-idle) tasks and no executor is running a task, and returns
+  // true. Returns false early if any pump has tasks that no executor is busy
+  // with (e.g. ones that only the calling thread can run). Used to detect when
+  // all the threads are idle in tests.
+  static bool WaitForAllPumpsIdleForTesting();
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
 
   // MessagePump
   PendingTask GetNextPendingTask(ExecutorId executor_id,
                                  bool wait_for_task) override;
   bool QueuePendingTask(PendingTask pending_task) override;
+  PendingIdleTask GetNextIdleTask(ExecutorId executor_id) override;
+  bool QueueIdleTask(PendingIdleTask pending_idle_task) override;
+  void AddDelayedWakeUp(TimeTicks run_time,
+                        std::optional<ExecutorId> allowed_executor_id) override;
+  void RemoveDelayedWakeUp(
+      TimeTicks run_time,
+      std::optional<ExecutorId> allowed_executor_id) override;
+  std::optional<TimeTicks> GetNextDelayedWakeUp(
+      ExecutorId executor_id) override;
+  bool HasPendingTasks(ExecutorId executor_id) override;
   void Stop(PendingTask last_task) override;
+  void DropPendingTasks() override;
 
  private:
-  using PendingTaskList = std::list<PendingTask>;
+  using PendingTaskList = std::list<PendingTask, PoolStlAllocator<PendingTask>>;
   using PendingTaskIter = PendingTaskList::iterator;
+  using PendingIdleTaskList =
+      std::list<PendingIdleTask, PoolStlAllocator<PendingIdleTask>>;
+  using PendingIdleTaskIter = PendingIdleTaskList::iterator;
+
+  void MarkExecutorIdle_Locked(ExecutorId executor_id);
+  void MarkExecutorBusy_Locked(
+      ExecutorId executor_id,
+      std::optional<SequenceId> sequence_id,
+      std::optional<uint64_t> concurrency_group_id = std::nullopt);
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  bool IsIdle_Locked() const;
+  // `WaitForAllPumpsIdleForTesting()` callers are woken up whenever a pump
+  // might have become idle or an idle pump gets a task. Waiters are checked
+  // under the pump's lock, but notified after it's released.
+  static bool HasIdleWaiters();
+  static void NotifyIdleWaiters();
+  void NotifyIdleWaitersIfIdle_Locked(std::unique_lock<std::mutex>& lock);
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+  // Tasks dropped while the lock is held. They are destroyed (and expired
+  // ones are recorded in `DroppedTaskCounters`) along with this object, which
+  // is meant to outlive the lock. Whole tasks are kept, as destroying any of
+  // their parts (e.g. the last reference to their task runner) might post.
+  struct DroppedTasks {
+    ~DroppedTasks();
 
-  PendingTask GetNextPendingTask_Locked(ExecutorId executor_id);
+    std::vector<PendingTask> tasks;
+    std::vector<SourceLocation> expired_task_locations;
+  };
+
+  // Expired and cancelled tasks are dropped on the way and moved to
+  // |dropped_tasks|, so that they can be handled after the lock is released.
+  PendingTask GetNextPendingTask_Locked(ExecutorId executor_id,
+                                        DroppedTasks& dropped_tasks);
+  void PushPendingTask_Locked(PendingTask pending_task);
+  PendingTask TakePendingTask_Locked(PendingTaskIter task_iter);
+  // Deadline index (see |deadline_tasks_|) maintenance.
+  void RebuildDeadlineIndex_Locked();
+  void IndexPendingTask_Locked(PendingTaskIter task_iter, uint64_t order);
+  void UnindexPendingTask_Locked(PendingTaskIter task_iter);
+  void IndexDeadlineTask_Locked(PendingTaskIter task_iter, uint64_t order);
+  void UnindexDeadlineTask_Locked(PendingTaskIter task_iter);
+  // Removes tasks that are known to be cancelled from |pending_tasks_| and
+  // moves them to |cancelled_tasks|.
+  void SweepCancelledPendingTasks_Locked(
+      std::vector<PendingTask>& cancelled_tasks);
   bool IsTaskFromSequenceCurrentlyProcessed_Locked(
       SequenceId sequence_id) const;
+  bool IsConcurrencyLimitReached_Locked(
+      const ConcurrencyLimit& concurrency_limit) const;
+  bool IsPendingTaskAllowed_Locked(const PendingTask& task,
+                                   ExecutorId executor_id) const;
   bool HasAllowedPendingTasks_Locked(ExecutorId executor_id);
   PendingTaskIter FindFirstAllowedPendingTaskIter_Locked(
       ExecutorId executor_id);
+  PendingTaskIter FindEarliestDeadlinePendingTaskIter_Locked(
+      ExecutorId executor_id);
+  bool HasAllowedPendingIdleTasks_Locked(ExecutorId executor_id);
+  PendingIdleTaskIter FindFirstAllowedPendingIdleTaskIter_Locked(
+      ExecutorId executor_id);
 
   std::mutex mutex_;
   std::condition_variable cond_var_;
   bool stopped_;
   PendingTaskList pending_tasks_;  // TODO: move to separate class
+  PendingIdleTaskList pending_idle_tasks_;
+  // Run times of delayed tasks that will be queued to this pump, by executors
+  // the tasks are bound to (`std::nullopt` for tasks that any executor can
+  // run).
+  std::map<std::optional<ExecutorId>, std::multiset<TimeTicks>>
+      delayed_wake_ups_;
   std::vector<std::optional<SequenceId>> active_sequences_;
+  // Concurrency groups of tasks that are currently processed by executors.
+  std::vector<std::optional<uint64_t>> active_concurrency_groups_;
+  std::vector<bool> busy_executors_;
+  size_t busy_executors_count_;
+  // Incremented whenever a new task is queued.
+  uint64_t generation_;
+
+  // Number of tasks with a deadline in |pending_tasks_|. As long as there are
+  // none, tasks are dequeued in FIFO order.
+  size_t deadline_tasks_count_;
+  // Size of |pending_tasks_| at which cancelled tasks are swept next time.
+  size_t next_sweep_pending_tasks_count_;
+
+  // Deadline index. It's built once the first task with a deadline is queued
+  // and kept until |pending_tasks_| becomes empty. Only the first pending task
+  // of each sequence can be executed, so |deadline_tasks_| holds tasks with a
+  // deadline that are first in their sequences (or are not sequenced),
+  // ordered by deadline and then in FIFO order. |sequence_tasks_| holds
+  // pending tasks of each sequence in order, so that the next task of a
+  // sequence can be indexed once the first one is taken.
+  struct DeadlineTaskKey {
+    bool operator<(const DeadlineTaskKey& other) const;
+
+    TimeTicks deadline;
+    uint64_t order;
+  };
+  struct SequenceTask {
+    PendingTaskIter task_iter;
+    uint64_t order;
+  };
+  bool is_deadline_index_built_;
+  std::map<DeadlineTaskKey, PendingTaskIter> deadline_tasks_;
+  std::unordered_map<SequenceId, std::deque<SequenceTask>> sequence_tasks_;
 };
 
 }  // namespace base
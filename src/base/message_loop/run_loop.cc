@@ -16,27 +16,30 @@ const auto kMainThreadExecutorId = 0;
 
 RunLoop::RunLoop()
     : sequence_id_(detail::SequenceIdGenerator::GetNextSequenceId()) {
-  auto message_pump =
-      std::make_shared<MessagePumpImpl>(kMainThreadExecutorCount);
+  message_pump_ = MakeRefCounted<MessagePumpImpl>(kMainThreadExecutorCount);
   message_loop_ = std::make_shared<MessageLoopImpl>(kMainThreadExecutorId,
-                                                    message_pump, false);
+                                                    message_pump_, false);
 
-  std::weak_ptr<MessagePump> weak_message_pump = message_pump;
   task_runner_ = SingleThreadTaskRunnerImpl::Create(
-      weak_message_pump, sequence_id_, kMainThreadExecutorId,
+      message_pump_, sequence_id_, kMainThreadExecutorId,
       DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
 
   scoped_sequence_id_ =
       std::make_unique<detail::ScopedSequenceIdSetter>(sequence_id_);
   scoped_task_runner_handle_ =
       std::make_unique<SequencedTaskRunnerHandle>(task_runner_);
+  scoped_sequence_local_storage_ =
+      std::make_unique<detail::ScopedSequenceLocalStorageMapSetter>(
+          *task_runner_->GetSequenceLocalStorageMap());
 }
 
 RunLoop::~RunLoop() {
   Quit();
+  message_pump_->DropPendingTasks();
+  scoped_sequence_local_storage_.reset();
 }
 
-std::shared_ptr<SingleThreadTaskRunner> RunLoop::TaskRunner() {
+scoped_refptr<SingleThreadTaskRunner> RunLoop::TaskRunner() {
   return task_runner_;
 }
 
@@ -66,7 +69,7 @@ RepeatingClosure RunLoop::QuitClosure() {
       [](std::shared_ptr<MessageLoop> message_loop,
          std::optional<SequenceId> sequence_id,
          std::optional<MessagePump::ExecutorId> allowed_executor_id,
-         std::weak_ptr<SequencedTaskRunner> target_task_runner) {
+         scoped_refptr<SequencedTaskRunner> target_task_runner) {
         message_loop->Stop(MessagePump::PendingTask{OnceClosure{}, sequence_id,
                                                     allowed_executor_id,
                                                     target_task_runner});
@@ -79,7 +82,7 @@ base::RepeatingCallback<void(base::OnceClosure)> RunLoop::QuitCallback() {
       [](std::shared_ptr<MessageLoop> message_loop,
          std::optional<SequenceId> sequence_id,
          std::optional<MessagePump::ExecutorId> allowed_executor_id,
-         std::weak_ptr<SequencedTaskRunner> target_task_runner,
+         scoped_refptr<SequencedTaskRunner> target_task_runner,
          OnceClosure task) {
         message_loop->Stop(
             MessagePump::PendingTask{std::move(task), sequence_id,
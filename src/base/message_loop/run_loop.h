@@ -3,6 +3,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/sequenced_task_runner_helpers.h"
 #include "base/single_thread_task_runner.h"
+#include "base/threading/sequence_local_storage_map.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 
 namespace base {
@@ -12,7 +13,7 @@ class RunLoop {
   RunLoop();
   ~RunLoop();
 
-  std::shared_ptr<SingleThreadTaskRunner> TaskRunner();
+  scoped_refptr<SingleThreadTaskRunner> TaskRunner();
 
   void RunOnce();
   void RunUntilIdle();
@@ -26,10 +27,13 @@ class RunLoop {
  protected:
   std::unique_ptr<detail::ScopedSequenceIdSetter> scoped_sequence_id_;
   std::unique_ptr<SequencedTaskRunnerHandle> scoped_task_runner_handle_;
+  std::unique_ptr<detail::ScopedSequenceLocalStorageMapSetter>
+      scoped_sequence_local_storage_;
 
   SequenceId sequence_id_;
-  std::shared_ptr<SingleThreadTaskRunner> task_runner_;
+  scoped_refptr<SingleThreadTaskRunner> task_runner_;
 
+  scoped_refptr<MessagePump> message_pump_;
   std::shared_ptr<MessageLoop> message_loop_;
 };
 
@@ -82,14 +82,16 @@ WinMessageLoopAttachment::TryCreate() {
 WinMessageLoopAttachment::WinMessageLoopAttachment(HWND hWnd)
     : hWnd_(hWnd),
       sequence_id_(base::detail::SequenceIdGenerator::GetNextSequenceId()),
-      message_pump_(std::make_shared<detail::WinMessagePumpImpl>(1, hWnd_)),
+      message_pump_(MakeRefCounted<detail::WinMessagePumpImpl>(1, hWnd_)),
       task_runner_(SingleThreadTaskRunnerImpl::Create(
           message_pump_,
           sequence_id_,
           0,
           DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance())),
       scoped_sequence_id_(sequence_id_),
-      scoped_task_runner_handle_(task_runner_) {
+      scoped_task_runner_handle_(task_runner_),
+      scoped_sequence_local_storage_(
+          *task_runner_->GetSequenceLocalStorageMap()) {
   DCHECK_EQ(g_current_instance, nullptr);
   g_current_instance = this;
 }
@@ -99,10 +101,11 @@ WinMessageLoopAttachment::~WinMessageLoopAttachment() {
   g_current_instance = nullptr;
 
   message_pump_->Stop({});
+  message_pump_->DropPendingTasks();
   DestroyWindow(hWnd_);
 }
 
-std::shared_ptr<SingleThreadTaskRunner> WinMessageLoopAttachment::TaskRunner()
+scoped_refptr<SingleThreadTaskRunner> WinMessageLoopAttachment::TaskRunner()
     const {
   return task_runner_;
 }
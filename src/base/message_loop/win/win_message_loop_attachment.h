@@ -10,6 +10,7 @@
 #include "base/sequenced_task_runner_helpers.h"
 #include "base/single_thread_task_runner.h"
 #include "base/threading/delayed_task_manager_shared_instance.h"
+#include "base/threading/sequence_local_storage_map.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 
 namespace base {
@@ -22,7 +23,7 @@ class WinMessageLoopAttachment {
  public:
   ~WinMessageLoopAttachment();
 
-  std::shared_ptr<SingleThreadTaskRunner> TaskRunner() const;
+  scoped_refptr<SingleThreadTaskRunner> TaskRunner() const;
 
  private:
   WinMessageLoopAttachment(HWND hWnd);
@@ -34,10 +35,12 @@ class WinMessageLoopAttachment {
 
   HWND hWnd_;
   SequenceId sequence_id_;
-  std::shared_ptr<MessagePump> message_pump_;
-  std::shared_ptr<SingleThreadTaskRunner> task_runner_;
+  scoped_refptr<MessagePump> message_pump_;
+  scoped_refptr<SingleThreadTaskRunner> task_runner_;
   base::detail::ScopedSequenceIdSetter scoped_sequence_id_;
   SequencedTaskRunnerHandle scoped_task_runner_handle_;
+  base::detail::ScopedSequenceLocalStorageMapSetter
+      scoped_sequence_local_storage_;
 };
 
 }  // namespace win
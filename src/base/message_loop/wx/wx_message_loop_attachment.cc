@@ -1,6 +1,8 @@
 #include "base/message_loop/wx/wx_message_loop_attachment.h"
 
-#include <atomic>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #include "base/threading/delayed_task_manager_shared_instance.h"
 #include "base/threading/task_runner_impl.h"
@@ -12,6 +14,60 @@ namespace wx {
 
 namespace detail {
 
+//
+// WxMessagePumpImpl
+//
+
+// Tasks are owned by the pump until wx delivers their events, so that they
+// can be dropped when the attachment is destroyed.
+class WxMessagePumpImpl : public MessagePump {
+ public:
+  WxMessagePumpImpl(wxEvtHandler* event_handler)
+      : event_handler_(event_handler), is_stopped_(false), next_task_id_(0) {}
+
+  PendingTask GetNextPendingTask(ExecutorId, bool) override {
+    DCHECK(false) << "This method should not be called";
+    return {};
+  }
+
+  bool QueuePendingTask(PendingTask pending_task) override;
+
+  void Stop(PendingTask last_task) override {
+    QueuePendingTask(std::move(last_task));
+    std::lock_guard<std::mutex> guard{mutex_};
+    is_stopped_ = true;
+  }
+
+  void DropPendingTasks() override {
+    std::unordered_map<uint64_t, PendingTask> pending_tasks;
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      pending_tasks.swap(pending_tasks_);
+    }
+    // Tasks are destroyed here, outside of the lock.
+  }
+
+  // Returns the task queued with |task_id|, unless it was already taken or
+  // dropped.
+  std::optional<PendingTask> TakePendingTask(uint64_t task_id) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    auto task_iter = pending_tasks_.find(task_id);
+    if (task_iter == pending_tasks_.end()) {
+      return std::nullopt;
+    }
+    PendingTask pending_task = std::move(task_iter->second);
+    pending_tasks_.erase(task_iter);
+    return pending_task;
+  }
+
+ private:
+  wxEvtHandler* event_handler_;
+  std::mutex mutex_;
+  bool is_stopped_;
+  uint64_t next_task_id_;
+  std::unordered_map<uint64_t, PendingTask> pending_tasks_;
+};
+
 //
 // WxExecuteTaskEvent
 //
@@ -21,16 +77,27 @@ wxDECLARE_EVENT(wxEVT_LIBBASE_EXECUTE_TASK, WxExecuteTaskEvent);
 
 class WxExecuteTaskEvent : public wxCommandEvent {
  public:
-  WxExecuteTaskEvent(std::shared_ptr<MessagePump::PendingTask> pending_task,
+  WxExecuteTaskEvent(scoped_refptr<WxMessagePumpImpl> message_pump,
+                     uint64_t task_id,
                      wxEventType eventType = wxEVT_LIBBASE_EXECUTE_TASK)
-      : wxCommandEvent(eventType), pending_task_(std::move(pending_task)) {}
+      : wxCommandEvent(eventType),
+        message_pump_(std::move(message_pump)),
+        task_id_(task_id) {}
 
   WxExecuteTaskEvent(const WxExecuteTaskEvent& other)
-      : WxExecuteTaskEvent(other.pending_task_, other.GetEventType()) {}
+      : WxExecuteTaskEvent(other.message_pump_,
+                           other.task_id_,
+                           other.GetEventType()) {}
 
   wxEvent* Clone() const override { return new WxExecuteTaskEvent(*this); }
 
-  std::shared_ptr<MessagePump::PendingTask> pending_task_;
+  std::optional<MessagePump::PendingTask> TakePendingTask() const {
+    return message_pump_->TakePendingTask(task_id_);
+  }
+
+ private:
+  scoped_refptr<WxMessagePumpImpl> message_pump_;
+  uint64_t task_id_;
 };
 
 using MyWxExecuteTaskEventFunction =
@@ -40,39 +107,21 @@ using MyWxExecuteTaskEventFunction =
 
 wxDEFINE_EVENT(wxEVT_LIBBASE_EXECUTE_TASK, WxExecuteTaskEvent);
 
-//
-// WxMessagePumpImpl
-//
-
-class WxMessagePumpImpl : public MessagePump {
- public:
-  WxMessagePumpImpl(wxEvtHandler* event_handler)
-      : event_handler_(event_handler), is_stopped_(false) {}
-
-  PendingTask GetNextPendingTask(ExecutorId, bool) override {
-    DCHECK(false) << "This method should not be called";
-    return {};
-  }
-
-  bool QueuePendingTask(PendingTask pending_task) override {
-    if (!is_stopped_) {
-      wxPostEvent(event_handler_,
-                  WxExecuteTaskEvent(std::make_shared<MessagePump::PendingTask>(
-                      std::move(pending_task))));
-      return true;
+bool WxMessagePumpImpl::QueuePendingTask(PendingTask pending_task) {
+  uint64_t task_id;
+  {
+    std::lock_guard<std::mutex> guard{mutex_};
+    if (is_stopped_) {
+      return false;
     }
-    return false;
+    task_id = next_task_id_++;
+    pending_tasks_.emplace(task_id, std::move(pending_task));
   }
 
-  void Stop(PendingTask last_task) override {
-    QueuePendingTask(std::move(last_task));
-    is_stopped_ = true;
-  }
-
- private:
-  wxEvtHandler* event_handler_;
-  std::atomic_bool is_stopped_;
-};
+  wxPostEvent(event_handler_,
+              WxExecuteTaskEvent(WrapRefCounted(this), task_id));
+  return true;
+}
 
 }  // namespace detail
 
@@ -84,14 +133,16 @@ WxMessageLoopAttachment::WxMessageLoopAttachment(wxEvtHandler* event_handler)
     : event_handler_(event_handler),
       sequence_id_(base::detail::SequenceIdGenerator::GetNextSequenceId()),
       message_pump_(
-          std::make_shared<detail::WxMessagePumpImpl>(event_handler_)),
+          MakeRefCounted<detail::WxMessagePumpImpl>(event_handler_)),
       task_runner_(SingleThreadTaskRunnerImpl::Create(
           message_pump_,
           sequence_id_,
           0,
           DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance())),
       scoped_sequence_id_(sequence_id_),
-      scoped_task_runner_handle_(task_runner_) {
+      scoped_task_runner_handle_(task_runner_),
+      scoped_sequence_local_storage_(
+          *task_runner_->GetSequenceLocalStorageMap()) {
   DCHECK(event_handler_);
 
   BindEventHandling();
@@ -100,9 +151,12 @@ WxMessageLoopAttachment::WxMessageLoopAttachment(wxEvtHandler* event_handler)
 WxMessageLoopAttachment::~WxMessageLoopAttachment() {
   UnbindEventHandling();
   message_pump_->Stop({});
+  // Events that were not delivered yet would otherwise keep the tasks (and
+  // their task runners, which reference the pump) alive.
+  message_pump_->DropPendingTasks();
 }
 
-std::shared_ptr<SingleThreadTaskRunner> WxMessageLoopAttachment::TaskRunner()
+scoped_refptr<SingleThreadTaskRunner> WxMessageLoopAttachment::TaskRunner()
     const {
   return task_runner_;
 }
@@ -112,8 +166,8 @@ void WxMessageLoopAttachment::HandleExecuteTaskEvent(
     detail::WxExecuteTaskEvent& event) {
   // We don't have to set scoped sequence id/task runner handle here as this is
   // handled by the lifetime of owned object.
-  if (event.pending_task_) {
-    std::move(event.pending_task_->task).Run();
+  if (auto pending_task = event.TakePendingTask()) {
+    std::move(pending_task->task).Run();
   }
 }
 
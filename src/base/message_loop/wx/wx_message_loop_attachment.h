@@ -7,6 +7,7 @@
 #include "base/message_loop/message_pump.h"
 #include "base/sequence_id.h"
 #include "base/single_thread_task_runner.h"
+#include "base/threading/sequence_local_storage_map.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 
 class wxEvtHandler;
@@ -23,7 +24,7 @@ class WxMessageLoopAttachment {
   WxMessageLoopAttachment(wxEvtHandler* event_handler);
   ~WxMessageLoopAttachment();
 
-  std::shared_ptr<SingleThreadTaskRunner> TaskRunner() const;
+  scoped_refptr<SingleThreadTaskRunner> TaskRunner() const;
 
  private:
   static void HandleExecuteTaskEvent(detail::WxExecuteTaskEvent& event);
@@ -33,10 +34,12 @@ class WxMessageLoopAttachment {
 
   wxEvtHandler* event_handler_;
   SequenceId sequence_id_;
-  std::shared_ptr<MessagePump> message_pump_;
-  std::shared_ptr<SingleThreadTaskRunner> task_runner_;
+  scoped_refptr<MessagePump> message_pump_;
+  scoped_refptr<SingleThreadTaskRunner> task_runner_;
   base::detail::ScopedSequenceIdSetter scoped_sequence_id_;
   SequencedTaskRunnerHandle scoped_task_runner_handle_;
+  base::detail::ScopedSequenceLocalStorageMapSetter
+      scoped_sequence_local_storage_;
 };
 
 }  // namespace wx
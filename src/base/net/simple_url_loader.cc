@@ -11,7 +11,7 @@ namespace net {
 namespace {
 SimpleUrlLoader::ResultCallback BindOnDoneCallback(
     SimpleUrlLoader::ResultCallback callback,
-    std::shared_ptr<TaskRunner> reply_task_runner) {
+    scoped_refptr<TaskRunner> reply_task_runner) {
   // TODO: Fix FROM_HERE usage here
   if (reply_task_runner) {
     return BindPostTask(std::move(reply_task_runner), std::move(callback),
@@ -24,7 +24,7 @@ SimpleUrlLoader::ResultCallback BindOnDoneCallback(
 RequestCancellationToken SimpleUrlLoader::DownloadUnbounded(
     ResourceRequest request,
     ResultCallback on_done_callback,
-    std::shared_ptr<TaskRunner> reply_task_runner) {
+    scoped_refptr<TaskRunner> reply_task_runner) {
   return NetThread::GetInstance().EnqueueDownload(
       request, std::nullopt,
       BindOnDoneCallback(std::move(on_done_callback),
@@ -35,7 +35,7 @@ RequestCancellationToken SimpleUrlLoader::DownloadLimited(
     ResourceRequest request,
     size_t max_response_size_bytes,
     ResultCallback on_done_callback,
-    std::shared_ptr<TaskRunner> reply_task_runner) {
+    scoped_refptr<TaskRunner> reply_task_runner) {
   return NetThread::GetInstance().EnqueueDownload(
       request, max_response_size_bytes,
       BindOnDoneCallback(std::move(on_done_callback),
@@ -18,12 +18,12 @@ class SimpleUrlLoader {
   static RequestCancellationToken DownloadUnbounded(
       ResourceRequest request,
       ResultCallback on_done_callback,
-      std::shared_ptr<TaskRunner> reply_task_runner = nullptr);
+      scoped_refptr<TaskRunner> reply_task_runner = nullptr);
   static RequestCancellationToken DownloadLimited(
       ResourceRequest request,
       size_t max_response_size_bytes,
       ResultCallback on_done_callback,
-      std::shared_ptr<TaskRunner> reply_task_runner = nullptr);
+      scoped_refptr<TaskRunner> reply_task_runner = nullptr);
 
   static void CancelRequest(RequestCancellationToken cancellation_token);
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 namespace base {
 
@@ -21,6 +22,7 @@ class SequenceId {
 
  private:
   friend class detail::SequenceIdGenerator;
+  friend struct std::hash<SequenceId>;
 
   explicit SequenceId(uint64_t id);
 
@@ -28,3 +30,14 @@ class SequenceId {
 };
 
 }  // namespace base
+
+namespace std {
+
+template <>
+struct hash<base::SequenceId> {
+  size_t operator()(const base::SequenceId& sequence_id) const {
+    return hash<uint64_t>{}(sequence_id.id_);
+  }
+};
+
+}  // namespace std
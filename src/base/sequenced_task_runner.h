@@ -6,6 +6,10 @@
 
 namespace base {
 
+namespace detail {
+class SequenceLocalStorageMap;
+}  // namespace detail
+
 class SequencedTaskRunner : public TaskRunner {
  public:
   // Returns true if:
@@ -15,6 +19,13 @@ class SequencedTaskRunner : public TaskRunner {
   // - this is a SingleThreadTaskRunner bound to the current thread.
   virtual bool RunsTasksInCurrentSequence() const = 0;
 
+  // Returns the storage of `SequenceLocalStorageSlot` values of this sequence
+  // which is made current while its tasks are run, or nullptr if the sequence
+  // has no such storage.
+  virtual detail::SequenceLocalStorageMap* GetSequenceLocalStorageMap() {
+    return nullptr;
+  }
+
   template <typename T>
   bool DeleteSoon(SourceLocation location, std::unique_ptr<T> object) {
     return PostTask(
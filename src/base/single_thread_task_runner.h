@@ -1,6 +1,9 @@
 #pragma once
 
+#include "base/callback.h"
 #include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_ticks.h"
 
 namespace base {
 
@@ -8,6 +11,15 @@ class SingleThreadTaskRunner : public SequencedTaskRunner {
  public:
   // Alias for `RunsTasksInCurrentSequence()`.
   bool BelongsToCurrentThread() const { return RunsTasksInCurrentSequence(); }
+
+  // Posts a task that will be run only when the thread has no other pending
+  // tasks. The task receives a deadline by which it should finish to avoid
+  // delaying other work (e.g. the next scheduled delayed task), so long
+  // running jobs should split their work and re-post themselves. Idle tasks
+  // are executed in the order they were posted. Returns false if the task
+  // could not be posted, e.g. because the thread is already stopping.
+  virtual bool PostIdleTask(SourceLocation location,
+                            OnceCallback<void(TimeTicks deadline)> task) = 0;
 };
 
 }  // namespace base
@@ -0,0 +1,102 @@
+#include "base/synchronization/async_lock.h"
+
+#include <optional>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace base {
+
+//
+// AsyncLock::Handle
+//
+
+AsyncLock::Handle::Handle(AsyncLock* lock) : lock_(lock) {}
+
+AsyncLock::Handle::~Handle() {
+  Release();
+}
+
+AsyncLock::Handle::Handle(Handle&& other) noexcept
+    : lock_(std::exchange(other.lock_, nullptr)) {}
+
+AsyncLock::Handle& AsyncLock::Handle::operator=(Handle&& other) noexcept {
+  if (&other != this) {
+    Release();
+    lock_ = std::exchange(other.lock_, nullptr);
+  }
+  return *this;
+}
+
+void AsyncLock::Handle::Release() {
+  if (lock_) {
+    std::exchange(lock_, nullptr)->Release();
+  }
+}
+
+//
+// AsyncLock
+//
+
+AsyncLock::AsyncLock() = default;
+
+AsyncLock::~AsyncLock() {
+  DCHECK(!is_locked_) << "AsyncLock destroyed while still being held";
+  DCHECK(waiters_.empty());
+}
+
+void AsyncLock::Acquire(SourceLocation location,
+                        OnceCallback<void(Handle)> callback) {
+  DCHECK(callback);
+
+  Waiter waiter{SequencedTaskRunnerHandle::Get(), std::move(callback),
+                std::move(location)};
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (is_locked_) {
+      waiters_.push_back(std::move(waiter));
+      return;
+    }
+    is_locked_ = true;
+  }
+
+  Grant(std::move(waiter));
+}
+
+bool AsyncLock::IsLockedForTesting() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return is_locked_;
+}
+
+size_t AsyncLock::WaitersCountForTesting() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return waiters_.size();
+}
+
+void AsyncLock::Grant(Waiter waiter) {
+  // If the task is dropped, the handle bound to it releases the lock.
+  waiter.task_runner->PostTask(
+      std::move(waiter.location),
+      BindOnce(std::move(waiter.callback), Handle{this}));
+}
+
+void AsyncLock::Release() {
+  std::optional<Waiter> next_waiter;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    DCHECK(is_locked_);
+    if (waiters_.empty()) {
+      is_locked_ = false;
+      return;
+    }
+    next_waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+  }
+
+  // The lock stays held and is handed over to the next waiter.
+  Grant(std::move(*next_waiter));
+}
+
+}  // namespace base
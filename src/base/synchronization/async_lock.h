@@ -0,0 +1,88 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+
+namespace base {
+
+// Mutual exclusion between sequences that never blocks a thread. Instead of
+// waiting for the lock, `Acquire()` queues given callback which is posted to
+// the caller's sequence once the lock is granted to it. The callback receives
+// a `Handle` which keeps the lock held until it's released or destroyed, so
+// the lock can also be held across multiple tasks.
+//
+// void Foo::UpdateResource() {
+//   lock_->Acquire(FROM_HERE, base::BindOnce(&Foo::UpdateResourceLocked,
+//                                            weak_factory_.GetWeakPtr()));
+// }
+//
+// void Foo::UpdateResourceLocked(base::AsyncLock::Handle handle) {
+//   // Exclusive access to the resource until |handle| is destroyed.
+// }
+//
+// The lock is granted in the order in which it was requested. It must outlive
+// all of its handles and pending `Acquire()` calls.
+class AsyncLock {
+ public:
+  class Handle {
+   public:
+    Handle() = default;
+    ~Handle();
+
+    Handle(Handle&& other) noexcept;
+    Handle& operator=(Handle&& other) noexcept;
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    bool is_held() const { return lock_ != nullptr; }
+    explicit operator bool() const { return is_held(); }
+
+    // Releases the lock (if still held), granting it to the next waiting
+    // caller.
+    void Release();
+
+   private:
+    friend class AsyncLock;
+
+    explicit Handle(AsyncLock* lock);
+
+    AsyncLock* lock_ = nullptr;
+  };
+
+  AsyncLock();
+  ~AsyncLock();
+
+  AsyncLock(const AsyncLock&) = delete;
+  AsyncLock& operator=(const AsyncLock&) = delete;
+
+  // Posts |callback| (from |location|) to the current sequence once the lock
+  // is granted to it. The callback is always posted, even if the lock is free
+  // right away. If the task cannot be run (e.g. because the sequence is being
+  // destroyed), the lock is released and granted to the next caller.
+  void Acquire(SourceLocation location, OnceCallback<void(Handle)> callback);
+
+  bool IsLockedForTesting();
+  size_t WaitersCountForTesting();
+
+ private:
+  struct Waiter {
+    scoped_refptr<SequencedTaskRunner> task_runner;
+    OnceCallback<void(Handle)> callback;
+    SourceLocation location;
+  };
+
+  void Grant(Waiter waiter);
+  void Release();
+
+  std::mutex mutex_;
+  bool is_locked_ = false;
+  std::deque<Waiter> waiters_;
+};
+
+}  // namespace base
@@ -4,6 +4,7 @@
 #include "base/bind_post_task.h"
 #include "base/logging.h"
 #include "base/sequenced_task_runner.h"
+#include "base/threading/dropped_task_counters.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 
 namespace base {
@@ -32,7 +33,7 @@ class PostTaskAndReplyHelper {
       SourceLocation location,
       OnceClosure task,
       OnceClosure reply,
-      std::shared_ptr<SequencedTaskRunner> original_task_runner)
+      scoped_refptr<SequencedTaskRunner> original_task_runner)
       : location_(std::move(location)),
         task_(std::move(task)),
         reply_(std::move(reply)),
@@ -53,17 +54,74 @@ class PostTaskAndReplyHelper {
   SourceLocation location_;
   OnceClosure task_;
   OnceClosure reply_;
-  std::shared_ptr<SequencedTaskRunner> original_task_runner_;
+  scoped_refptr<SequencedTaskRunner> original_task_runner_;
 };
 #endif  // LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
 
+void RunTaskIfNotExpired(SourceLocation location,
+                         TimeTicks expiration_time,
+                         OnceClosure task,
+                         OnceClosure on_dropped) {
+  if (expiration_time <= TimeTicks::Now()) {
+    DroppedTaskCounters::RecordDroppedTask(location);
+    task = OnceClosure{};
+    if (on_dropped) {
+      std::move(on_dropped).Run();
+    }
+    return;
+  }
+  std::move(task).Run();
+}
+
 }  // namespace
 
+namespace detail {
+
+scoped_refptr<TaskRunner> GetReplyTaskRunner() {
+  DCHECK(SequencedTaskRunnerHandle::IsSet());
+  return SequencedTaskRunnerHandle::Get();
+}
+
+bool PostReplyTask(TaskRunner& reply_task_runner,
+                   SourceLocation location,
+                   OnceClosure reply) {
+  return reply_task_runner.PostTask(location, std::move(reply));
+}
+
+#ifdef LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+bool RunsTasksInCurrentSequence(TaskRunner& reply_task_runner) {
+  return static_cast<SequencedTaskRunner&>(reply_task_runner)
+      .RunsTasksInCurrentSequence();
+}
+#endif  // LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+
+}  // namespace detail
+
 bool TaskRunner::PostTask(SourceLocation location, OnceClosure task) {
   const auto kNoDelay = base::TimeDelta{};
   return PostDelayedTask(std::move(location), std::move(task), kNoDelay);
 }
 
+bool TaskRunner::PostTaskWithExpiry(SourceLocation location,
+                                    OnceClosure task,
+                                    TimeTicks expiration_time,
+                                    OnceClosure on_dropped) {
+  // Task runners that can't drop expired tasks before they are dequeued check
+  // the expiration time right before running them.
+  return PostTask(location,
+                  BindOnce(&RunTaskIfNotExpired, location, expiration_time,
+                           std::move(task), std::move(on_dropped)));
+}
+
+bool TaskRunner::PostTaskWithMaxQueueingDelay(SourceLocation location,
+                                              OnceClosure task,
+                                              TimeDelta max_queueing_delay,
+                                              OnceClosure on_dropped) {
+  return PostTaskWithExpiry(std::move(location), std::move(task),
+                            TimeTicks::Now() + max_queueing_delay,
+                            std::move(on_dropped));
+}
+
 bool TaskRunner::PostTaskAndReply(SourceLocation location,
                                   OnceClosure task,
                                   OnceClosure reply) {
@@ -3,13 +3,15 @@
 #include <optional>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/source_location.h"
 #include "base/task_runner_internals.h"
 #include "base/time/time_delta.h"
+#include "base/time/time_ticks.h"
 
 namespace base {
 
-class TaskRunner {
+class TaskRunner : public RefCountedThreadSafe<TaskRunner> {
  public:
   virtual ~TaskRunner() = default;
 
@@ -19,6 +21,22 @@ class TaskRunner {
                                OnceClosure task,
                                TimeDelta delay) = 0;
 
+  // Posts a task that will be dropped without being run if it is not started
+  // before |expiration_time| (e.g. because of a long backlog of other tasks).
+  // If set, |on_dropped| is executed instead of the dropped task. Dropped
+  // tasks are counted in `DroppedTaskCounters`.
+  virtual bool PostTaskWithExpiry(SourceLocation location,
+                                  OnceClosure task,
+                                  TimeTicks expiration_time,
+                                  OnceClosure on_dropped);
+
+  // Same as above, but the task expires if it waits longer than
+  // |max_queueing_delay| to be started.
+  bool PostTaskWithMaxQueueingDelay(SourceLocation location,
+                                    OnceClosure task,
+                                    TimeDelta max_queueing_delay,
+                                    OnceClosure on_dropped = {});
+
   bool PostTaskAndReply(SourceLocation location,
                         OnceClosure task,
                         OnceClosure reply);
@@ -32,18 +50,13 @@ class TaskRunner {
   bool PostTaskAndReplyWithResult(SourceLocation location,
                                   TaskCallback<TaskResult()> task,
                                   ReplyCallback<void(ReplyArgument)> reply) {
-    using Helper = detail::PostTaskAndReplyWithResultHelper<
+    using StateType = detail::PostTaskAndReplyWithResultState<
         TaskResult, TaskCallback<TaskResult()>,
         ReplyCallback<void(ReplyArgument)>>;
 
-    auto helper = std::make_unique<Helper>();
-    auto* helper_ptr = helper.get();
-
-    return PostTaskAndReply(location,
-                            BindOnce(&Helper::ExecuteTaskAndStoreResultIn,
-                                     std::move(task), helper_ptr),
-                            BindOnce(&Helper::ExecuteReplyWithTaskResult,
-                                     std::move(reply), std::move(helper)));
+    return PostTask(location,
+                    StateType::CreateTask(location, std::move(task),
+                                          std::move(reply)));
   }
 };
 
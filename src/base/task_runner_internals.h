@@ -2,28 +2,126 @@
 
 #include <memory>
 #include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "base/callback.h"
+#include "base/callback_iface.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/source_location.h"
 
 namespace base {
+
+class TaskRunner;
+
 namespace detail {
 
+// Returns task runner of the current sequence, to which replies are posted.
+scoped_refptr<TaskRunner> GetReplyTaskRunner();
+
+// Defined out-of-line, as `TaskRunner` is incomplete here.
+bool PostReplyTask(TaskRunner& reply_task_runner,
+                   SourceLocation location,
+                   OnceClosure reply);
+
+#ifdef LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+// |reply_task_runner| must be the one returned from `GetReplyTaskRunner()`.
+bool RunsTasksInCurrentSequence(TaskRunner& reply_task_runner);
+#endif  // LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+
+// Shared by the task and the reply posted by
+// `TaskRunner::PostTaskAndReplyWithResult()`.
+template <typename TaskResult, typename TaskCallback, typename ReplyCallback>
+struct PostTaskAndReplyWithResultData {
+  PostTaskAndReplyWithResultData(SourceLocation location_,
+                                 TaskCallback task_,
+                                 ReplyCallback reply_,
+                                 scoped_refptr<TaskRunner> reply_task_runner_)
+      : location(location_),
+        task(std::move(task_)),
+        reply(std::move(reply_)),
+        reply_task_runner(std::move(reply_task_runner_)) {}
+
+#ifdef LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+  ~PostTaskAndReplyWithResultData() {
+    if (reply && !RunsTasksInCurrentSequence(*reply_task_runner)) {
+      // Leak reply callback to avoid hitting (D)CHECKs for sequence affinity
+      (void)std::make_unique<ReplyCallback>(std::move(reply)).release();
+    }
+  }
+#endif  // LIBBASE_POLICY_LEAK_ON_REPLY_POST_TASK_FAILURE
+
+  SourceLocation location;
+  TaskCallback task;
+  ReplyCallback reply;
+  scoped_refptr<TaskRunner> reply_task_runner;
+  std::optional<TaskResult> result;
+};
+
+// Callback state of both the task and the reply posted by
+// `TaskRunner::PostTaskAndReplyWithResult()`. Task, reply and the task's
+// result are kept in a single allocation which is handed over from the task to
+// the reply, so no other allocations are needed (besides the queues' ones).
 template <typename TaskResult, typename TaskCallback, typename ReplyCallback>
-class PostTaskAndReplyWithResultHelper {
+class PostTaskAndReplyWithResultState {
  public:
-  static void ExecuteTaskAndStoreResultIn(
-      TaskCallback task,
-      PostTaskAndReplyWithResultHelper* helper) {
-    helper->result = std::move(task).Run();
+  using Data =
+      PostTaskAndReplyWithResultData<TaskResult, TaskCallback, ReplyCallback>;
+
+  static OnceClosure CreateTask(SourceLocation location,
+                                TaskCallback task,
+                                ReplyCallback reply) {
+    return BindAccessHelper::Create<OnceClosure,
+                                    PostTaskAndReplyWithResultState, false>(
+        CallbackStorage::New<Data>(location, std::move(task), std::move(reply),
+                                   GetReplyTaskRunner()));
+  }
+
+  explicit PostTaskAndReplyWithResultState(Data* data) : data_(data) {}
+
+  PostTaskAndReplyWithResultState(
+      PostTaskAndReplyWithResultState&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)) {}
+
+  PostTaskAndReplyWithResultState& operator=(
+      PostTaskAndReplyWithResultState&&) = delete;
+
+  ~PostTaskAndReplyWithResultState() {
+    if (data_) {
+      CallbackStorage::Delete(data_);
+    }
   }
 
-  static void ExecuteReplyWithTaskResult(
-      ReplyCallback reply,
-      std::unique_ptr<PostTaskAndReplyWithResultHelper> helper) {
-    std::move(reply).Run(std::move(*helper->result));
+  void RunOnce() {
+    if (!data_->result) {
+      ExecuteTaskAndPostReply();
+    } else {
+      std::move(data_->reply).Run(std::move(*data_->result));
+    }
   }
 
  private:
-  std::optional<TaskResult> result;
+  void ExecuteTaskAndPostReply() {
+    data_->result.emplace(std::move(data_->task).Run());
+
+    // The reply (and the whole state) may be destroyed by a failed post, so
+    // the task runner has to be kept alive until it returns.
+    const scoped_refptr<TaskRunner> reply_task_runner =
+        data_->reply_task_runner;
+    const SourceLocation location = data_->location;
+    OnceClosure reply_task =
+        BindAccessHelper::Create<OnceClosure, PostTaskAndReplyWithResultState,
+                                 false>(std::exchange(data_, nullptr));
+    PostReplyTask(*reply_task_runner, location, std::move(reply_task));
+  }
+
+  Data* data_;
 };
 
+template <typename TaskResult, typename TaskCallback, typename ReplyCallback>
+struct IsTriviallyRelocatable<
+    PostTaskAndReplyWithResultState<TaskResult, TaskCallback, ReplyCallback>>
+    : std::true_type {};
+
 }  // namespace detail
 }  // namespace base
@@ -0,0 +1,123 @@
+#include "base/test/task_environment.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/logging.h"
+#include "base/message_loop/message_pump_impl.h"
+#include "base/message_loop/run_loop.h"
+#include "base/threading/delayed_task_manager.h"
+#include "base/threading/delayed_task_manager_shared_instance.h"
+
+namespace base {
+namespace test {
+
+namespace {
+
+std::atomic<TimeTicks> g_mock_time_ticks;
+
+TimeTicks MockTimeTicksNow() {
+  return g_mock_time_ticks.load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+TaskEnvironment::TaskEnvironment(TimeSource time_source)
+    : time_source_(time_source) {
+  if (time_source_ == TimeSource::kMockTime) {
+    SetMockTime(subtle::TimeTicksNowIgnoringOverride());
+    time_clock_overrides_ =
+        std::make_unique<subtle::ScopedTimeClockOverrides>(&MockTimeTicksNow);
+
+    // Delayed tasks are scheduled only when virtual time is advanced.
+    delayed_task_manager_ = std::make_shared<DelayedTaskManager>(
+        &TimeTicks::Now, DelayedTaskManager::SchedulingMode::kManual);
+    previous_delayed_task_manager_ =
+        DelayedTaskManagerSharedInstance::SetSharedInstanceForTesting(
+            delayed_task_manager_);
+  } else {
+    delayed_task_manager_ =
+        DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance();
+  }
+
+  main_run_loop_ = std::make_unique<RunLoop>();
+}
+
+TaskEnvironment::~TaskEnvironment() {
+  main_run_loop_.reset();
+
+  if (time_source_ == TimeSource::kMockTime) {
+    DelayedTaskManagerSharedInstance::SetSharedInstanceForTesting(
+        previous_delayed_task_manager_);
+  }
+  delayed_task_manager_.reset();
+  time_clock_overrides_.reset();
+}
+
+scoped_refptr<SingleThreadTaskRunner>
+TaskEnvironment::GetMainThreadTaskRunner() {
+  return main_run_loop_->TaskRunner();
+}
+
+void TaskEnvironment::RunUntilIdle() {
+  while (true) {
+    main_run_loop_->RunUntilIdle();
+    delayed_task_manager_->ScheduleAllReadyTasksForTests();
+
+    // Blocks while other threads are running their tasks. Returns early if
+    // there are new tasks for the main thread (or for other idle threads),
+    // which will be run (or waited for) in the next iteration.
+    if (MessagePumpImpl::WaitForAllPumpsIdleForTesting()) {
+      return;
+    }
+  }
+}
+
+void TaskEnvironment::FastForwardBy(TimeDelta delta) {
+  DCHECK(time_source_ == TimeSource::kMockTime);
+  DCHECK(!delta.IsNegative());
+
+  const auto target_time = NowTicks() + delta;
+
+  RunUntilIdle();
+  while (const auto next_task_time =
+             delayed_task_manager_->NextDelayedTaskTime()) {
+    if (*next_task_time > target_time) {
+      break;
+    }
+    SetMockTime(std::max(*next_task_time, NowTicks()));
+    RunUntilIdle();
+  }
+
+  SetMockTime(target_time);
+  RunUntilIdle();
+}
+
+void TaskEnvironment::FastForwardUntilNoTasksRemain() {
+  DCHECK(time_source_ == TimeSource::kMockTime);
+
+  RunUntilIdle();
+  while (const auto next_task_time =
+             delayed_task_manager_->NextDelayedTaskTime()) {
+    SetMockTime(std::max(*next_task_time, NowTicks()));
+    RunUntilIdle();
+  }
+}
+
+void TaskEnvironment::AdvanceClock(TimeDelta delta) {
+  DCHECK(time_source_ == TimeSource::kMockTime);
+  DCHECK(!delta.IsNegative());
+
+  SetMockTime(NowTicks() + delta);
+}
+
+TimeTicks TaskEnvironment::NowTicks() const {
+  return TimeTicks::Now();
+}
+
+void TaskEnvironment::SetMockTime(TimeTicks now) {
+  g_mock_time_ticks.store(now, std::memory_order_relaxed);
+}
+
+}  // namespace test
+}  // namespace base
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+
+#include "base/single_thread_task_runner.h"
+#include "base/time/time_delta.h"
+#include "base/time/time_override.h"
+#include "base/time/time_ticks.h"
+
+namespace base {
+
+class DelayedTaskManager;
+class RunLoop;
+
+namespace test {
+
+// Sets up the environment for tests that post tasks. It provides a task runner
+// for the main (test's) thread and allows to run tasks posted to it and to all
+// `base::Thread` and `base::ThreadPool` instances created while the
+// environment is alive until all of them become idle.
+//
+// With `TimeSource::kMockTime`, `TimeTicks::Now()` returns virtual time that
+// does not move on its own. Delayed tasks become ready only when the virtual
+// time is advanced with `FastForwardBy()` (or similar), which happens
+// instantly, so tests of timeouts don't have to actually wait for them.
+//
+// The environment must be created before any threads or task runners used by
+// the test and only one environment can exist at a time. Other `RunLoop`s can
+// not be used while the environment is alive.
+class TaskEnvironment {
+ public:
+  enum class TimeSource {
+    kSystemTime,
+    kMockTime,
+  };
+
+  explicit TaskEnvironment(TimeSource time_source = TimeSource::kSystemTime);
+  ~TaskEnvironment();
+
+  TaskEnvironment(const TaskEnvironment&) = delete;
+  TaskEnvironment& operator=(const TaskEnvironment&) = delete;
+
+  scoped_refptr<SingleThreadTaskRunner> GetMainThreadTaskRunner();
+
+  // Runs tasks on the main thread and waits for all other threads until there
+  // are no more tasks that are ready to be executed. Doesn't advance time.
+  void RunUntilIdle();
+
+  // Advances virtual time by |delta|, running all the tasks (including delayed
+  // ones) that become ready on the way. Delayed tasks are run when the virtual
+  // time reaches their scheduled time. Requires `TimeSource::kMockTime`.
+  void FastForwardBy(TimeDelta delta);
+
+  // Advances virtual time until there are no more delayed tasks. Must not be
+  // used when there are tasks that keep re-posting themselves (e.g. running
+  // `base::RepeatingTimer`). Requires `TimeSource::kMockTime`.
+  void FastForwardUntilNoTasksRemain();
+
+  // Advances virtual time by |delta| without running any tasks. Requires
+  // `TimeSource::kMockTime`.
+  void AdvanceClock(TimeDelta delta);
+
+  TimeTicks NowTicks() const;
+
+ private:
+  void SetMockTime(TimeTicks now);
+
+  const TimeSource time_source_;
+  std::unique_ptr<subtle::ScopedTimeClockOverrides> time_clock_overrides_;
+  std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
+  std::weak_ptr<DelayedTaskManager> previous_delayed_task_manager_;
+  std::unique_ptr<RunLoop> main_run_loop_;
+};
+
+}  // namespace test
+}  // namespace base
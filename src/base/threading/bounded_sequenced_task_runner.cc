@@ -0,0 +1,127 @@
+#include "base/threading/bounded_sequenced_task_runner.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace base {
+
+// static
+scoped_refptr<BoundedSequencedTaskRunner> BoundedSequencedTaskRunner::Create(
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    size_t capacity,
+    OverflowPolicy overflow_policy) {
+  return WrapRefCounted(new BoundedSequencedTaskRunner(
+      std::move(task_runner), capacity, overflow_policy));
+}
+
+bool BoundedSequencedTaskRunner::TryPostTask(SourceLocation location,
+                                             OnceClosure& task,
+                                             OnceClosure on_space_available) {
+  DCHECK(task);
+  DCHECK(on_space_available);
+  // Checked upfront, as the current sequence is needed only under overload.
+  DCHECK(SequencedTaskRunnerHandle::IsSet());
+
+  // Replaced notification is destroyed without the lock held.
+  OnceClosure replaced_on_space_available;
+  bool should_schedule_run = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (pending_tasks_.size() >= capacity_) {
+      const scoped_refptr<SequencedTaskRunner>& reply_task_runner =
+          SequencedTaskRunnerHandle::Get();
+      auto waiter_iter = std::find_if(
+          space_waiters_.begin(), space_waiters_.end(),
+          [&](const SpaceWaiter& space_waiter) {
+            return space_waiter.reply_task_runner == reply_task_runner;
+          });
+      if (waiter_iter == space_waiters_.end()) {
+        space_waiters_.push_back({std::move(on_space_available),
+                                  reply_task_runner, std::move(location)});
+      } else {
+        replaced_on_space_available =
+            std::exchange(waiter_iter->on_space_available,
+                          std::move(on_space_available));
+        waiter_iter->location = std::move(location);
+      }
+      return false;
+    }
+    PushTask_Locked(std::move(task));
+    should_schedule_run = ShouldScheduleRun_Locked();
+  }
+
+  return !should_schedule_run || ScheduleRun();
+}
+
+size_t BoundedSequencedTaskRunner::GetQueueDepth() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return pending_tasks_.size();
+}
+
+size_t BoundedSequencedTaskRunner::GetMaxQueueDepth() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return max_queue_depth_;
+}
+
+uint64_t BoundedSequencedTaskRunner::GetRejectedTasksCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return rejected_tasks_count_;
+}
+
+uint64_t BoundedSequencedTaskRunner::GetDroppedTasksCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return dropped_tasks_count_;
+}
+
+BoundedSequencedTaskRunner::BoundedSequencedTaskRunner(
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    size_t capacity,
+    OverflowPolicy overflow_policy)
+    : SerialSequencedTaskRunner(std::move(task_runner)),
+      capacity_(capacity),
+      overflow_policy_(overflow_policy) {
+  DCHECK_GT(capacity_, 0u);
+}
+
+bool BoundedSequencedTaskRunner::QueueTask_Locked(OnceClosure& task,
+                                                  OnceClosure& dropped_task) {
+  if (pending_tasks_.size() >= capacity_) {
+    if (overflow_policy_ == OverflowPolicy::kReject) {
+      ++rejected_tasks_count_;
+      return false;
+    }
+
+    dropped_task = std::move(pending_tasks_.front());
+    pending_tasks_.pop_front();
+    ++dropped_tasks_count_;
+  }
+
+  PushTask_Locked(std::move(task));
+  return true;
+}
+
+void BoundedSequencedTaskRunner::PushTask_Locked(OnceClosure task) {
+  pending_tasks_.push_back(std::move(task));
+  max_queue_depth_ = std::max(max_queue_depth_, pending_tasks_.size());
+}
+
+void BoundedSequencedTaskRunner::RunTask(OnceClosure task) {
+  // The task left the queue, so there is space for the waiting producers.
+  std::vector<SpaceWaiter> space_waiters;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    space_waiters.swap(space_waiters_);
+  }
+  for (SpaceWaiter& space_waiter : space_waiters) {
+    space_waiter.reply_task_runner->PostTask(
+        std::move(space_waiter.location),
+        std::move(space_waiter.on_space_available));
+  }
+
+  std::move(task).Run();
+}
+
+}  // namespace base
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/threading/serial_sequenced_task_runner.h"
+
+namespace base {
+
+// Sequenced task runner with a limited capacity of pending tasks, which runs
+// its tasks (in order) on top of another sequenced task runner. The tasks are
+// kept in its own queue and only one of them at a time is handed over to the
+// underlying task runner (see `detail::SerialSequencedTaskRunner`), so the
+// memory used by pending tasks stays bounded even if they are posted faster
+// than they can be executed.
+//
+// When the queue is full, `PostTask()` behaves according to given overflow
+// policy. Producers that should wait for space instead of losing tasks can use
+// `TryPostTask()`, which leaves the task with the producer and notifies it once
+// it can try again.
+//
+// Delayed tasks are kept by the underlying task runner until they are due and
+// only then are they queued (according to the overflow policy). Tasks dropped
+// because of an overflow are destroyed without being run, as are pending tasks
+// once the underlying task runner stops accepting tasks.
+class BoundedSequencedTaskRunner : public detail::SerialSequencedTaskRunner {
+ public:
+  enum class OverflowPolicy {
+    // Posting a task to a full queue fails.
+    kReject,
+    // The oldest pending task is dropped to make space for the new one.
+    kDropOldest,
+  };
+
+  static scoped_refptr<BoundedSequencedTaskRunner> Create(
+      scoped_refptr<SequencedTaskRunner> task_runner,
+      size_t capacity,
+      OverflowPolicy overflow_policy);
+
+  // Queues |task| if there is space for it (without dropping any other task).
+  // Otherwise |task| is left intact, false is returned and
+  // |on_space_available| is posted to the current sequence once a task leaves
+  // the queue, so that the producer can try again. Producers that wait for the
+  // notification are slowed down to the pace at which the tasks are executed.
+  // False (with |task| dropped) is also returned if the underlying task runner
+  // doesn't accept tasks anymore.
+  //
+  // Must be called from a sequence (see `SequencedTaskRunnerHandle`). Only the
+  // most recent notification of each sequence is kept, so retrying before
+  // being notified doesn't accumulate waiters.
+  bool TryPostTask(SourceLocation location,
+                   OnceClosure& task,
+                   OnceClosure on_space_available);
+
+  size_t GetCapacity() const { return capacity_; }
+
+  // Number of tasks that are currently waiting to be executed.
+  size_t GetQueueDepth();
+  // Highest number of tasks that were waiting to be executed at once.
+  size_t GetMaxQueueDepth();
+  // Number of tasks that were not posted because of a full queue.
+  uint64_t GetRejectedTasksCount();
+  // Number of pending tasks that were dropped to make space for new ones.
+  uint64_t GetDroppedTasksCount();
+
+ private:
+  struct SpaceWaiter {
+    OnceClosure on_space_available;
+    scoped_refptr<SequencedTaskRunner> reply_task_runner;
+    SourceLocation location;
+  };
+
+  BoundedSequencedTaskRunner(scoped_refptr<SequencedTaskRunner> task_runner,
+                             size_t capacity,
+                             OverflowPolicy overflow_policy);
+
+  // detail::SerialSequencedTaskRunner
+  bool QueueTask_Locked(OnceClosure& task, OnceClosure& dropped_task) override;
+  void RunTask(OnceClosure task) override;
+
+  void PushTask_Locked(OnceClosure task);
+
+  const size_t capacity_;
+  const OverflowPolicy overflow_policy_;
+
+  // Producers to notify once a task leaves the full queue (at most one per
+  // sequence). They keep their tasks, so only the notifications are held here.
+  std::vector<SpaceWaiter> space_waiters_;
+  size_t max_queue_depth_ = 0;
+  uint64_t rejected_tasks_count_ = 0;
+  uint64_t dropped_tasks_count_ = 0;
+};
+
+}  // namespace base
@@ -0,0 +1,99 @@
+#include "base/threading/budget_throttled_sequenced_task_runner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/trace_event/trace_counter.h"
+
+namespace base {
+
+// static
+scoped_refptr<BudgetThrottledSequencedTaskRunner>
+BudgetThrottledSequencedTaskRunner::Create(
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    double budget_ratio,
+    TimeDelta max_budget) {
+  return WrapRefCounted(new BudgetThrottledSequencedTaskRunner(
+      std::move(task_runner), budget_ratio, max_budget));
+}
+
+bool BudgetThrottledSequencedTaskRunner::IsThrottled() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return is_throttled_;
+}
+
+TimeDelta BudgetThrottledSequencedTaskRunner::GetRemainingBudget() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return budget_;
+}
+
+uint64_t BudgetThrottledSequencedTaskRunner::GetThrottledCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return throttled_count_;
+}
+
+BudgetThrottledSequencedTaskRunner::BudgetThrottledSequencedTaskRunner(
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    double budget_ratio,
+    TimeDelta max_budget)
+    : SerialSequencedTaskRunner(std::move(task_runner)),
+      budget_ratio_(budget_ratio),
+      max_budget_(max_budget),
+      budget_(max_budget),
+      last_refill_time_(TimeTicks::Now()) {
+  DCHECK_GT(budget_ratio_, 0.0);
+  DCHECK_LE(budget_ratio_, 1.0);
+  DCHECK(max_budget_.IsPositive());
+}
+
+TimeDelta BudgetThrottledSequencedTaskRunner::GetRunDelay_Locked() {
+  RefillBudget_Locked(TimeTicks::Now());
+  TimeDelta delay{};
+  if (budget_.IsNegative()) {
+    delay =
+        Microseconds(std::ceil(-budget_.InMicrosecondsF() / budget_ratio_));
+  }
+  SetThrottled_Locked(delay.IsPositive());
+  return delay;
+}
+
+void BudgetThrottledSequencedTaskRunner::OnTaskTaken_Locked() {
+  SetThrottled_Locked(false);
+}
+
+void BudgetThrottledSequencedTaskRunner::RunTask(OnceClosure task) {
+  const TimeTicks start_time = TimeTicks::Now();
+  std::move(task).Run();
+  const TimeTicks end_time = TimeTicks::Now();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  // Budget refills while the task is running too, so that the tasks can
+  // use exactly |budget_ratio_| of the time when there are enough of them.
+  RefillBudget_Locked(end_time);
+  budget_ -= end_time - start_time;
+}
+
+void BudgetThrottledSequencedTaskRunner::RefillBudget_Locked(TimeTicks now) {
+  const TimeDelta elapsed = now - last_refill_time_;
+  last_refill_time_ = now;
+  budget_ = std::min(
+      max_budget_,
+      budget_ + Microseconds(elapsed.InMicrosecondsF() * budget_ratio_));
+}
+
+void BudgetThrottledSequencedTaskRunner::SetThrottled_Locked(
+    bool is_throttled) {
+  if (is_throttled_ == is_throttled) {
+    return;
+  }
+  is_throttled_ = is_throttled;
+  if (is_throttled_) {
+    ++throttled_count_;
+  }
+  TRACE_COUNTER_ID("base", "BudgetThrottledSequencedTaskRunner", this,
+                   "throttled", is_throttled_ ? 1 : 0);
+}
+
+}  // namespace base
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/serial_sequenced_task_runner.h"
+#include "base/time/time_delta.h"
+#include "base/time/time_ticks.h"
+
+namespace base {
+
+// Sequenced task runner that runs its tasks (in order) on top of another
+// sequenced task runner, but limits the share of time they can spend running.
+// It's meant for background work that shouldn't affect the latency of more
+// important tasks executed by the same threads.
+//
+// The limit uses token bucket semantics: the budget refills at
+// |budget_ratio| of the elapsed time (e.g. 0.2 refills 200ms every second) up
+// to |max_budget|, and the execution time of each task is subtracted from it.
+// Once the budget is spent, the next task is held back until the budget
+// refills. Tasks can't be interrupted, so a single long task can overdraw the
+// budget, which then delays subsequent tasks proportionally.
+//
+// Execution time is measured as the wall time between the start and the end of
+// each task, so time the task was preempted or blocked is counted as well.
+class BudgetThrottledSequencedTaskRunner
+    : public detail::SerialSequencedTaskRunner {
+ public:
+  static scoped_refptr<BudgetThrottledSequencedTaskRunner> Create(
+      scoped_refptr<SequencedTaskRunner> task_runner,
+      double budget_ratio,
+      TimeDelta max_budget);
+
+  // Returns true if pending tasks are held back until the budget refills.
+  bool IsThrottled();
+  // Budget left as of the last executed task (negative if it was overdrawn).
+  TimeDelta GetRemainingBudget();
+  // Number of times the pending tasks were held back.
+  uint64_t GetThrottledCount();
+
+ private:
+  BudgetThrottledSequencedTaskRunner(
+      scoped_refptr<SequencedTaskRunner> task_runner,
+      double budget_ratio,
+      TimeDelta max_budget);
+
+  // detail::SerialSequencedTaskRunner
+  // Returns delay after which the next task can be executed, so that the budget
+  // is checked before each of them.
+  TimeDelta GetRunDelay_Locked() override;
+  void OnTaskTaken_Locked() override;
+  void RunTask(OnceClosure task) override;
+
+  void RefillBudget_Locked(TimeTicks now);
+  void SetThrottled_Locked(bool is_throttled);
+
+  const double budget_ratio_;
+  const TimeDelta max_budget_;
+
+  bool is_throttled_ = false;
+  TimeDelta budget_;
+  TimeTicks last_refill_time_;
+  uint64_t throttled_count_ = 0;
+};
+
+}  // namespace base
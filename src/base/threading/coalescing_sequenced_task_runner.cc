@@ -0,0 +1,121 @@
+#include "base/threading/coalescing_sequenced_task_runner.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+
+namespace base {
+
+// static
+scoped_refptr<CoalescingSequencedTaskRunner>
+CoalescingSequencedTaskRunner::Create(
+    scoped_refptr<SequencedTaskRunner> task_runner) {
+  return WrapRefCounted(
+      new CoalescingSequencedTaskRunner(std::move(task_runner)));
+}
+
+bool CoalescingSequencedTaskRunner::PostDelayedTask(SourceLocation location,
+                                                    OnceClosure task,
+                                                    TimeDelta delay) {
+  return task_runner_->PostDelayedTask(std::move(location), std::move(task),
+                                       delay);
+}
+
+bool CoalescingSequencedTaskRunner::RunsTasksInCurrentSequence() const {
+  return task_runner_->RunsTasksInCurrentSequence();
+}
+
+bool CoalescingSequencedTaskRunner::PostCoalescedTask(SourceLocation location,
+                                                      std::string key,
+                                                      OnceClosure task,
+                                                      CoalescingPolicy policy) {
+  DCHECK(task);
+
+  // Coalesced task is destroyed without the lock held.
+  OnceClosure coalesced_task;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto [it, inserted] = pending_tasks_.try_emplace(key);
+    if (!inserted) {
+      if (policy == CoalescingPolicy::kReplacePending) {
+        coalesced_task = std::exchange(it->second, std::move(task));
+        ++replaced_tasks_count_;
+      } else {
+        coalesced_task = std::move(task);
+        ++dropped_tasks_count_;
+      }
+      return true;
+    }
+    it->second = std::move(task);
+  }
+
+  // If the task can't be posted, destroying the key removes the pending task.
+  return task_runner_->PostTask(
+      std::move(location),
+      BindOnce(&CoalescingSequencedTaskRunner::RunCoalescedTask,
+               PendingTaskKey{WrapRefCounted(this), std::move(key)}));
+}
+
+size_t CoalescingSequencedTaskRunner::GetPendingCoalescedTasksCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return pending_tasks_.size();
+}
+
+uint64_t CoalescingSequencedTaskRunner::GetReplacedTasksCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return replaced_tasks_count_;
+}
+
+uint64_t CoalescingSequencedTaskRunner::GetDroppedTasksCount() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return dropped_tasks_count_;
+}
+
+CoalescingSequencedTaskRunner::CoalescingSequencedTaskRunner(
+    scoped_refptr<SequencedTaskRunner> task_runner)
+    : task_runner_(std::move(task_runner)) {
+  DCHECK(task_runner_);
+}
+
+// static
+void CoalescingSequencedTaskRunner::RunCoalescedTask(
+    PendingTaskKey pending_task_key) {
+  OnceClosure task = pending_task_key.TakeTask();
+  DCHECK(task);
+  std::move(task).Run();
+}
+
+OnceClosure CoalescingSequencedTaskRunner::TakePendingTask(
+    const std::string& key) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = pending_tasks_.find(key);
+  DCHECK(it != pending_tasks_.end());
+  OnceClosure task = std::move(it->second);
+  pending_tasks_.erase(it);
+  return task;
+}
+
+CoalescingSequencedTaskRunner::PendingTaskKey::PendingTaskKey(
+    scoped_refptr<CoalescingSequencedTaskRunner> task_runner,
+    std::string key)
+    : task_runner_(std::move(task_runner)), key_(std::move(key)) {}
+
+CoalescingSequencedTaskRunner::PendingTaskKey::PendingTaskKey(
+    PendingTaskKey&& other) noexcept
+    : task_runner_(std::exchange(other.task_runner_, nullptr)),
+      key_(std::move(other.key_)) {}
+
+CoalescingSequencedTaskRunner::PendingTaskKey::~PendingTaskKey() {
+  if (task_runner_) {
+    // Task is destroyed here, without the lock held.
+    TakeTask();
+  }
+}
+
+OnceClosure CoalescingSequencedTaskRunner::PendingTaskKey::TakeTask() {
+  DCHECK(task_runner_);
+  return std::exchange(task_runner_, nullptr)->TakePendingTask(key_);
+}
+
+}  // namespace base
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_delta.h"
+
+namespace base {
+
+// Sequenced task runner that runs its tasks on top of another sequenced task
+// runner and additionally allows posting tasks identified by a key with
+// `PostCoalescedTask()`. At most one task with a given key is pending at any
+// time - posting another one while the previous one is still pending either
+// replaces the pending task or drops the new one (according to given policy)
+// instead of queuing redundant work. Both cases take constant time.
+//
+// The replacement task takes over the position of the pending task in the
+// queue, so it's executed in order with other tasks as if it was posted when
+// the first of the coalesced tasks was. Once a coalesced task starts running,
+// it's no longer pending and a new task with the same key is queued again.
+//
+// Tasks posted with `PostTask()` and `PostDelayedTask()` are never coalesced.
+class CoalescingSequencedTaskRunner : public SequencedTaskRunner {
+ public:
+  enum class CoalescingPolicy {
+    // The pending task is replaced with the newly posted one.
+    kReplacePending,
+    // The pending task is kept and the newly posted one is dropped.
+    kKeepPending,
+  };
+
+  static scoped_refptr<CoalescingSequencedTaskRunner> Create(
+      scoped_refptr<SequencedTaskRunner> task_runner);
+
+  // SequencedTaskRunner
+  bool PostDelayedTask(SourceLocation location,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  bool RunsTasksInCurrentSequence() const override;
+
+  // Posts |task| unless a task with the same |key| is still pending, in which
+  // case the tasks are coalesced according to |policy|. Returns false only if
+  // the task could not be posted to the underlying task runner.
+  bool PostCoalescedTask(
+      SourceLocation location,
+      std::string key,
+      OnceClosure task,
+      CoalescingPolicy policy = CoalescingPolicy::kReplacePending);
+
+  // Number of coalesced tasks that are currently waiting to be executed.
+  size_t GetPendingCoalescedTasksCount();
+  // Number of posts that replaced a pending task with the same key.
+  uint64_t GetReplacedTasksCount();
+  // Number of posts that were dropped because a task with the same key was
+  // already pending.
+  uint64_t GetDroppedTasksCount();
+
+ private:
+  // Identifies a pending coalesced task. If it's destroyed before the task is
+  // taken (e.g. because the underlying task runner dropped it), the pending
+  // task is removed, so that tasks with the same key can be posted again.
+  class PendingTaskKey {
+   public:
+    PendingTaskKey(scoped_refptr<CoalescingSequencedTaskRunner> task_runner,
+                   std::string key);
+    PendingTaskKey(PendingTaskKey&& other) noexcept;
+    PendingTaskKey& operator=(PendingTaskKey&& other) = delete;
+    ~PendingTaskKey();
+
+    OnceClosure TakeTask();
+
+   private:
+    scoped_refptr<CoalescingSequencedTaskRunner> task_runner_;
+    std::string key_;
+  };
+
+  explicit CoalescingSequencedTaskRunner(
+      scoped_refptr<SequencedTaskRunner> task_runner);
+
+  static void RunCoalescedTask(PendingTaskKey pending_task_key);
+
+  OnceClosure TakePendingTask(const std::string& key);
+
+  const scoped_refptr<SequencedTaskRunner> task_runner_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, OnceClosure> pending_tasks_;
+  uint64_t replaced_tasks_count_ = 0;
+  uint64_t dropped_tasks_count_ = 0;
+};
+
+}  // namespace base
@@ -0,0 +1,59 @@
+#include "base/threading/cooperative_yielding.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_impl.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/time/time_ticks.h"
+
+namespace base {
+
+namespace {
+
+// `ShouldYield()` synchronizes with the thread pool, so it's checked at most
+// once per interval rather than after every (possibly tiny) step.
+const TimeDelta kShouldYieldCheckInterval = Milliseconds(1);
+
+void RunYieldingLoopImpl(SourceLocation location,
+                         RepeatingCallback<bool()> step,
+                         OnceClosure on_done) {
+  TimeTicks next_check_time = TimeTicks::Now() + kShouldYieldCheckInterval;
+  while (step.Run()) {
+    const TimeTicks now = TimeTicks::Now();
+    if (now < next_check_time) {
+      continue;
+    }
+    next_check_time = now + kShouldYieldCheckInterval;
+
+    if (ShouldYield()) {
+      SequencedTaskRunnerHandle::Get()->PostTask(
+          location, BindOnce(&RunYieldingLoopImpl, location, std::move(step),
+                             std::move(on_done)));
+      return;
+    }
+  }
+
+  if (on_done) {
+    std::move(on_done).Run();
+  }
+}
+
+}  // namespace
+
+bool ShouldYield() {
+  return MessageLoopImpl::ShouldYieldCurrentTask();
+}
+
+void RunYieldingLoop(SourceLocation location,
+                     RepeatingCallback<bool()> step,
+                     OnceClosure on_done) {
+  DCHECK(step);
+  DCHECK(SequencedTaskRunnerHandle::IsSet());
+
+  RunYieldingLoopImpl(std::move(location), std::move(step),
+                      std::move(on_done));
+}
+
+}  // namespace base
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "base/callback.h"
+#include "base/source_location.h"
+
+namespace base {
+
+// Returns true if the currently executed task should return as soon as it
+// can, because there is other work waiting for the thread it runs on (e.g.
+// tasks from other sequences or tasks posted to its own sequence after it
+// started) that idle threads of the same pool won't pick up. Long-running
+// tasks can check it periodically and continue their work in a new task (see
+// `RunYieldingLoop()`) to avoid delaying other work.
+// Always returns false outside of tasks executed by libbase's message loops.
+//
+// Checking requires synchronization with the thread pool, so it should be done
+// between reasonably sized chunks of work rather than after every instruction.
+bool ShouldYield();
+
+// Runs |step| repeatedly until it returns false and then runs |on_done| (if
+// set). `ShouldYield()` is checked between steps (at most once per
+// millisecond, so steps can be small) and whenever it returns true, the
+// remaining steps are continued in a new task posted to the current sequence,
+// so that other pending work can be executed in between. The first step is
+// executed synchronously. Must be called from within a task executed on a
+// sequence.
+void RunYieldingLoop(SourceLocation location,
+                     RepeatingCallback<bool()> step,
+                     OnceClosure on_done = {});
+
+}  // namespace base
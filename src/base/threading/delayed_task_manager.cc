@@ -1,5 +1,6 @@
 #include "base/threading/delayed_task_manager.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "base/logging.h"
@@ -7,13 +8,61 @@
 namespace base {
 
 namespace {
+
+// Same policy as in `MessagePumpImpl`: cancelled tasks are swept whenever the
+// queue doubles in size since the last sweep.
+constexpr size_t kMinDelayedTasksCountToSweep = 64;
+
+bool IsCancelled(const DelayedTaskManager::DelayedTask& delayed_task) {
+  return !delayed_task.pending_task.task.MaybeValid();
+}
+
 void ScheduleTask(const DelayedTaskManager::DelayedTask& delayed_task) {
-  if (auto message_pump = delayed_task.message_pump.lock()) {
-    message_pump->QueuePendingTask(std::move(delayed_task.pending_task));
-  }
+  delayed_task.message_pump->QueuePendingTask(
+      std::move(delayed_task.pending_task));
 }
+
 }  // namespace
 
+DelayedTaskManager::ScopedDelayedWakeUp::ScopedDelayedWakeUp(
+    scoped_refptr<MessagePump> message_pump,
+    TimeTicks run_time,
+    std::optional<MessagePump::ExecutorId> allowed_executor_id)
+    : message_pump_(std::move(message_pump)),
+      run_time_(run_time),
+      allowed_executor_id_(allowed_executor_id) {
+  message_pump_->AddDelayedWakeUp(run_time_, allowed_executor_id_);
+}
+
+DelayedTaskManager::ScopedDelayedWakeUp::ScopedDelayedWakeUp(
+    ScopedDelayedWakeUp&& other) noexcept
+    : message_pump_(std::move(other.message_pump_)),
+      run_time_(other.run_time_),
+      allowed_executor_id_(other.allowed_executor_id_) {}
+
+DelayedTaskManager::ScopedDelayedWakeUp&
+DelayedTaskManager::ScopedDelayedWakeUp::operator=(
+    ScopedDelayedWakeUp&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    message_pump_ = std::move(other.message_pump_);
+    run_time_ = other.run_time_;
+    allowed_executor_id_ = other.allowed_executor_id_;
+  }
+  return *this;
+}
+
+DelayedTaskManager::ScopedDelayedWakeUp::~ScopedDelayedWakeUp() {
+  Reset();
+}
+
+void DelayedTaskManager::ScopedDelayedWakeUp::Reset() {
+  if (message_pump_) {
+    message_pump_->RemoveDelayedWakeUp(run_time_, allowed_executor_id_);
+    message_pump_.reset();
+  }
+}
+
 bool DelayedTaskManager::DelayedTask::operator<(const DelayedTask& rhs) const {
   // We're returning bigger value, because we want to sort the tasks from the
   // one with smaller start_time at the top, while std::priority_queue<T> - by
@@ -22,10 +71,15 @@ bool DelayedTaskManager::DelayedTask::operator<(const DelayedTask& rhs) const {
   return start_time > rhs.start_time;
 }
 
-DelayedTaskManager::DelayedTaskManager(TimeTicksProvider time_ticks_provider)
-    : time_ticks_provider_(time_ticks_provider), stopped_(false) {
-  scheduler_thread_ =
-      std::thread{&DelayedTaskManager::ScheduleTasksUntilStop, this};
+DelayedTaskManager::DelayedTaskManager(TimeTicksProvider time_ticks_provider,
+                                       SchedulingMode scheduling_mode)
+    : time_ticks_provider_(time_ticks_provider),
+      stopped_(false),
+      next_sweep_tasks_count_(kMinDelayedTasksCountToSweep) {
+  if (scheduling_mode == SchedulingMode::kSchedulerThread) {
+    scheduler_thread_ =
+        std::thread{&DelayedTaskManager::ScheduleTasksUntilStop, this};
+  }
 }
 
 DelayedTaskManager::~DelayedTaskManager() {
@@ -35,10 +89,13 @@ DelayedTaskManager::~DelayedTaskManager() {
   }
 
   cond_var_.notify_one();
-  scheduler_thread_.join();
+  if (scheduler_thread_.joinable()) {
+    scheduler_thread_.join();
+  }
 }
 
 void DelayedTaskManager::QueueDelayedTask(DelayedTask delayed_task) {
+  std::vector<DelayedTask> finished_tasks;
   std::lock_guard<std::mutex> lock{mutex_};
 
   if (stopped_) {
@@ -60,39 +117,69 @@ void DelayedTaskManager::QueueDelayedTask(DelayedTask delayed_task) {
       delayed_tasks_.empty() ||
       (delayed_task.start_time < delayed_tasks_.top().start_time);
 
+  delayed_task.wake_up = ScopedDelayedWakeUp(
+      delayed_task.message_pump, delayed_task.start_time,
+      delayed_task.pending_task.allowed_executor_id);
   delayed_tasks_.push(std::move(delayed_task));
 
   if (need_to_wake_scheduler) {
     cond_var_.notify_one();
   }
 
+  if (delayed_tasks_.size() >= next_sweep_tasks_count_) {
+    delayed_tasks_.SweepCancelledTasks(finished_tasks);
+    next_sweep_tasks_count_ =
+        std::max(2 * delayed_tasks_.size(), kMinDelayedTasksCountToSweep);
+  }
+
   // Try to schedule any pending tasks while we're here.
-  ScheduleAllReadyTasksLocked();
+  ScheduleAllReadyTasksLocked(finished_tasks);
+}
+
+std::optional<TimeTicks> DelayedTaskManager::NextDelayedTaskTime() {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  if (delayed_tasks_.empty()) {
+    return {};
+  }
+  return delayed_tasks_.top().start_time;
 }
 
 void DelayedTaskManager::ScheduleAllReadyTasksForTests() {
+  std::vector<DelayedTask> finished_tasks;
   std::unique_lock<std::mutex> lock{mutex_};
-  ScheduleAllReadyTasksLocked();
+  ScheduleAllReadyTasksLocked(finished_tasks);
 }
 
 void DelayedTaskManager::ScheduleTasksUntilStop() {
   std::unique_lock<std::mutex> lock{mutex_};
 
   while (!stopped_) {
-    ScheduleAllReadyTasksLocked();
+    std::vector<DelayedTask> finished_tasks;
+    ScheduleAllReadyTasksLocked(finished_tasks);
+    if (!finished_tasks.empty()) {
+      lock.unlock();
+      finished_tasks.clear();
+      lock.lock();
+      continue;
+    }
     WaitForNextTaskOrStopLocked(lock);
   }
 }
 
-void DelayedTaskManager::ScheduleAllReadyTasksLocked() {
+void DelayedTaskManager::ScheduleAllReadyTasksLocked(
+    std::vector<DelayedTask>& finished_tasks) {
   const auto can_run_first_task = [&]() {
     return !delayed_tasks_.empty() &&
            delayed_tasks_.top().start_time <= time_ticks_provider_();
   };
 
   while (can_run_first_task()) {
-    ScheduleTask(delayed_tasks_.top());
-    delayed_tasks_.pop();
+    DelayedTask delayed_task = delayed_tasks_.Take();
+    if (!IsCancelled(delayed_task)) {
+      ScheduleTask(delayed_task);
+    }
+    finished_tasks.push_back(std::move(delayed_task));
   }
 }
 
@@ -112,6 +199,30 @@ void DelayedTaskManager::WaitForNextTaskOrStopLocked(
   }
 }
 
+DelayedTaskManager::DelayedTask DelayedTaskManager::DelayedTaskQueue::Take() {
+  std::pop_heap(c.begin(), c.end(), comp);
+  DelayedTask delayed_task = std::move(c.back());
+  c.pop_back();
+  return delayed_task;
+}
+
+void DelayedTaskManager::DelayedTaskQueue::SweepCancelledTasks(
+    std::vector<DelayedTask>& cancelled_tasks) {
+  const auto cancelled_begin =
+      std::partition(c.begin(), c.end(), [](const DelayedTask& delayed_task) {
+        return !IsCancelled(delayed_task);
+      });
+  if (cancelled_begin == c.end()) {
+    return;
+  }
+
+  for (auto task_iter = cancelled_begin; task_iter != c.end(); ++task_iter) {
+    cancelled_tasks.push_back(std::move(*task_iter));
+  }
+  c.erase(cancelled_begin, c.end());
+  std::make_heap(c.begin(), c.end(), comp);
+}
+
 std::optional<TimeDelta> DelayedTaskManager::NextTaskRemainingDelayLocked()
     const {
   if (delayed_tasks_.empty()) {
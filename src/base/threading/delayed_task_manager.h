@@ -2,10 +2,11 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "base/message_loop/message_pump.h"
 #include "base/time/time_ticks.h"
@@ -14,26 +15,76 @@ namespace base {
 
 class DelayedTaskManager {
  public:
+  // Keeps a pump informed about a delayed task that will be queued to it (see
+  // `MessagePump::AddDelayedWakeUp()`) for as long as it's alive.
+  class ScopedDelayedWakeUp {
+   public:
+    ScopedDelayedWakeUp() = default;
+    ScopedDelayedWakeUp(
+        scoped_refptr<MessagePump> message_pump,
+        TimeTicks run_time,
+        std::optional<MessagePump::ExecutorId> allowed_executor_id);
+    ScopedDelayedWakeUp(ScopedDelayedWakeUp&& other) noexcept;
+    ScopedDelayedWakeUp& operator=(ScopedDelayedWakeUp&& other) noexcept;
+    ~ScopedDelayedWakeUp();
+
+   private:
+    void Reset();
+
+    scoped_refptr<MessagePump> message_pump_;
+    TimeTicks run_time_;
+    std::optional<MessagePump::ExecutorId> allowed_executor_id_;
+  };
+
   struct DelayedTask {
     bool operator<(const DelayedTask& rhs) const;
 
     TimeTicks start_time;
-    std::weak_ptr<MessagePump> message_pump;
+    scoped_refptr<MessagePump> message_pump;
     mutable MessagePump::PendingTask pending_task;
+    // Set by the manager once the task is queued.
+    ScopedDelayedWakeUp wake_up = {};
   };
 
   using TimeTicksProvider = TimeTicks (*)();
 
-  DelayedTaskManager(TimeTicksProvider time_ticks_provider = &TimeTicks::Now);
+  enum class SchedulingMode {
+    // Ready tasks are scheduled by a dedicated scheduler thread.
+    kSchedulerThread,
+    // Ready tasks are scheduled only when a new task is queued or on explicit
+    // `ScheduleAllReadyTasksForTests()` calls. Used with mocked time.
+    kManual,
+  };
+
+  DelayedTaskManager(
+      TimeTicksProvider time_ticks_provider = &TimeTicks::Now,
+      SchedulingMode scheduling_mode = SchedulingMode::kSchedulerThread);
   ~DelayedTaskManager();
 
   void QueueDelayedTask(DelayedTask delayed_task);
 
+  // Returns the time at which the earliest of the queued tasks should start,
+  // if there are any.
+  std::optional<TimeTicks> NextDelayedTaskTime();
+
   void ScheduleAllReadyTasksForTests();
 
  private:
+  // Priority queue which allows removing cancelled tasks from the middle.
+  class DelayedTaskQueue : public std::priority_queue<DelayedTask> {
+   public:
+    // Removes the top task and returns it.
+    DelayedTask Take();
+    // Moves tasks that are known to be cancelled to |cancelled_tasks|.
+    void SweepCancelledTasks(std::vector<DelayedTask>& cancelled_tasks);
+  };
+
+  // Tasks taken out of the queue (what's left of them after they were
+  // scheduled, or whole ones if they were cancelled) are moved to
+  // |finished_tasks|, so that they are destroyed after the lock is released.
+  // Destroying any of their parts (e.g. a task runner reference) might post.
   void ScheduleTasksUntilStop();
-  void ScheduleAllReadyTasksLocked();
+  void ScheduleAllReadyTasksLocked(std::vector<DelayedTask>& finished_tasks);
   void WaitForNextTaskOrStopLocked(std::unique_lock<std::mutex>& lock);
   std::optional<TimeDelta> NextTaskRemainingDelayLocked() const;
 
@@ -45,7 +96,9 @@ class DelayedTaskManager {
 
   // Everything below is locked behind |mutex_|.
   bool stopped_;
-  std::priority_queue<DelayedTask> delayed_tasks_;
+  DelayedTaskQueue delayed_tasks_;
+  // Size of |delayed_tasks_| at which cancelled tasks are swept next time.
+  size_t next_sweep_tasks_count_;
 };
 
 }  // namespace base
@@ -1,5 +1,7 @@
 #include "base/threading/delayed_task_manager_shared_instance.h"
 
+#include <utility>
+
 #include "base/threading/delayed_task_manager.h"
 
 namespace base {
@@ -13,9 +15,24 @@ DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance() {
   if (auto x = instance.current_manager_.lock()) {
     return x;
   }
-  std::shared_ptr<DelayedTaskManager> new_manager{new DelayedTaskManager()};
-  instance.current_manager_ = new_manager;
-  return new_manager;
+  // Delayed tasks keep their task runners alive and these keep the manager,
+  // so the default instance is owned here until the process exits. Otherwise
+  // it could be destroyed by one of its own tasks on its scheduler thread.
+  if (!instance.default_manager_) {
+    instance.default_manager_.reset(new DelayedTaskManager());
+  }
+  instance.current_manager_ = instance.default_manager_;
+  return instance.default_manager_;
+}
+
+// static
+std::weak_ptr<DelayedTaskManager>
+DelayedTaskManagerSharedInstance::SetSharedInstanceForTesting(
+    std::weak_ptr<DelayedTaskManager> manager) {
+  auto& instance = GetInstance();
+
+  std::lock_guard<std::mutex> guard{instance.mutex_};
+  return std::exchange(instance.current_manager_, std::move(manager));
 }
 
 // static
@@ -11,10 +11,16 @@ class DelayedTaskManagerSharedInstance {
  public:
   static std::shared_ptr<DelayedTaskManager> GetOrCreateSharedInstance();
 
+  // Makes |manager| the shared instance returned to all the new task runners
+  // (as long as it is alive). Returns the previous shared instance.
+  static std::weak_ptr<DelayedTaskManager> SetSharedInstanceForTesting(
+      std::weak_ptr<DelayedTaskManager> manager);
+
  private:
   static DelayedTaskManagerSharedInstance& GetInstance();
 
   std::mutex mutex_;
+  std::shared_ptr<DelayedTaskManager> default_manager_;
   std::weak_ptr<DelayedTaskManager> current_manager_;
 };
 
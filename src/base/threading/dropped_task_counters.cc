@@ -0,0 +1,56 @@
+#include "base/threading/dropped_task_counters.h"
+
+namespace base {
+
+namespace {
+DroppedTaskCounters::Location ToLocation(const SourceLocation& location) {
+  return {location.file, location.line};
+}
+}  // namespace
+
+// static
+void DroppedTaskCounters::RecordDroppedTask(const SourceLocation& location) {
+  auto& instance = GetInstance();
+
+  std::lock_guard<std::mutex> guard{instance.mutex_};
+  ++instance.counters_[ToLocation(location)];
+}
+
+// static
+uint64_t DroppedTaskCounters::GetDroppedTasksCount(
+    const SourceLocation& location) {
+  auto& instance = GetInstance();
+
+  std::lock_guard<std::mutex> guard{instance.mutex_};
+  const auto it = instance.counters_.find(ToLocation(location));
+  return it != instance.counters_.end() ? it->second : 0;
+}
+
+// static
+std::vector<std::pair<DroppedTaskCounters::Location, uint64_t>>
+DroppedTaskCounters::GetAllDroppedTasksCounts() {
+  auto& instance = GetInstance();
+
+  std::lock_guard<std::mutex> guard{instance.mutex_};
+  return {instance.counters_.begin(), instance.counters_.end()};
+}
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+// static
+void DroppedTaskCounters::ResetForTesting() {
+  auto& instance = GetInstance();
+
+  std::lock_guard<std::mutex> guard{instance.mutex_};
+  instance.counters_.clear();
+}
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+// static
+DroppedTaskCounters& DroppedTaskCounters::GetInstance() {
+  // Leaked on purpose, so that tasks can still be dropped during static
+  // de-initialization.
+  static auto* instance = new DroppedTaskCounters();
+  return *instance;
+}
+
+}  // namespace base
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/source_location.h"
+
+namespace base {
+
+// Counts tasks that were dropped without being run because they expired
+// before they could be started. Tasks are grouped by the location from which
+// they were posted (file names are compared by their contents, as the same
+// file name might be stored at different addresses in different binaries).
+class DroppedTaskCounters {
+ public:
+  using Location = std::pair<std::string, size_t>;
+
+  static void RecordDroppedTask(const SourceLocation& location);
+
+  static uint64_t GetDroppedTasksCount(const SourceLocation& location);
+  static std::vector<std::pair<Location, uint64_t>> GetAllDroppedTasksCounts();
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  static void ResetForTesting();
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+ private:
+  static DroppedTaskCounters& GetInstance();
+
+  std::mutex mutex_;
+  std::map<Location, uint64_t> counters_;
+};
+
+}  // namespace base
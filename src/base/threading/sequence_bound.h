@@ -0,0 +1,252 @@
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/logging.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+
+namespace base {
+
+// Owns an object of type `T` that lives on (and is used only from) the
+// sequence of a given `SequencedTaskRunner`. The object is constructed and
+// destroyed on that sequence and all calls to its methods are posted to it,
+// so `T` doesn't need any locks even though its owner lives elsewhere.
+//
+// base::SequenceBound<Database> database{thread.TaskRunner(), path};
+// database.AsyncCall(FROM_HERE, &Database::Store).WithArgs(key, value);
+// database.AsyncCall(FROM_HERE, &Database::Load)
+//     .WithArgs(key)
+//     .Then(base::BindOnce(&Client::OnLoaded, weak_factory_.GetWeakPtr()));
+//
+// Calls are executed in the order in which they were made. Replies are posted
+// back to the sequence on which the call was made.
+template <typename T>
+class SequenceBound {
+ private:
+  template <typename Method>
+  class AsyncCallBuilder;
+  template <typename ReturnType>
+  class AsyncCallWithArgsBuilder;
+
+ public:
+  SequenceBound() = default;
+
+  // Posts a task which constructs `T` with given |arguments| on the sequence
+  // of |task_runner|. The memory for the object is allocated immediately, so
+  // calls can be made right away and are executed after the construction.
+  template <typename... Arguments>
+  explicit SequenceBound(scoped_refptr<SequencedTaskRunner> task_runner,
+                         Arguments&&... arguments)
+      : task_runner_(std::move(task_runner)), object_(AllocateObject()) {
+    DCHECK(task_runner_);
+    task_runner_->PostTask(
+        FROM_HERE,
+        BindOnce(&SequenceBound::ConstructObject<std::decay_t<Arguments>...>,
+                 object_, std::forward<Arguments>(arguments)...));
+  }
+
+  SequenceBound(SequenceBound&& other) noexcept
+      : task_runner_(std::move(other.task_runner_)),
+        object_(std::exchange(other.object_, nullptr)) {}
+
+  SequenceBound& operator=(SequenceBound&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      task_runner_ = std::move(other.task_runner_);
+      object_ = std::exchange(other.object_, nullptr);
+    }
+    return *this;
+  }
+
+  SequenceBound(const SequenceBound&) = delete;
+  SequenceBound& operator=(const SequenceBound&) = delete;
+
+  ~SequenceBound() { Reset(); }
+
+  // Posts a task which destroys the owned object on its sequence (after all
+  // the calls made so far). If the task cannot be posted (e.g. because the
+  // thread was already stopped), the object is leaked.
+  void Reset() {
+    if (is_null()) {
+      return;
+    }
+
+    task_runner_->PostTask(
+        FROM_HERE, BindOnce(&SequenceBound::DestroyObject, object_));
+    task_runner_.reset();
+    object_ = nullptr;
+  }
+
+  bool is_null() const { return object_ == nullptr; }
+  explicit operator bool() const { return !is_null(); }
+
+  // Posts a call of |method| on the owned object from |location|. Arguments
+  // of the call (if any) have to be provided with `WithArgs()` and an optional
+  // reply callback, which receives the result of the call, with `Then()`. The
+  // call is posted once the returned builder goes out of scope.
+  template <typename Method>
+  AsyncCallBuilder<Method> AsyncCall(SourceLocation location, Method method) {
+    DCHECK(!is_null());
+    return AsyncCallBuilder<Method>{task_runner_, object_, method, location};
+  }
+
+ private:
+  static T* AllocateObject() {
+    return static_cast<T*>(
+        ::operator new(sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+  template <typename... Arguments>
+  static void ConstructObject(T* object, Arguments... arguments) {
+    new (object) T(std::move(arguments)...);
+  }
+
+  static void DestroyObject(T* object) {
+    object->~T();
+    ::operator delete(object, std::align_val_t{alignof(T)});
+  }
+
+  template <typename ReturnType, typename ReplyCallback>
+  static void PostCallWithReply(SequencedTaskRunner& task_runner,
+                                SourceLocation location,
+                                OnceCallback<ReturnType()> call,
+                                ReplyCallback reply) {
+    if constexpr (std::is_void_v<ReturnType>) {
+      task_runner.PostTaskAndReply(location, std::move(call),
+                                   OnceClosure{std::move(reply)});
+    } else {
+      task_runner.PostTaskAndReplyWithResult(location, std::move(call),
+                                             std::move(reply));
+    }
+  }
+
+  template <typename ReturnType>
+  static void RunIgnoringResult(OnceCallback<ReturnType()> call) {
+    static_cast<void>(std::move(call).Run());
+  }
+
+  // Builder of a call to a method which was not given its arguments yet.
+  template <typename Method>
+  class AsyncCallBuilder {
+   public:
+    using ReturnType = typename detail::FunctorTraits<Method>::ReturnType;
+
+    AsyncCallBuilder(const AsyncCallBuilder&) = delete;
+    AsyncCallBuilder& operator=(const AsyncCallBuilder&) = delete;
+
+    ~AsyncCallBuilder() {
+      if (!task_runner_) {
+        return;
+      }
+
+      if constexpr (kTakesArguments) {
+        DCHECK(false) << "Arguments of the call have to be given with "
+                         "WithArgs()";
+      } else {
+        task_runner_->PostTask(location_,
+                               BindOnce(IgnoreResult(method_), object_));
+      }
+    }
+
+    template <typename... Arguments>
+    AsyncCallWithArgsBuilder<ReturnType> WithArgs(
+        Arguments&&... arguments) && {
+      static_assert(kTakesArguments,
+                    "WithArgs() is not needed for methods without arguments");
+      return AsyncCallWithArgsBuilder<ReturnType>{
+          std::move(task_runner_), location_,
+          BindOnce(method_, object_, std::forward<Arguments>(arguments)...)};
+    }
+
+    template <typename ReplyCallback>
+    void Then(ReplyCallback reply) && {
+      static_assert(!kTakesArguments,
+                    "Arguments of the call have to be given with WithArgs()");
+      const auto task_runner = std::move(task_runner_);
+      PostCallWithReply(*task_runner, location_,
+                        OnceCallback<ReturnType()>{BindOnce(method_, object_)},
+                        std::move(reply));
+    }
+
+   private:
+    friend class SequenceBound;
+
+    // Methods are invoked on the instance pointer, so it counts as one of
+    // their arguments.
+    static constexpr bool kTakesArguments =
+        detail::FunctorTraits<Method>::ArgumentsCount > 1;
+
+    AsyncCallBuilder(scoped_refptr<SequencedTaskRunner> task_runner,
+                     T* object,
+                     Method method,
+                     SourceLocation location)
+        : task_runner_(std::move(task_runner)),
+          object_(Unretained(object)),
+          method_(method),
+          location_(location) {}
+
+    // Reset once the call is posted (or handed over to another builder).
+    scoped_refptr<SequencedTaskRunner> task_runner_;
+    // The object outlives all the calls, as it's destroyed by a task posted
+    // after them.
+    detail::UnretainedType<T> object_;
+    Method method_;
+    SourceLocation location_;
+  };
+
+  // Builder of a call with already bound arguments.
+  template <typename ReturnType>
+  class AsyncCallWithArgsBuilder {
+   public:
+    AsyncCallWithArgsBuilder(const AsyncCallWithArgsBuilder&) = delete;
+    AsyncCallWithArgsBuilder& operator=(const AsyncCallWithArgsBuilder&) =
+        delete;
+
+    ~AsyncCallWithArgsBuilder() {
+      if (!task_runner_) {
+        return;
+      }
+
+      if constexpr (std::is_void_v<ReturnType>) {
+        task_runner_->PostTask(location_, std::move(call_));
+      } else {
+        task_runner_->PostTask(
+            location_, BindOnce(&SequenceBound::RunIgnoringResult<ReturnType>,
+                                std::move(call_)));
+      }
+    }
+
+    template <typename ReplyCallback>
+    void Then(ReplyCallback reply) && {
+      const auto task_runner = std::move(task_runner_);
+      PostCallWithReply(*task_runner, location_, std::move(call_),
+                        std::move(reply));
+    }
+
+   private:
+    template <typename Method>
+    friend class AsyncCallBuilder;
+
+    AsyncCallWithArgsBuilder(scoped_refptr<SequencedTaskRunner> task_runner,
+                             SourceLocation location,
+                             OnceCallback<ReturnType()> call)
+        : task_runner_(std::move(task_runner)),
+          location_(location),
+          call_(std::move(call)) {}
+
+    // Reset once the call is posted.
+    scoped_refptr<SequencedTaskRunner> task_runner_;
+    SourceLocation location_;
+    OnceCallback<ReturnType()> call_;
+  };
+
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+  T* object_ = nullptr;
+};
+
+}  // namespace base
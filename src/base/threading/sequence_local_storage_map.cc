@@ -0,0 +1,66 @@
+#include "base/threading/sequence_local_storage_map.h"
+
+#include <atomic>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace base {
+namespace detail {
+
+namespace {
+thread_local SequenceLocalStorageMap* g_current_map = nullptr;
+}
+
+SequenceLocalStorageMap::SequenceLocalStorageMap() = default;
+
+SequenceLocalStorageMap::~SequenceLocalStorageMap() = default;
+
+// static
+size_t SequenceLocalStorageMap::GetNextSlotId() {
+  static std::atomic_size_t next_slot_id = 0;
+  return next_slot_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+// static
+SequenceLocalStorageMap* SequenceLocalStorageMap::GetForCurrentThread() {
+  return g_current_map;
+}
+
+void* SequenceLocalStorageMap::Get(size_t slot_id) const {
+  const auto it = values_.find(slot_id);
+  return it != values_.end() ? it->second.get() : nullptr;
+}
+
+void SequenceLocalStorageMap::Set(size_t slot_id, Value value) {
+  DCHECK(value);
+  // The previous value is destroyed after the new one is stored, so that it
+  // can still access the slot.
+  auto& stored_value =
+      values_.try_emplace(slot_id, nullptr, nullptr).first->second;
+  std::swap(stored_value, value);
+}
+
+void SequenceLocalStorageMap::Reset(size_t slot_id) {
+  auto it = values_.find(slot_id);
+  if (it == values_.end()) {
+    return;
+  }
+
+  const auto value = std::move(it->second);
+  values_.erase(it);
+}
+
+ScopedSequenceLocalStorageMapSetter::ScopedSequenceLocalStorageMapSetter(
+    SequenceLocalStorageMap& sequence_local_storage_map) {
+  CHECK(!g_current_map);
+  g_current_map = &sequence_local_storage_map;
+}
+
+ScopedSequenceLocalStorageMapSetter::~ScopedSequenceLocalStorageMapSetter() {
+  CHECK(g_current_map);
+  g_current_map = nullptr;
+}
+
+}  // namespace detail
+}  // namespace base
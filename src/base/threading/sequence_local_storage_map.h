@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+namespace base {
+namespace detail {
+
+// Values of `SequenceLocalStorageSlot`s set on a single sequence. The map is
+// owned by the sequence's task runner and is made current on the thread which
+// runs a task from that sequence, so it's accessed without any locks.
+class SequenceLocalStorageMap {
+ public:
+  using Value = std::unique_ptr<void, void (*)(void*)>;
+
+  SequenceLocalStorageMap();
+  ~SequenceLocalStorageMap();
+
+  SequenceLocalStorageMap(const SequenceLocalStorageMap&) = delete;
+  SequenceLocalStorageMap& operator=(const SequenceLocalStorageMap&) = delete;
+
+  static size_t GetNextSlotId();
+
+  // Returns nullptr if no task from a sequence with local storage is running
+  // on the current thread.
+  static SequenceLocalStorageMap* GetForCurrentThread();
+
+  // Returns nullptr if no value was set for the slot.
+  void* Get(size_t slot_id) const;
+  void Set(size_t slot_id, Value value);
+  void Reset(size_t slot_id);
+
+ private:
+  std::unordered_map<size_t, Value> values_;
+};
+
+class ScopedSequenceLocalStorageMapSetter {
+ public:
+  explicit ScopedSequenceLocalStorageMapSetter(
+      SequenceLocalStorageMap& sequence_local_storage_map);
+  ~ScopedSequenceLocalStorageMapSetter();
+
+  ScopedSequenceLocalStorageMapSetter(
+      const ScopedSequenceLocalStorageMapSetter&) = delete;
+  ScopedSequenceLocalStorageMapSetter& operator=(
+      const ScopedSequenceLocalStorageMapSetter&) = delete;
+};
+
+}  // namespace detail
+}  // namespace base
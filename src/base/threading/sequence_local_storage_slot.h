@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/threading/sequence_local_storage_map.h"
+
+namespace base {
+
+// Holds a separate value of type `T` for each sequence on which it is used,
+// similarly to how `thread_local` variables are separate for each thread. The
+// values are stored by the task runner of the sequence and are accessed
+// without any locks. They are destroyed together with the task runner, i.e. on
+// whichever thread releases the last reference to it (not necessarily one that
+// runs the sequence), so `T` must be safe to destroy on any thread.
+//
+// Slots can only be used from within tasks posted to sequenced task runners
+// (or on a thread with a `base::RunLoop`). They are usually static:
+//
+// Cache& GetCacheForCurrentSequence() {
+//   static base::SequenceLocalStorageSlot<Cache> cache_slot;
+//   return cache_slot.GetOrCreateValue();
+// }
+template <typename T>
+class SequenceLocalStorageSlot {
+ public:
+  SequenceLocalStorageSlot()
+      : slot_id_(detail::SequenceLocalStorageMap::GetNextSlotId()) {}
+  ~SequenceLocalStorageSlot() = default;
+
+  SequenceLocalStorageSlot(const SequenceLocalStorageSlot&) = delete;
+  SequenceLocalStorageSlot& operator=(const SequenceLocalStorageSlot&) =
+      delete;
+
+  // Returns the value of the current sequence or nullptr if it wasn't set.
+  T* GetValuePointer() const {
+    return static_cast<T*>(GetCurrentMap().Get(slot_id_));
+  }
+
+  // Returns the value of the current sequence, default-constructing it first
+  // if it wasn't set.
+  T& GetOrCreateValue() {
+    if (T* value = GetValuePointer()) {
+      return *value;
+    }
+    return emplace();
+  }
+
+  // Replaces the value of the current sequence with a new one constructed
+  // from given |arguments|.
+  template <typename... Arguments>
+  T& emplace(Arguments&&... arguments) {
+    detail::SequenceLocalStorageMap::Value value{
+        new T(std::forward<Arguments>(arguments)...),
+        &SequenceLocalStorageSlot::DeleteValue};
+    T* value_pointer = static_cast<T*>(value.get());
+    GetCurrentMap().Set(slot_id_, std::move(value));
+    return *value_pointer;
+  }
+
+  // Destroys the value of the current sequence (if it was set).
+  void reset() { GetCurrentMap().Reset(slot_id_); }
+
+  explicit operator bool() const { return GetValuePointer() != nullptr; }
+
+  // Can be used only if the value of the current sequence is set.
+  T& operator*() const {
+    T* value = GetValuePointer();
+    DCHECK(value);
+    return *value;
+  }
+
+  T* operator->() const {
+    T* value = GetValuePointer();
+    DCHECK(value);
+    return value;
+  }
+
+ private:
+  static detail::SequenceLocalStorageMap& GetCurrentMap() {
+    auto* map = detail::SequenceLocalStorageMap::GetForCurrentThread();
+    CHECK(map) << "SequenceLocalStorageSlot can only be used from within a "
+                  "task posted to a sequenced task runner";
+    return *map;
+  }
+
+  static void DeleteValue(void* value) { delete static_cast<T*>(value); }
+
+  const size_t slot_id_;
+};
+
+}  // namespace base
@@ -10,7 +10,7 @@ thread_local SequencedTaskRunnerHandle* g_handle = nullptr;
 }
 
 // static
-const std::shared_ptr<SequencedTaskRunner>& SequencedTaskRunnerHandle::Get() {
+const scoped_refptr<SequencedTaskRunner>& SequencedTaskRunnerHandle::Get() {
   CHECK(g_handle) << "Attempted to access SequencedTaskRunner handle on a "
                      "thread without task runner";
   return g_handle->task_runner_;
@@ -22,7 +22,7 @@ bool SequencedTaskRunnerHandle::IsSet() {
 }
 
 SequencedTaskRunnerHandle::SequencedTaskRunnerHandle(
-    std::shared_ptr<SequencedTaskRunner> task_runner)
+    scoped_refptr<SequencedTaskRunner> task_runner)
     : task_runner_(std::move(task_runner)) {
   DCHECK(task_runner_);
   DCHECK(task_runner_->RunsTasksInCurrentSequence());
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <memory>
-
 #include "base/sequenced_task_runner.h"
 
 namespace base {
@@ -9,11 +7,11 @@ namespace base {
 class SequencedTaskRunnerHandle {
  public:
   // Can be called only if IsSet() returns true.
-  static const std::shared_ptr<SequencedTaskRunner>& Get();
+  static const scoped_refptr<SequencedTaskRunner>& Get();
   static bool IsSet();
 
   explicit SequencedTaskRunnerHandle(
-      std::shared_ptr<SequencedTaskRunner> task_runner);
+      scoped_refptr<SequencedTaskRunner> task_runner);
   ~SequencedTaskRunnerHandle();
 
   SequencedTaskRunnerHandle(const SequencedTaskRunnerHandle&) = delete;
@@ -21,7 +19,7 @@ class SequencedTaskRunnerHandle {
       delete;
 
  private:
-  std::shared_ptr<SequencedTaskRunner> task_runner_;
+  scoped_refptr<SequencedTaskRunner> task_runner_;
 };
 
 }  // namespace base
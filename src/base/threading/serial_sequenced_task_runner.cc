@@ -0,0 +1,136 @@
+#include "base/threading/serial_sequenced_task_runner.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+
+namespace base {
+namespace detail {
+
+bool SerialSequencedTaskRunner::PostDelayedTask(SourceLocation location,
+                                                OnceClosure task,
+                                                TimeDelta delay) {
+  if (delay.IsPositive()) {
+    return task_runner_->PostDelayedTask(
+        std::move(location),
+        BindOnce(&SerialSequencedTaskRunner::OnDelayedTaskReady,
+                 WrapRefCounted(this), std::move(task)),
+        delay);
+  }
+
+  OnceClosure dropped_task;
+  bool should_schedule_run = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!QueueTask_Locked(task, dropped_task)) {
+      return false;
+    }
+    should_schedule_run = ShouldScheduleRun_Locked();
+  }
+
+  return !should_schedule_run || ScheduleRun();
+}
+
+bool SerialSequencedTaskRunner::RunsTasksInCurrentSequence() const {
+  return task_runner_->RunsTasksInCurrentSequence();
+}
+
+SerialSequencedTaskRunner::SerialSequencedTaskRunner(
+    scoped_refptr<SequencedTaskRunner> task_runner)
+    : task_runner_(std::move(task_runner)) {
+  DCHECK(task_runner_);
+}
+
+bool SerialSequencedTaskRunner::QueueTask_Locked(
+    OnceClosure& task,
+    OnceClosure& /*dropped_task*/) {
+  pending_tasks_.push_back(std::move(task));
+  return true;
+}
+
+TimeDelta SerialSequencedTaskRunner::GetRunDelay_Locked() {
+  return TimeDelta{};
+}
+
+void SerialSequencedTaskRunner::RunTask(OnceClosure task) {
+  std::move(task).Run();
+}
+
+bool SerialSequencedTaskRunner::ShouldScheduleRun_Locked() {
+  if (is_run_scheduled_ || pending_tasks_.empty()) {
+    return false;
+  }
+  is_run_scheduled_ = true;
+  return true;
+}
+
+bool SerialSequencedTaskRunner::ScheduleRun() {
+  TimeDelta delay;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    delay = GetRunDelay_Locked();
+  }
+
+  auto run_next_task = BindOnce(&SerialSequencedTaskRunner::RunNextTask,
+                                WrapRefCounted(this));
+  if (delay.IsPositive()) {
+    // Posting delayed tasks doesn't report whether they will be run.
+    task_runner_->PostDelayedTask(FROM_HERE, std::move(run_next_task), delay);
+    return true;
+  }
+  if (task_runner_->PostTask(FROM_HERE, std::move(run_next_task))) {
+    return true;
+  }
+
+  // Pending tasks would never run, so they are dropped (without the lock held)
+  // instead of being kept until the task runner is destroyed.
+  std::deque<OnceClosure> dropped_tasks;
+  std::lock_guard<std::mutex> guard(mutex_);
+  is_run_scheduled_ = false;
+  dropped_tasks.swap(pending_tasks_);
+  return false;
+}
+
+// static
+void SerialSequencedTaskRunner::OnDelayedTaskReady(
+    scoped_refptr<SerialSequencedTaskRunner> task_runner,
+    OnceClosure task) {
+  task_runner->PostTask(FROM_HERE, std::move(task));
+}
+
+// static
+void SerialSequencedTaskRunner::RunNextTask(
+    scoped_refptr<SerialSequencedTaskRunner> task_runner) {
+  task_runner->RunNextTaskImpl();
+}
+
+void SerialSequencedTaskRunner::RunNextTaskImpl() {
+  OnceClosure task;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    DCHECK(is_run_scheduled_);
+    if (pending_tasks_.empty()) {
+      is_run_scheduled_ = false;
+      return;
+    }
+    task = std::move(pending_tasks_.front());
+    pending_tasks_.pop_front();
+    OnTaskTaken_Locked();
+  }
+
+  RunTask(std::move(task));
+
+  bool should_schedule_run = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    is_run_scheduled_ = false;
+    should_schedule_run = ShouldScheduleRun_Locked();
+  }
+  if (should_schedule_run) {
+    ScheduleRun();
+  }
+}
+
+}  // namespace detail
+}  // namespace base
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_delta.h"
+
+namespace base {
+namespace detail {
+
+// Base of sequenced task runners which keep their tasks in their own queue and
+// run them (in order) on top of another sequenced task runner. Only a single
+// task at a time is handed over to the underlying task runner, so that tasks
+// from other sequences are interleaved with these and subclasses can decide
+// about each task right before it's run.
+//
+// Delayed tasks are kept by the underlying task runner until they are due and
+// only then are they queued. Pending tasks are dropped once the underlying task
+// runner stops accepting tasks, as they would never run.
+class SerialSequencedTaskRunner : public SequencedTaskRunner {
+ public:
+  // SequencedTaskRunner
+  bool PostDelayedTask(SourceLocation location,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  bool RunsTasksInCurrentSequence() const override;
+
+ protected:
+  explicit SerialSequencedTaskRunner(
+      scoped_refptr<SequencedTaskRunner> task_runner);
+
+  // Moves |task| to |pending_tasks_| unless it's rejected (in which case false
+  // is returned). Task dropped to make space for |task| (if any) is moved to
+  // |dropped_task|, so that both are destroyed without the lock held.
+  virtual bool QueueTask_Locked(OnceClosure& task, OnceClosure& dropped_task);
+  // Returns delay after which the next pending task should be run.
+  virtual TimeDelta GetRunDelay_Locked();
+  // Called when the next pending task is taken out of the queue.
+  virtual void OnTaskTaken_Locked() {}
+  // Runs a task taken out of the queue.
+  virtual void RunTask(OnceClosure task);
+
+  // Returns true if the caller should schedule the execution of tasks.
+  bool ShouldScheduleRun_Locked();
+  bool ScheduleRun();
+
+  const scoped_refptr<SequencedTaskRunner> task_runner_;
+
+  std::mutex mutex_;
+  // Guarded by |mutex_|.
+  std::deque<OnceClosure> pending_tasks_;
+
+ private:
+  static void OnDelayedTaskReady(
+      scoped_refptr<SerialSequencedTaskRunner> task_runner,
+      OnceClosure task);
+  static void RunNextTask(scoped_refptr<SerialSequencedTaskRunner> task_runner);
+
+  void RunNextTaskImpl();
+
+  // Guarded by |mutex_|.
+  bool is_run_scheduled_ = false;
+};
+
+}  // namespace detail
+}  // namespace base
@@ -0,0 +1,229 @@
+#include "base/threading/task_group.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace base {
+
+class TaskGroup::State : public RefCountedThreadSafe<State> {
+ public:
+  State() = default;
+
+  // Returns the identifier of the new member or `std::nullopt` if the group
+  // was already cancelled.
+  std::optional<uint64_t> AddTask(OnceClosure task) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (IsCancelled()) {
+      return std::nullopt;
+    }
+    const uint64_t task_id = next_task_id_++;
+    pending_tasks_.emplace(task_id, std::move(task));
+    return task_id;
+  }
+
+  void RunTask(uint64_t task_id) {
+    OnceClosure task;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = pending_tasks_.find(task_id);
+      if (it == pending_tasks_.end()) {
+        return;
+      }
+      task = std::move(it->second);
+      pending_tasks_.erase(it);
+      ++running_tasks_count_;
+    }
+
+    std::move(task).Run();
+
+    OnceClosure on_joined;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      --running_tasks_count_;
+      on_joined = TakeJoinCallbackIfJoined_Locked();
+    }
+    PostJoinCallback(std::move(on_joined));
+  }
+
+  // Called for members that were dropped without being run.
+  void DropTask(uint64_t task_id) {
+    OnceClosure task;
+    OnceClosure on_joined;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = pending_tasks_.find(task_id);
+      if (it == pending_tasks_.end()) {
+        return;
+      }
+      task = std::move(it->second);
+      pending_tasks_.erase(it);
+      on_joined = TakeJoinCallbackIfJoined_Locked();
+    }
+    PostJoinCallback(std::move(on_joined));
+  }
+
+  void Join(OnceClosure on_joined) {
+    DCHECK(on_joined);
+    DCHECK(SequencedTaskRunnerHandle::IsSet());
+
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      DCHECK(!on_joined_ && !on_joined_task_runner_)
+          << "TaskGroup can be joined only once";
+      on_joined_ = std::move(on_joined);
+      on_joined_task_runner_ = SequencedTaskRunnerHandle::Get();
+      on_joined = TakeJoinCallbackIfJoined_Locked();
+    }
+    PostJoinCallback(std::move(on_joined));
+  }
+
+  void Cancel() {
+    std::unordered_map<uint64_t, OnceClosure> cancelled_tasks;
+    OnceClosure on_joined;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      is_cancelled_.store(true, std::memory_order_relaxed);
+      cancelled_tasks.swap(pending_tasks_);
+      on_joined = TakeJoinCallbackIfJoined_Locked();
+    }
+    // Tasks are destroyed without the lock held, but before the group is
+    // reported as joined.
+    cancelled_tasks.clear();
+    PostJoinCallback(std::move(on_joined));
+  }
+
+  // May be called without the lock held (e.g. by message pumps looking for
+  // cancelled tasks).
+  bool IsCancelled() const {
+    return is_cancelled_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPendingTasksCount() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return pending_tasks_.size() + running_tasks_count_;
+  }
+
+ private:
+  friend class RefCountedThreadSafe<State>;
+  ~State() = default;
+
+  // Returns the join callback if it's set and there are no members left.
+  OnceClosure TakeJoinCallbackIfJoined_Locked() {
+    if (!pending_tasks_.empty() || running_tasks_count_ > 0) {
+      return {};
+    }
+    return std::move(on_joined_);
+  }
+
+  // |on_joined_task_runner_| is set before the join callback can be taken and
+  // never changes afterwards, so it can be used without the lock held.
+  void PostJoinCallback(OnceClosure on_joined) {
+    if (on_joined) {
+      on_joined_task_runner_->PostTask(FROM_HERE, std::move(on_joined));
+    }
+  }
+
+  std::mutex mutex_;
+  std::atomic_bool is_cancelled_{false};
+  uint64_t next_task_id_ = 0;
+  std::unordered_map<uint64_t, OnceClosure> pending_tasks_;
+  size_t running_tasks_count_ = 0;
+  OnceClosure on_joined_;
+  scoped_refptr<SequencedTaskRunner> on_joined_task_runner_;
+};
+
+// Callback state of the task posted for each member of a group. It only refers
+// to the member (owned by the group), so cancelling the group frees the
+// member's resources right away, and it reports itself as cancelled, so that
+// message pumps drop it instead of dispatching it.
+class TaskGroup::MemberState {
+ public:
+  static constexpr bool kIsCancellable = true;
+
+  MemberState(scoped_refptr<State> state, uint64_t task_id)
+      : state_(std::move(state)), task_id_(task_id) {}
+
+  MemberState(MemberState&& other) noexcept
+      : state_(std::exchange(other.state_, nullptr)),
+        task_id_(other.task_id_) {}
+
+  MemberState& operator=(MemberState&&) = delete;
+
+  ~MemberState() {
+    if (state_) {
+      state_->DropTask(task_id_);
+    }
+  }
+
+  void RunOnce() { std::exchange(state_, nullptr)->RunTask(task_id_); }
+
+  bool QueryCancellation(detail::CancellationQueryMode mode) const {
+    const bool is_cancelled = state_->IsCancelled();
+    return mode == detail::CancellationQueryMode::kIsCancelled ? is_cancelled
+                                                               : !is_cancelled;
+  }
+
+ private:
+  scoped_refptr<State> state_;
+  uint64_t task_id_;
+};
+
+TaskGroup::TaskGroup() : state_(MakeRefCounted<State>()) {}
+
+TaskGroup::~TaskGroup() {
+  Cancel();
+}
+
+bool TaskGroup::PostTask(TaskRunner& task_runner,
+                         SourceLocation location,
+                         OnceClosure task) {
+  DCHECK(task);
+
+  const auto task_id = state_->AddTask(std::move(task));
+  if (!task_id) {
+    return false;
+  }
+
+  // If the task can't be posted, destroying it drops the member.
+  return task_runner.PostTask(
+      std::move(location),
+      detail::BindAccessHelper::Create<OnceClosure, MemberState, false>(
+          state_, *task_id));
+}
+
+void TaskGroup::Join(OnceClosure on_joined) {
+  state_->Join(std::move(on_joined));
+}
+
+void TaskGroup::Cancel() {
+  state_->Cancel();
+}
+
+RepeatingClosure TaskGroup::GetCancelCallback() const {
+  return BindRepeating(&TaskGroup::CancelState, state_);
+}
+
+bool TaskGroup::IsCancelled() const {
+  return state_->IsCancelled();
+}
+
+size_t TaskGroup::GetPendingTasksCount() const {
+  return state_->GetPendingTasksCount();
+}
+
+// static
+void TaskGroup::CancelState(scoped_refptr<State> state) {
+  state->Cancel();
+}
+
+}  // namespace base
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/source_location.h"
+#include "base/task_runner.h"
+
+namespace base {
+
+// Group of related tasks, possibly posted to many different task runners,
+// that can be joined or cancelled together.
+//
+// Tasks posted with `PostTask()` become members of the group. `Join()` posts
+// a callback to the current sequence once all the members either finished
+// running or were cancelled. `Cancel()` cancels all the members that didn't
+// start running yet at once - they are destroyed right away and the task
+// runners they were posted to drop them without running. Members that are
+// already running are not interrupted, but the group is joined only after they
+// finish. Members can cancel the rest of the group (e.g. on failure) with the
+// callback returned by `GetCancelCallback()`.
+//
+// Destroying the group cancels it. All methods are thread-safe.
+class TaskGroup {
+ public:
+  TaskGroup();
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  // Posts |task| to |task_runner| as a member of this group. Returns false
+  // (and destroys |task|) if the group was already cancelled or if the task
+  // could not be posted.
+  bool PostTask(TaskRunner& task_runner,
+                SourceLocation location,
+                OnceClosure task);
+
+  // Posts |on_joined| to the current sequence once there are no members left
+  // to run. Can be called at most once. Use `IsCancelled()` to check if all
+  // the members were run.
+  void Join(OnceClosure on_joined);
+
+  // Cancels all the members that didn't start running yet and prevents new
+  // ones from being posted.
+  void Cancel();
+
+  // Returns a callback that cancels this group. It can outlive the group and
+  // be run on any sequence.
+  RepeatingClosure GetCancelCallback() const;
+
+  bool IsCancelled() const;
+
+  // Number of members that are waiting to be run or are running.
+  size_t GetPendingTasksCount() const;
+
+ private:
+  class State;
+  class MemberState;
+
+  static void CancelState(scoped_refptr<State> state);
+
+  const scoped_refptr<State> state_;
+};
+
+}  // namespace base
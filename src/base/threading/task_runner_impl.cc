@@ -1,5 +1,8 @@
 #include "base/threading/task_runner_impl.h"
 
+#include <atomic>
+#include <memory>
+
 #include "base/sequenced_task_runner_helpers.h"
 #include "base/threading/delayed_task_manager.h"
 #include "base/time/time_ticks.h"
@@ -12,29 +15,52 @@ bool DoPostTask(
     OnceClosure task,
     TimeDelta delay,
     std::shared_ptr<DelayedTaskManager>& delayed_task_manager,
-    const std::weak_ptr<MessagePump>& weak_pump,
-    std::weak_ptr<SequencedTaskRunner> target_sequenced_task_runner,
+    const scoped_refptr<MessagePump>& pump,
+    scoped_refptr<SequencedTaskRunner> target_sequenced_task_runner,
     std::optional<SequenceId> sequence_id = {},
-    const std::optional<MessagePump::ExecutorId>& executor_id = {}) {
+    const std::optional<MessagePump::ExecutorId>& executor_id = {},
+    std::optional<MessagePump::ConcurrencyLimit> concurrency_limit = {}) {
   (void)location;
 
+  MessagePump::PendingTask pending_task{
+      std::move(task),
+      std::move(sequence_id),
+      executor_id,
+      std::move(target_sequenced_task_runner),
+      {},
+      {},
+      concurrency_limit};
   if (delay.IsZero() || delay.IsNegative()) {
-    if (auto pump = weak_pump.lock()) {
-      return pump->QueuePendingTask({std::move(task), std::move(sequence_id),
-                                     executor_id,
-                                     std::move(target_sequenced_task_runner)});
-    }
+    return pump->QueuePendingTask(std::move(pending_task));
   } else {
     delayed_task_manager->QueueDelayedTask(DelayedTaskManager::DelayedTask{
-        (TimeTicks::Now() + delay), weak_pump,
-        MessagePump::PendingTask{std::move(task), std::move(sequence_id),
-                                 executor_id,
-                                 std::move(target_sequenced_task_runner)}});
+        (TimeTicks::Now() + delay), pump, std::move(pending_task)});
   }
 
   return false;
 }
 
+bool DoPostTaskWithExpiry(
+    SourceLocation location,
+    OnceClosure task,
+    TimeTicks expiration_time,
+    OnceClosure on_dropped,
+    const scoped_refptr<MessagePump>& pump,
+    scoped_refptr<SequencedTaskRunner> target_sequenced_task_runner,
+    std::optional<SequenceId> sequence_id = {},
+    const std::optional<MessagePump::ExecutorId>& executor_id = {},
+    std::optional<MessagePump::ConcurrencyLimit> concurrency_limit = {}) {
+  return pump->QueuePendingTask(
+      {std::move(task),
+       std::move(sequence_id),
+       executor_id,
+       std::move(target_sequenced_task_runner),
+       {},
+       std::make_unique<MessagePump::TaskExpiry>(MessagePump::TaskExpiry{
+           expiration_time, std::move(on_dropped), std::move(location)}),
+       concurrency_limit});
+}
+
 bool DoRunsInCurrentSequence(const SequenceId& sequence_id) {
   return detail::CurrentSequenceIdHelper::IsCurrentSequence(sequence_id);
 }
@@ -45,10 +71,10 @@ bool DoRunsInCurrentSequence(const SequenceId& sequence_id) {
 //
 
 // static
-std::shared_ptr<TaskRunnerImpl> TaskRunnerImpl::Create(
-    std::weak_ptr<MessagePump> pump,
+scoped_refptr<TaskRunnerImpl> TaskRunnerImpl::Create(
+    scoped_refptr<MessagePump> pump,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager) {
-  return std::shared_ptr<TaskRunnerImpl>(
+  return WrapRefCounted(
       new TaskRunnerImpl(std::move(pump), std::move(delayed_task_manager)));
 }
 
@@ -59,24 +85,78 @@ bool TaskRunnerImpl::PostDelayedTask(SourceLocation location,
                     delayed_task_manager_, pump_, {});
 }
 
+bool TaskRunnerImpl::PostTaskWithExpiry(SourceLocation location,
+                                        OnceClosure task,
+                                        TimeTicks expiration_time,
+                                        OnceClosure on_dropped) {
+  return DoPostTaskWithExpiry(std::move(location), std::move(task),
+                              expiration_time, std::move(on_dropped), pump_,
+                              {});
+}
+
 TaskRunnerImpl::TaskRunnerImpl(
-    std::weak_ptr<MessagePump> pump,
+    scoped_refptr<MessagePump> pump,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager)
     : pump_(std::move(pump)),
       delayed_task_manager_(std::move(delayed_task_manager)) {
   DCHECK(delayed_task_manager_);
 }
 
+//
+// ParallelTaskRunnerImpl
+//
+
+// static
+scoped_refptr<ParallelTaskRunnerImpl> ParallelTaskRunnerImpl::Create(
+    scoped_refptr<MessagePump> pump,
+    size_t max_concurrency,
+    std::shared_ptr<DelayedTaskManager> delayed_task_manager) {
+  static std::atomic_uint64_t next_concurrency_group_id = 0;
+  return WrapRefCounted(new ParallelTaskRunnerImpl(
+      std::move(pump),
+      MessagePump::ConcurrencyLimit{next_concurrency_group_id++,
+                                    max_concurrency},
+      std::move(delayed_task_manager)));
+}
+
+bool ParallelTaskRunnerImpl::PostDelayedTask(SourceLocation location,
+                                             OnceClosure task,
+                                             TimeDelta delay) {
+  return DoPostTask(std::move(location), std::move(task), std::move(delay),
+                    delayed_task_manager_, pump_, {}, {}, {},
+                    concurrency_limit_);
+}
+
+bool ParallelTaskRunnerImpl::PostTaskWithExpiry(SourceLocation location,
+                                                OnceClosure task,
+                                                TimeTicks expiration_time,
+                                                OnceClosure on_dropped) {
+  return DoPostTaskWithExpiry(std::move(location), std::move(task),
+                              expiration_time, std::move(on_dropped), pump_,
+                              {}, {}, {}, concurrency_limit_);
+}
+
+ParallelTaskRunnerImpl::ParallelTaskRunnerImpl(
+    scoped_refptr<MessagePump> pump,
+    MessagePump::ConcurrencyLimit concurrency_limit,
+    std::shared_ptr<DelayedTaskManager> delayed_task_manager)
+    : pump_(std::move(pump)),
+      concurrency_limit_(concurrency_limit),
+      delayed_task_manager_(std::move(delayed_task_manager)) {
+  DCHECK_GT(concurrency_limit_.max_concurrency, 0u);
+  DCHECK(delayed_task_manager_);
+}
+
 //
 // SequencedTaskRunnerImpl
 //
 
 // static
-std::shared_ptr<SequencedTaskRunnerImpl> SequencedTaskRunnerImpl::Create(
-    std::weak_ptr<MessagePump> pump,
+scoped_refptr<SequencedTaskRunnerImpl> SequencedTaskRunnerImpl::Create(
+    scoped_refptr<MessagePump> pump,
     SequenceId sequence_id,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager) {
-  return std::shared_ptr<SequencedTaskRunnerImpl>(new SequencedTaskRunnerImpl(
+  return WrapRefCounted(new SequencedTaskRunnerImpl(
       std::move(pump), sequence_id, std::move(delayed_task_manager)));
 }
 
@@ -84,16 +164,86 @@ bool SequencedTaskRunnerImpl::PostDelayedTask(SourceLocation location,
                                               OnceClosure task,
                                               TimeDelta delay) {
   return DoPostTask(std::move(location), std::move(task), std::move(delay),
-                    delayed_task_manager_, pump_, weak_from_this(),
-                    sequence_id_);
+                    delayed_task_manager_, pump_, this, sequence_id_);
+}
+
+bool SequencedTaskRunnerImpl::PostTaskWithExpiry(SourceLocation location,
+                                                 OnceClosure task,
+                                                 TimeTicks expiration_time,
+                                                 OnceClosure on_dropped) {
+  return DoPostTaskWithExpiry(std::move(location), std::move(task),
+                              expiration_time, std::move(on_dropped), pump_,
+                              this, sequence_id_);
 }
 
 bool SequencedTaskRunnerImpl::RunsTasksInCurrentSequence() const {
   return DoRunsInCurrentSequence(sequence_id_);
 }
 
+detail::SequenceLocalStorageMap*
+SequencedTaskRunnerImpl::GetSequenceLocalStorageMap() {
+  return &sequence_local_storage_map_;
+}
+
 SequencedTaskRunnerImpl::SequencedTaskRunnerImpl(
-    std::weak_ptr<MessagePump> pump,
+    scoped_refptr<MessagePump> pump,
+    SequenceId sequence_id,
+    std::shared_ptr<DelayedTaskManager> delayed_task_manager)
+    : pump_(std::move(pump)),
+      sequence_id_(std::move(sequence_id)),
+      delayed_task_manager_(std::move(delayed_task_manager)) {
+  DCHECK(delayed_task_manager_);
+}
+
+//
+// DeadlineTaskRunnerImpl
+//
+
+// static
+scoped_refptr<DeadlineTaskRunnerImpl> DeadlineTaskRunnerImpl::Create(
+    scoped_refptr<MessagePump> pump,
+    SequenceId sequence_id,
+    std::shared_ptr<DelayedTaskManager> delayed_task_manager) {
+  return WrapRefCounted(new DeadlineTaskRunnerImpl(
+      std::move(pump), sequence_id, std::move(delayed_task_manager)));
+}
+
+bool DeadlineTaskRunnerImpl::PostDelayedTask(SourceLocation location,
+                                             OnceClosure task,
+                                             TimeDelta delay) {
+  return DoPostTask(std::move(location), std::move(task), std::move(delay),
+                    delayed_task_manager_, pump_, this, sequence_id_);
+}
+
+bool DeadlineTaskRunnerImpl::PostTaskWithDeadline(SourceLocation location,
+                                                  OnceClosure task,
+                                                  TimeTicks deadline) {
+  (void)location;
+
+  return pump_->QueuePendingTask(
+      {std::move(task), sequence_id_, {}, this, deadline});
+}
+
+bool DeadlineTaskRunnerImpl::PostTaskWithExpiry(SourceLocation location,
+                                                OnceClosure task,
+                                                TimeTicks expiration_time,
+                                                OnceClosure on_dropped) {
+  return DoPostTaskWithExpiry(std::move(location), std::move(task),
+                              expiration_time, std::move(on_dropped), pump_,
+                              this, sequence_id_);
+}
+
+bool DeadlineTaskRunnerImpl::RunsTasksInCurrentSequence() const {
+  return DoRunsInCurrentSequence(sequence_id_);
+}
+
+detail::SequenceLocalStorageMap*
+DeadlineTaskRunnerImpl::GetSequenceLocalStorageMap() {
+  return &sequence_local_storage_map_;
+}
+
+DeadlineTaskRunnerImpl::DeadlineTaskRunnerImpl(
+    scoped_refptr<MessagePump> pump,
     SequenceId sequence_id,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager)
     : pump_(std::move(pump)),
@@ -107,30 +257,51 @@ SequencedTaskRunnerImpl::SequencedTaskRunnerImpl(
 //
 
 // static
-std::shared_ptr<SingleThreadTaskRunnerImpl> SingleThreadTaskRunnerImpl::Create(
-    std::weak_ptr<MessagePump> pump,
+scoped_refptr<SingleThreadTaskRunnerImpl> SingleThreadTaskRunnerImpl::Create(
+    scoped_refptr<MessagePump> pump,
     SequenceId sequence_id,
     MessagePump::ExecutorId executor_id,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager) {
-  return std::shared_ptr<SingleThreadTaskRunnerImpl>(
-      new SingleThreadTaskRunnerImpl(std::move(pump), sequence_id, executor_id,
-                                     std::move(delayed_task_manager)));
+  return WrapRefCounted(new SingleThreadTaskRunnerImpl(
+      std::move(pump), sequence_id, executor_id,
+      std::move(delayed_task_manager)));
 }
 
 bool SingleThreadTaskRunnerImpl::PostDelayedTask(SourceLocation location,
                                                  OnceClosure task,
                                                  TimeDelta delay) {
   return DoPostTask(std::move(location), std::move(task), std::move(delay),
-                    delayed_task_manager_, pump_, weak_from_this(),
-                    sequence_id_, executor_id_);
+                    delayed_task_manager_, pump_, this, sequence_id_,
+                    executor_id_);
+}
+
+bool SingleThreadTaskRunnerImpl::PostIdleTask(
+    SourceLocation location,
+    OnceCallback<void(TimeTicks deadline)> task) {
+  return pump_->QueueIdleTask(
+      {std::move(task), sequence_id_, executor_id_, this, std::move(location)});
+}
+
+bool SingleThreadTaskRunnerImpl::PostTaskWithExpiry(SourceLocation location,
+                                                    OnceClosure task,
+                                                    TimeTicks expiration_time,
+                                                    OnceClosure on_dropped) {
+  return DoPostTaskWithExpiry(std::move(location), std::move(task),
+                              expiration_time, std::move(on_dropped), pump_,
+                              this, sequence_id_, executor_id_);
 }
 
 bool SingleThreadTaskRunnerImpl::RunsTasksInCurrentSequence() const {
   return DoRunsInCurrentSequence(sequence_id_);
 }
 
+detail::SequenceLocalStorageMap*
+SingleThreadTaskRunnerImpl::GetSequenceLocalStorageMap() {
+  return &sequence_local_storage_map_;
+}
+
 SingleThreadTaskRunnerImpl::SingleThreadTaskRunnerImpl(
-    std::weak_ptr<MessagePump> pump,
+    scoped_refptr<MessagePump> pump,
     SequenceId sequence_id,
     MessagePump::ExecutorId executor_id,
     std::shared_ptr<DelayedTaskManager> delayed_task_manager)
@@ -3,10 +3,13 @@
 #include <memory>
 #include <optional>
 
+#include "base/deadline_task_runner.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/message_loop/message_pump.h"
 #include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
 #include "base/task_runner.h"
+#include "base/threading/sequence_local_storage_map.h"
 
 namespace base {
 
@@ -14,30 +17,61 @@ class DelayedTaskManager;
 
 class TaskRunnerImpl : public TaskRunner {
  public:
-  static std::shared_ptr<TaskRunnerImpl> Create(
-      std::weak_ptr<MessagePump> pump,
+  static scoped_refptr<TaskRunnerImpl> Create(
+      scoped_refptr<MessagePump> pump,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
 
   // TaskRunner
   bool PostDelayedTask(SourceLocation location,
                        OnceClosure task,
                        TimeDelta delay) override;
+  bool PostTaskWithExpiry(SourceLocation location,
+                          OnceClosure task,
+                          TimeTicks expiration_time,
+                          OnceClosure on_dropped) override;
 
  private:
   explicit TaskRunnerImpl(
-      std::weak_ptr<MessagePump> pump,
+      scoped_refptr<MessagePump> pump,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
 
-  std::weak_ptr<MessagePump> pump_;
+  scoped_refptr<MessagePump> pump_;
   std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
 };
 
-class SequencedTaskRunnerImpl
-    : public SequencedTaskRunner,
-      public std::enable_shared_from_this<SequencedTaskRunnerImpl> {
+// Runs at most |max_concurrency| of its tasks at once. The limit is enforced
+// by the pump, so that the remaining executors can run other tasks.
+class ParallelTaskRunnerImpl : public TaskRunner {
  public:
-  static std::shared_ptr<SequencedTaskRunnerImpl> Create(
-      std::weak_ptr<MessagePump> pump,
+  static scoped_refptr<ParallelTaskRunnerImpl> Create(
+      scoped_refptr<MessagePump> pump,
+      size_t max_concurrency,
+      std::shared_ptr<DelayedTaskManager> delayed_task_manager);
+
+  // TaskRunner
+  bool PostDelayedTask(SourceLocation location,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  bool PostTaskWithExpiry(SourceLocation location,
+                          OnceClosure task,
+                          TimeTicks expiration_time,
+                          OnceClosure on_dropped) override;
+
+ private:
+  ParallelTaskRunnerImpl(
+      scoped_refptr<MessagePump> pump,
+      MessagePump::ConcurrencyLimit concurrency_limit,
+      std::shared_ptr<DelayedTaskManager> delayed_task_manager);
+
+  scoped_refptr<MessagePump> pump_;
+  MessagePump::ConcurrencyLimit concurrency_limit_;
+  std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
+};
+
+class SequencedTaskRunnerImpl : public SequencedTaskRunner {
+ public:
+  static scoped_refptr<SequencedTaskRunnerImpl> Create(
+      scoped_refptr<MessagePump> pump,
       SequenceId sequence_id,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
 
@@ -45,25 +79,62 @@ class SequencedTaskRunnerImpl
   bool PostDelayedTask(SourceLocation location,
                        OnceClosure task,
                        TimeDelta delay) override;
+  bool PostTaskWithExpiry(SourceLocation location,
+                          OnceClosure task,
+                          TimeTicks expiration_time,
+                          OnceClosure on_dropped) override;
   bool RunsTasksInCurrentSequence() const override;
+  detail::SequenceLocalStorageMap* GetSequenceLocalStorageMap() override;
 
  private:
   SequencedTaskRunnerImpl(
-      std::weak_ptr<MessagePump> pump,
+      scoped_refptr<MessagePump> pump,
+      SequenceId sequence_id,
+      std::shared_ptr<DelayedTaskManager> delayed_task_manager);
+
+  scoped_refptr<MessagePump> pump_;
+  SequenceId sequence_id_;
+  std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
+  detail::SequenceLocalStorageMap sequence_local_storage_map_;
+};
+
+class DeadlineTaskRunnerImpl : public DeadlineTaskRunner {
+ public:
+  static scoped_refptr<DeadlineTaskRunnerImpl> Create(
+      scoped_refptr<MessagePump> pump,
+      SequenceId sequence_id,
+      std::shared_ptr<DelayedTaskManager> delayed_task_manager);
+
+  // DeadlineTaskRunner
+  bool PostDelayedTask(SourceLocation location,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  bool PostTaskWithExpiry(SourceLocation location,
+                          OnceClosure task,
+                          TimeTicks expiration_time,
+                          OnceClosure on_dropped) override;
+  bool PostTaskWithDeadline(SourceLocation location,
+                            OnceClosure task,
+                            TimeTicks deadline) override;
+  bool RunsTasksInCurrentSequence() const override;
+  detail::SequenceLocalStorageMap* GetSequenceLocalStorageMap() override;
+
+ private:
+  DeadlineTaskRunnerImpl(
+      scoped_refptr<MessagePump> pump,
       SequenceId sequence_id,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
 
-  std::weak_ptr<MessagePump> pump_;
+  scoped_refptr<MessagePump> pump_;
   SequenceId sequence_id_;
   std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
+  detail::SequenceLocalStorageMap sequence_local_storage_map_;
 };
 
-class SingleThreadTaskRunnerImpl
-    : public SingleThreadTaskRunner,
-      public std::enable_shared_from_this<SingleThreadTaskRunnerImpl> {
+class SingleThreadTaskRunnerImpl : public SingleThreadTaskRunner {
  public:
-  static std::shared_ptr<SingleThreadTaskRunnerImpl> Create(
-      std::weak_ptr<MessagePump> pump,
+  static scoped_refptr<SingleThreadTaskRunnerImpl> Create(
+      scoped_refptr<MessagePump> pump,
       SequenceId sequence_id,
       MessagePump::ExecutorId executor_id,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
@@ -72,19 +143,27 @@ class SingleThreadTaskRunnerImpl
   bool PostDelayedTask(SourceLocation location,
                        OnceClosure task,
                        TimeDelta delay) override;
+  bool PostTaskWithExpiry(SourceLocation location,
+                          OnceClosure task,
+                          TimeTicks expiration_time,
+                          OnceClosure on_dropped) override;
+  bool PostIdleTask(SourceLocation location,
+                    OnceCallback<void(TimeTicks deadline)> task) override;
   bool RunsTasksInCurrentSequence() const override;
+  detail::SequenceLocalStorageMap* GetSequenceLocalStorageMap() override;
 
  private:
   SingleThreadTaskRunnerImpl(
-      std::weak_ptr<MessagePump> pump,
+      scoped_refptr<MessagePump> pump,
       SequenceId sequence_id,
       MessagePump::ExecutorId executor_id,
       std::shared_ptr<DelayedTaskManager> delayed_task_manager);
 
-  std::weak_ptr<MessagePump> pump_;
+  scoped_refptr<MessagePump> pump_;
   SequenceId sequence_id_;
   MessagePump::ExecutorId executor_id_;
   std::shared_ptr<DelayedTaskManager> delayed_task_manager_;
+  detail::SequenceLocalStorageMap sequence_local_storage_map_;
 };
 
 }  // namespace base
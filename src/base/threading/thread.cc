@@ -26,17 +26,16 @@ std::thread::id Thread::Id() const {
 
 void Thread::Start() {
   const size_t executor_count = 1;
-  auto message_pump = std::make_shared<MessagePumpImpl>(executor_count);
+  message_pump_ = MakeRefCounted<MessagePumpImpl>(executor_count);
 
   const MessagePump::ExecutorId executor_id = 0;
-  message_loop_ = std::make_unique<MessageLoopImpl>(executor_id, message_pump);
+  message_loop_ = std::make_unique<MessageLoopImpl>(executor_id, message_pump_);
   thread_ =
       std::make_unique<std::thread>(&MessageLoop::Run, message_loop_.get());
 
-  std::weak_ptr<MessagePump> weak_message_pump = message_pump;
   sequence_id_ = detail::SequenceIdGenerator::GetNextSequenceId();
   task_runner_ = SingleThreadTaskRunnerImpl::Create(
-      weak_message_pump, *sequence_id_, executor_id,
+      message_pump_, *sequence_id_, executor_id,
       DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
 }
 
@@ -55,14 +54,18 @@ void Thread::Stop(SourceLocation location, OnceClosure last_task) {
   if (thread_) {
     thread_->join();
   }
+  if (message_pump_) {
+    message_pump_->DropPendingTasks();
+  }
 
   thread_.reset();
   message_loop_.reset();
+  message_pump_.reset();
   sequence_id_.reset();
   task_runner_.reset();
 }
 
-std::shared_ptr<SingleThreadTaskRunner> Thread::TaskRunner() {
+scoped_refptr<SingleThreadTaskRunner> Thread::TaskRunner() {
   return task_runner_;
 }
 
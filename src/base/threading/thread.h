@@ -22,15 +22,16 @@ class Thread {
   void Stop(SourceLocation location, OnceClosure last_task);
 
   std::thread::id Id() const;
-  std::shared_ptr<SingleThreadTaskRunner> TaskRunner();
+  scoped_refptr<SingleThreadTaskRunner> TaskRunner();
 
   void FlushForTesting();
 
  private:
+  scoped_refptr<MessagePump> message_pump_;
   std::unique_ptr<MessageLoop> message_loop_;
   std::unique_ptr<std::thread> thread_;
   std::optional<base::SequenceId> sequence_id_;
-  std::shared_ptr<SingleThreadTaskRunner> task_runner_;
+  scoped_refptr<SingleThreadTaskRunner> task_runner_;
 };
 
 }  // namespace base
@@ -27,7 +27,7 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::Start() {
-  auto message_pump = std::make_shared<MessagePumpImpl>(initial_size_);
+  auto message_pump = MakeRefCounted<MessagePumpImpl>(initial_size_);
 
   for (size_t thread_idx = 0; thread_idx < initial_size_; ++thread_idx) {
     const MessagePump::ExecutorId executor_id = thread_idx;
@@ -39,10 +39,9 @@ void ThreadPool::Start() {
     threads_.push_back({std::move(message_loop), std::move(thread)});
   }
 
-  std::weak_ptr<MessagePump> weak_message_pump = message_pump;
+  pump_ = message_pump;
   task_runner_ = TaskRunnerImpl::Create(
-      std::move(weak_message_pump),
-      DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
+      pump_, DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
 }
 
 void ThreadPool::Stop() {
@@ -51,19 +50,36 @@ void ThreadPool::Stop() {
     thread.thread->join();
   }
   threads_.clear();
+
+  if (pump_) {
+    pump_->DropPendingTasks();
+  }
 }
 
-std::shared_ptr<TaskRunner> ThreadPool::GetTaskRunner() const {
+scoped_refptr<TaskRunner> ThreadPool::GetTaskRunner() const {
   return task_runner_;
 }
 
-std::shared_ptr<SequencedTaskRunner> ThreadPool::CreateSequencedTaskRunner() {
+scoped_refptr<TaskRunner> ThreadPool::CreateParallelTaskRunner(
+    size_t max_concurrency) {
+  return ParallelTaskRunnerImpl::Create(
+      pump_, max_concurrency,
+      DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
+}
+
+scoped_refptr<SequencedTaskRunner> ThreadPool::CreateSequencedTaskRunner() {
   return SequencedTaskRunnerImpl::Create(
       pump_, detail::SequenceIdGenerator::GetNextSequenceId(),
       DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
 }
 
-std::shared_ptr<SingleThreadTaskRunner>
+scoped_refptr<DeadlineTaskRunner> ThreadPool::CreateDeadlineTaskRunner() {
+  return DeadlineTaskRunnerImpl::Create(
+      pump_, detail::SequenceIdGenerator::GetNextSequenceId(),
+      DelayedTaskManagerSharedInstance::GetOrCreateSharedInstance());
+}
+
+scoped_refptr<SingleThreadTaskRunner>
 ThreadPool::CreateSingleThreadTaskRunner() {
   std::uniform_int_distribution<MessagePump::ExecutorId>
       executor_id_distribution(0, initial_size_ - 1);
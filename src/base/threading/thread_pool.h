@@ -1,9 +1,9 @@
 #pragma once
 
-#include <memory>
 #include <random>
 #include <vector>
 
+#include "base/deadline_task_runner.h"
 #include "base/single_thread_task_runner.h"
 
 namespace base {
@@ -18,17 +18,22 @@ class ThreadPool {
   void Start();
   void Stop();
 
-  std::shared_ptr<TaskRunner> GetTaskRunner() const;
-  std::shared_ptr<SequencedTaskRunner> CreateSequencedTaskRunner();
-  std::shared_ptr<SingleThreadTaskRunner> CreateSingleThreadTaskRunner();
+  scoped_refptr<TaskRunner> GetTaskRunner() const;
+  // Creates a task runner which runs at most |max_concurrency| of its tasks at
+  // once (in the order they were posted), leaving the remaining threads to
+  // other task runners.
+  scoped_refptr<TaskRunner> CreateParallelTaskRunner(size_t max_concurrency);
+  scoped_refptr<SequencedTaskRunner> CreateSequencedTaskRunner();
+  scoped_refptr<SingleThreadTaskRunner> CreateSingleThreadTaskRunner();
+  scoped_refptr<DeadlineTaskRunner> CreateDeadlineTaskRunner();
 
  private:
   struct ThreadData;
 
   const size_t initial_size_;
-  std::weak_ptr<MessagePump> pump_;
+  scoped_refptr<MessagePump> pump_;
   std::vector<ThreadData> threads_;
-  std::shared_ptr<TaskRunner> task_runner_;
+  scoped_refptr<TaskRunner> task_runner_;
   std::mt19937 random_generator_;
 };
 
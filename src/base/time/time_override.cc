@@ -0,0 +1,42 @@
+#include "base/time/time_override.h"
+
+#include <chrono>
+
+#include "base/logging.h"
+
+namespace base {
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+namespace detail {
+std::atomic<subtle::TimeTicksNowFunction> g_time_ticks_now_function{
+    &subtle::TimeTicksNowIgnoringOverride};
+}  // namespace detail
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+namespace subtle {
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+ScopedTimeClockOverrides::ScopedTimeClockOverrides(
+    TimeTicksNowFunction time_ticks_override) {
+  DCHECK(time_ticks_override);
+  const auto previous_function = detail::g_time_ticks_now_function.exchange(
+      time_ticks_override, std::memory_order_relaxed);
+  DCHECK_EQ(previous_function, &TimeTicksNowIgnoringOverride)
+      << "Only a single clock override can be active at a time";
+}
+
+ScopedTimeClockOverrides::~ScopedTimeClockOverrides() {
+  detail::g_time_ticks_now_function.store(&TimeTicksNowIgnoringOverride,
+                                          std::memory_order_relaxed);
+}
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+TimeTicks TimeTicksNowIgnoringOverride() {
+  const auto now = std::chrono::steady_clock::now();
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      now.time_since_epoch());
+  return TimeTicks{} + Microseconds(duration.count());
+}
+
+}  // namespace subtle
+}  // namespace base
@@ -0,0 +1,42 @@
+#pragma once
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+#include <atomic>
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+#include "base/time/time_ticks.h"
+
+namespace base {
+namespace subtle {
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+using TimeTicksNowFunction = TimeTicks (*)();
+
+// Overrides the clock used by `TimeTicks::Now()` for the lifetime of this
+// object. Only a single override can be active at a time and it has to be
+// installed and removed while no other thread is using the clock. Intended to
+// be used by tests only (see `base::test::TaskEnvironment`), so it's available
+// only when the testing module is built.
+class ScopedTimeClockOverrides {
+ public:
+  explicit ScopedTimeClockOverrides(TimeTicksNowFunction time_ticks_override);
+  ~ScopedTimeClockOverrides();
+
+  ScopedTimeClockOverrides(const ScopedTimeClockOverrides&) = delete;
+  ScopedTimeClockOverrides& operator=(const ScopedTimeClockOverrides&) =
+      delete;
+};
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+// Returns the current time of the system clock, ignoring any overrides.
+TimeTicks TimeTicksNowIgnoringOverride();
+
+}  // namespace subtle
+
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+namespace detail {
+extern std::atomic<subtle::TimeTicksNowFunction> g_time_ticks_now_function;
+}  // namespace detail
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
+
+}  // namespace base
@@ -1,15 +1,16 @@
 #include "base/time/time_ticks.h"
 
-#include <chrono>
+#include "base/time/time_override.h"
 
 namespace base {
 
 // static
 TimeTicks TimeTicks::Now() {
-  auto now = std::chrono::steady_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-      now.time_since_epoch());
-  return TimeTicks{duration.count()};
+#if defined(LIBBASE_ENABLE_TESTING_HOOKS)
+  return detail::g_time_ticks_now_function.load(std::memory_order_relaxed)();
+#else
+  return subtle::TimeTicksNowIgnoringOverride();
+#endif  // defined(LIBBASE_ENABLE_TESTING_HOOKS)
 }
 
 bool TimeTicks::operator==(TimeTicks other) const {
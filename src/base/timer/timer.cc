@@ -0,0 +1,262 @@
+#include "base/timer/timer.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace base {
+
+namespace detail {
+
+//
+// TimerBase
+//
+
+TimerBase::TimerBase()
+    : location_(FROM_HERE), is_running_(false), weak_factory_(this) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+TimerBase::~TimerBase() = default;
+
+void TimerBase::SetTaskRunner(
+    scoped_refptr<SequencedTaskRunner> task_runner) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!is_running_);
+  DCHECK(task_runner);
+
+  if (scheduled_run_time_) {
+    // Abandon the task posted to the previous task runner.
+    weak_factory_.InvalidateWeakPtrs();
+    scheduled_run_time_.reset();
+  }
+  task_runner_ = std::move(task_runner);
+}
+
+bool TimerBase::IsRunning() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return is_running_;
+}
+
+void TimerBase::Stop() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // Already posted task (if any) is left as-is. It will become a no-op unless
+  // the timer is restarted before it fires, in which case it will be re-used.
+  is_running_ = false;
+  OnStop();
+}
+
+void TimerBase::ScheduleAt(SourceLocation location,
+                           TimeTicks desired_run_time) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  location_ = location;
+  desired_run_time_ = desired_run_time;
+  is_running_ = true;
+
+  if (!task_runner_) {
+    task_runner_ = SequencedTaskRunnerHandle::Get();
+  }
+
+  if (scheduled_run_time_) {
+    if (*scheduled_run_time_ <= desired_run_time_) {
+      // Already posted task will fire early enough. Once it does, it will
+      // re-post itself for the remaining time.
+      return;
+    }
+
+    // Already posted task would fire too late, abandon it.
+    weak_factory_.InvalidateWeakPtrs();
+  }
+
+  PostScheduledTask(TimeTicks::Now());
+}
+
+SourceLocation TimerBase::Location() const {
+  return location_;
+}
+
+TimeTicks TimerBase::DesiredRunTime() const {
+  return desired_run_time_;
+}
+
+void TimerBase::PostScheduledTask(TimeTicks now) {
+  scheduled_run_time_ = std::max(desired_run_time_, now);
+  task_runner_->PostDelayedTask(
+      location_,
+      BindOnce(&TimerBase::OnScheduledTaskInvoked, weak_factory_.GetWeakPtr()),
+      desired_run_time_ - now);
+}
+
+void TimerBase::OnScheduledTaskInvoked() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  scheduled_run_time_.reset();
+  if (!is_running_) {
+    return;
+  }
+
+  const auto now = TimeTicks::Now();
+  if (desired_run_time_ > now) {
+    // Timer was reset to a later time after this task has been posted.
+    PostScheduledTask(now);
+    return;
+  }
+
+  // This may destroy `this`.
+  RunUserTask();
+}
+
+}  // namespace detail
+
+//
+// OneShotTimer
+//
+
+OneShotTimer::OneShotTimer() = default;
+
+OneShotTimer::~OneShotTimer() = default;
+
+void OneShotTimer::Start(SourceLocation location,
+                         TimeDelta delay,
+                         OnceClosure user_task) {
+  DCHECK(user_task);
+  user_task_ = std::move(user_task);
+  ScheduleAt(location, TimeTicks::Now() + delay);
+}
+
+void OneShotTimer::FireNow() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (IsRunning()) {
+    RunUserTask();
+  }
+}
+
+void OneShotTimer::OnStop() {
+  user_task_ = {};
+}
+
+void OneShotTimer::RunUserTask() {
+  auto user_task = std::move(user_task_);
+  Stop();
+  std::move(user_task).Run();
+}
+
+//
+// RetainingOneShotTimer
+//
+
+RetainingOneShotTimer::RetainingOneShotTimer() = default;
+
+RetainingOneShotTimer::~RetainingOneShotTimer() = default;
+
+void RetainingOneShotTimer::Start(SourceLocation location,
+                                  TimeDelta delay,
+                                  RepeatingClosure user_task) {
+  DCHECK(user_task);
+  delay_ = delay;
+  user_task_ = std::move(user_task);
+  ScheduleAt(location, TimeTicks::Now() + delay_);
+}
+
+void RetainingOneShotTimer::Reset() {
+  DCHECK(user_task_);
+  ScheduleAt(Location(), TimeTicks::Now() + delay_);
+}
+
+TimeDelta RetainingOneShotTimer::GetCurrentDelay() const {
+  return delay_;
+}
+
+void RetainingOneShotTimer::OnStop() {}
+
+void RetainingOneShotTimer::RunUserTask() {
+  // The task may restart the timer with another task, so it's run from a copy
+  // to keep its bound state alive until it returns.
+  auto user_task = user_task_;
+  Stop();
+  user_task.Run();
+}
+
+//
+// RepeatingTimer
+//
+
+RepeatingTimer::RepeatingTimer() = default;
+
+RepeatingTimer::~RepeatingTimer() = default;
+
+void RepeatingTimer::Start(SourceLocation location,
+                           TimeDelta delay,
+                           RepeatingClosure user_task) {
+  DCHECK(user_task);
+  delay_ = delay;
+  user_task_ = std::move(user_task);
+  ScheduleAt(location, TimeTicks::Now() + delay_);
+}
+
+void RepeatingTimer::Reset() {
+  DCHECK(user_task_);
+  ScheduleAt(Location(), TimeTicks::Now() + delay_);
+}
+
+TimeDelta RepeatingTimer::GetCurrentDelay() const {
+  return delay_;
+}
+
+void RepeatingTimer::OnStop() {}
+
+void RepeatingTimer::RunUserTask() {
+  // Compute next run time based on the previous desired one so that time spent
+  // on waking up and running the task does not accumulate.
+  const auto now = TimeTicks::Now();
+  auto next_run_time = DesiredRunTime() + delay_;
+  if (next_run_time <= now) {
+    const auto delay_us = delay_.InMicroseconds();
+    if (delay_us > 0) {
+      const auto missed_periods =
+          (now - next_run_time).InMicroseconds() / delay_us;
+      next_run_time += delay_ * (missed_periods + 1);
+    } else {
+      next_run_time = now;
+    }
+  }
+
+  ScheduleAt(Location(), next_run_time);
+
+  // The task may restart the timer with another task, so it's run from a copy
+  // to keep its bound state alive until it returns.
+  auto user_task = user_task_;
+  user_task.Run();
+}
+
+//
+// DeadlineTimer
+//
+
+DeadlineTimer::DeadlineTimer() = default;
+
+DeadlineTimer::~DeadlineTimer() = default;
+
+void DeadlineTimer::Start(SourceLocation location,
+                          TimeTicks deadline,
+                          OnceClosure user_task) {
+  DCHECK(user_task);
+  user_task_ = std::move(user_task);
+  ScheduleAt(location, deadline);
+}
+
+void DeadlineTimer::OnStop() {
+  user_task_ = {};
+}
+
+void DeadlineTimer::RunUserTask() {
+  auto user_task = std::move(user_task_);
+  Stop();
+  std::move(user_task).Run();
+}
+
+}  // namespace base
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/sequenced_task_runner.h"
+#include "base/source_location.h"
+#include "base/time/time_delta.h"
+#include "base/time/time_ticks.h"
+
+namespace base {
+
+namespace detail {
+
+// Common logic of all timers. A timer keeps at most one task posted to its
+// task runner at a time and re-uses it whenever possible, so `Reset()` to a
+// later time and `Stop()` never post nor cancel anything. User tasks are
+// stored inside the timer and run without being re-bound.
+//
+// Timers must be started, stopped and destroyed on the same sequence. Unless
+// set explicitly with `SetTaskRunner()`, tasks are posted to the current
+// sequence's task runner.
+class TimerBase {
+ public:
+  TimerBase(const TimerBase&) = delete;
+  TimerBase& operator=(const TimerBase&) = delete;
+
+  virtual ~TimerBase();
+
+  // Must be called before the timer is started.
+  void SetTaskRunner(scoped_refptr<SequencedTaskRunner> task_runner);
+
+  bool IsRunning() const;
+
+  // Stops the timer. It's a no-op if the timer is not running. The user task
+  // is kept, so timers that retain it can be restarted with `Reset()`.
+  void Stop();
+
+ protected:
+  TimerBase();
+
+  // Schedules the user task to run at |desired_run_time|, re-using already
+  // posted task if it will fire no later than that.
+  void ScheduleAt(SourceLocation location, TimeTicks desired_run_time);
+
+  SourceLocation Location() const;
+  TimeTicks DesiredRunTime() const;
+
+  virtual void OnStop() = 0;
+  virtual void RunUserTask() = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+ private:
+  void PostScheduledTask(TimeTicks now);
+  void OnScheduledTaskInvoked();
+
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+  SourceLocation location_;
+  bool is_running_;
+
+  // Time at which the user task should be run.
+  TimeTicks desired_run_time_;
+  // Time at which the currently posted task will fire, if there is any.
+  std::optional<TimeTicks> scheduled_run_time_;
+
+  WeakPtrFactory<TimerBase> weak_factory_;
+};
+
+}  // namespace detail
+
+// Runs a given task once after a specified delay.
+class OneShotTimer : public detail::TimerBase {
+ public:
+  OneShotTimer();
+  ~OneShotTimer() override;
+
+  void Start(SourceLocation location, TimeDelta delay, OnceClosure user_task);
+
+  // Runs the user task right away (if the timer is running) and stops it.
+  void FireNow();
+
+ private:
+  // detail::TimerBase
+  void OnStop() override;
+  void RunUserTask() override;
+
+  OnceClosure user_task_;
+};
+
+// Runs a given task once after a specified delay, but retains it so that the
+// timer can be restarted with `Reset()` without re-binding the task. The task
+// must not destroy the timer, but it can restart it (also with another task).
+class RetainingOneShotTimer : public detail::TimerBase {
+ public:
+  RetainingOneShotTimer();
+  ~RetainingOneShotTimer() override;
+
+  void Start(SourceLocation location,
+             TimeDelta delay,
+             RepeatingClosure user_task);
+
+  // (Re)starts the timer with the last used delay and task. Must not be called
+  // before the timer was started for the first time.
+  void Reset();
+
+  TimeDelta GetCurrentDelay() const;
+
+ private:
+  // detail::TimerBase
+  void OnStop() override;
+  void RunUserTask() override;
+
+  TimeDelta delay_;
+  RepeatingClosure user_task_;
+};
+
+// Runs a given task periodically with a specified delay between runs. The
+// next run time is computed from the previous *desired* run time instead of
+// the time the task has actually run, so the schedule does not drift. If the
+// timer falls behind by more than a whole period, missed runs are skipped. The
+// task must not destroy the timer, but it can stop or restart it (also with
+// another task).
+class RepeatingTimer : public detail::TimerBase {
+ public:
+  RepeatingTimer();
+  ~RepeatingTimer() override;
+
+  void Start(SourceLocation location,
+             TimeDelta delay,
+             RepeatingClosure user_task);
+
+  // (Re)starts the timer so that the next run will happen after the current
+  // delay from now. Must not be called before the timer was started for the
+  // first time.
+  void Reset();
+
+  TimeDelta GetCurrentDelay() const;
+
+ private:
+  // detail::TimerBase
+  void OnStop() override;
+  void RunUserTask() override;
+
+  TimeDelta delay_;
+  RepeatingClosure user_task_;
+};
+
+// Runs a given task once at a specified point in time.
+class DeadlineTimer : public detail::TimerBase {
+ public:
+  DeadlineTimer();
+  ~DeadlineTimer() override;
+
+  void Start(SourceLocation location,
+             TimeTicks deadline,
+             OnceClosure user_task);
+
+ private:
+  // detail::TimerBase
+  void OnStop() override;
+  void RunUserTask() override;
+
+  OnceClosure user_task_;
+};
+
+}  // namespace base
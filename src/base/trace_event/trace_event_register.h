@@ -56,7 +56,7 @@ class EventRegister {
                               Args&&... args) {
     GetInstance().PushCounter(
         std::move(categories), std::move(name),
-        ArgumentPacker::PackStringArguments(std::forward<Args>(args)...));
+        ArgumentPacker::PackIntegerArguments(std::forward<Args>(args)...));
   }
 
   template <typename... Args>
@@ -67,7 +67,7 @@ class EventRegister {
     GetInstance().PushCounterId(
         std::move(categories), std::move(name),
         std::to_string(reinterpret_cast<uintptr_t>(id)),
-        ArgumentPacker::PackStringArguments(std::forward<Args>(args)...));
+        ArgumentPacker::PackIntegerArguments(std::forward<Args>(args)...));
   }
 
   template <typename... Args>
@@ -0,0 +1,71 @@
+#include <array>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/barrier_callback.h"
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+
+namespace {
+
+constexpr size_t kThreadsCount = 8;
+constexpr size_t kRunsPerThread = 1250;
+
+// Not default constructible, so results are collected under a lock.
+struct LockedElement {
+  explicit LockedElement(size_t value_) : value(value_) {}
+  size_t value;
+};
+
+// Collected into pre-sized slots without any lock.
+struct SlotElement {
+  size_t value = 0;
+};
+
+// Fans out `kThreadsCount * kRunsPerThread` runs of a single barrier callback
+// over all threads and waits for the final callback.
+template <typename ElementType>
+void BM_BarrierCallbackFanOut(benchmark::State& state) {
+  std::array<base::Thread, kThreadsCount> threads;
+  for (auto& thread : threads) {
+    thread.Start();
+  }
+  base::WaitableEvent done_event{base::WaitableEvent::ResetPolicy::kAutomatic};
+
+  for (auto _ : state) {
+    auto barrier_callback = base::BarrierCallback<ElementType>(
+        kThreadsCount * kRunsPerThread,
+        base::BindOnce(
+            [](base::WaitableEvent* event, std::vector<ElementType> results) {
+              benchmark::DoNotOptimize(results.data());
+              event->Signal();
+            },
+            &done_event));
+
+    for (auto& thread : threads) {
+      thread.TaskRunner()->PostTask(
+          FROM_HERE,
+          base::BindOnce(
+              [](base::RepeatingCallback<void(ElementType)> callback) {
+                for (size_t idx = 0; idx < kRunsPerThread; ++idx) {
+                  callback.Run(ElementType{idx});
+                }
+              },
+              barrier_callback));
+    }
+    done_event.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kThreadsCount * kRunsPerThread);
+}
+
+BENCHMARK_TEMPLATE(BM_BarrierCallbackFanOut, LockedElement)
+    ->Unit(::benchmark::TimeUnit::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BarrierCallbackFanOut, SlotElement)
+    ->Unit(::benchmark::TimeUnit::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/callback_list.h"
+
+namespace {
+
+void Increment(int* counter) {
+  ++(*counter);
+}
+
+// Hand-rolled observer list which copies its callbacks before notifying them,
+// so they can safely unsubscribe while being run.
+void BM_VectorOfCallbacksNotify(benchmark::State& state) {
+  int counter = 0;
+  std::vector<base::RepeatingClosure> callbacks;
+  for (int64_t idx = 0; idx < state.range(0); ++idx) {
+    callbacks.push_back(base::BindRepeating(&Increment, &counter));
+  }
+
+  for (auto _ : state) {
+    const std::vector<base::RepeatingClosure> snapshot = callbacks;
+    for (const auto& callback : snapshot) {
+      callback.Run();
+    }
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CallbackListNotify(benchmark::State& state) {
+  int counter = 0;
+  base::RepeatingClosureList list;
+  std::vector<base::CallbackListSubscription> subscriptions;
+  for (int64_t idx = 0; idx < state.range(0); ++idx) {
+    subscriptions.push_back(
+        list.Add(base::BindRepeating(&Increment, &counter)));
+  }
+
+  for (auto _ : state) {
+    list.Notify();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Adds and removes a callback in a list that already has other subscribers.
+void BM_CallbackListSubscribeUnsubscribe(benchmark::State& state) {
+  int counter = 0;
+  base::RepeatingClosureList list;
+  std::vector<base::CallbackListSubscription> subscriptions;
+  for (int64_t idx = 0; idx < state.range(0); ++idx) {
+    subscriptions.push_back(
+        list.Add(base::BindRepeating(&Increment, &counter)));
+  }
+
+  for (auto _ : state) {
+    base::CallbackListSubscription subscription =
+        list.Add(base::BindRepeating(&Increment, &counter));
+    benchmark::DoNotOptimize(subscription);
+  }
+}
+
+BENCHMARK(BM_VectorOfCallbacksNotify)->Arg(4)->Arg(64)->Arg(1024);
+BENCHMARK(BM_CallbackListNotify)->Arg(4)->Arg(64)->Arg(1024);
+BENCHMARK(BM_CallbackListSubscribeUnsubscribe)->Arg(4)->Arg(1024);
+
+}  // namespace
@@ -0,0 +1,313 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/callback.h"
+#include "base/memory/pool_allocator.h"
+#include "base/message_loop/run_loop.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+
+namespace {
+
+std::atomic<int64_t> g_allocations_count{0};
+
+int64_t GetAllocationsCount() {
+  return g_allocations_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+// Counts all heap allocations done by the benchmarks.
+void* operator new(std::size_t size) {
+  g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+void SmallTask(int* counter, int a, int b) {
+  *counter += a + b;
+}
+
+void LargeTask(int* counter, const std::array<int, 32>& values) {
+  *counter += values[0];
+}
+
+void BM_BindOnceAndRunSmall(benchmark::State& state) {
+  int counter = 0;
+  const int64_t allocations_before = GetAllocationsCount();
+
+  for (auto _ : state) {
+    base::BindOnce(&SmallTask, &counter, 1, 2).Run();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.counters["allocs_per_callback"] = benchmark::Counter(
+      static_cast<double>(GetAllocationsCount() - allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+void BM_BindOnceAndRunLarge(benchmark::State& state) {
+  int counter = 0;
+  const std::array<int, 32> values = {1};
+  const int64_t allocations_before = GetAllocationsCount();
+
+  for (auto _ : state) {
+    base::BindOnce(&LargeTask, &counter, values).Run();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.counters["allocs_per_callback"] = benchmark::Counter(
+      static_cast<double>(GetAllocationsCount() - allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+void BM_CopyRepeatingCallback(benchmark::State& state) {
+  int counter = 0;
+  const auto callback = base::BindRepeating(&SmallTask, &counter, 1, 2);
+
+  for (auto _ : state) {
+    auto copy = callback;
+    copy.Run();
+  }
+
+  benchmark::DoNotOptimize(counter);
+}
+
+void BM_PostTaskAllocations(benchmark::State& state) {
+  const int kTasksCount = 1000;
+  base::WaitableEvent event{base::WaitableEvent::ResetPolicy::kAutomatic};
+  base::Thread thread;
+  thread.Start();
+  auto task_runner = thread.TaskRunner();
+
+  int counter = 0;
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    const int64_t allocations_before = GetAllocationsCount();
+    for (int i = 0; i < kTasksCount; ++i) {
+      task_runner->PostTask(FROM_HERE,
+                            base::BindOnce(&SmallTask, &counter, i, 1));
+    }
+    task_runner->PostTask(
+        FROM_HERE, base::BindOnce(&base::WaitableEvent::Signal,
+                                  base::Unretained(&event)));
+    event.Wait();
+    allocations += GetAllocationsCount() - allocations_before;
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.counters["allocs_per_task"] = benchmark::Counter(
+      static_cast<double>(allocations) /
+      static_cast<double>(state.iterations() * (kTasksCount + 1)));
+}
+
+void VectorTask(int* counter, const std::vector<int>& values) {
+  *counter += values[0];
+}
+
+void BM_CopyRepeatingCallbackWithVector(benchmark::State& state) {
+  int counter = 0;
+  const auto callback = base::BindRepeating(
+      &VectorTask, &counter,
+      std::vector<int>(static_cast<size_t>(state.range(0)), 1));
+
+  for (auto _ : state) {
+    auto copy = callback;
+    copy.Run();
+  }
+
+  benchmark::DoNotOptimize(counter);
+}
+
+int AddOne(int value) {
+  return value + 1;
+}
+
+void BM_ThenChain(benchmark::State& state) {
+  const int64_t stages_count = state.range(0);
+  const auto pool_stats_before = base::PoolAllocator::GetStats();
+
+  int result = 0;
+  for (auto _ : state) {
+    base::OnceCallback<int(int)> chain = base::BindOnce(&AddOne);
+    for (int64_t i = 0; i < stages_count; ++i) {
+      chain = std::move(chain).Then(base::BindOnce(&AddOne));
+    }
+    result += std::move(chain).Run(0);
+  }
+
+  benchmark::DoNotOptimize(result);
+  const auto pool_stats_after = base::PoolAllocator::GetStats();
+  state.counters["allocs_per_chain"] = benchmark::Counter(
+      static_cast<double>(pool_stats_after.allocations -
+                          pool_stats_before.allocations +
+                          pool_stats_after.unpooled_allocations -
+                          pool_stats_before.unpooled_allocations),
+      benchmark::Counter::kAvgIterations);
+}
+
+int64_t GetPoolAllocationsCount() {
+  const auto stats = base::PoolAllocator::GetStats();
+  return static_cast<int64_t>(stats.allocations + stats.unpooled_allocations);
+}
+
+int64_t GetPoolAllocatedBytes() {
+  return static_cast<int64_t>(base::PoolAllocator::GetStats().allocated_bytes);
+}
+
+void BM_BindPostTaskAndRun(benchmark::State& state) {
+  base::RunLoop run_loop;
+  auto task_runner = run_loop.TaskRunner();
+
+  int counter = 0;
+  const int64_t allocations_before = GetAllocationsCount();
+  const int64_t pool_allocations_before = GetPoolAllocationsCount();
+  for (auto _ : state) {
+    base::BindPostTask(task_runner, base::BindOnce(&SmallTask, &counter, 1),
+                       FROM_HERE)
+        .Run(2);
+    run_loop.RunUntilIdle();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.counters["allocs_per_callback"] = benchmark::Counter(
+      static_cast<double>(GetAllocationsCount() - allocations_before),
+      benchmark::Counter::kAvgIterations);
+  state.counters["pool_allocs_per_callback"] = benchmark::Counter(
+      static_cast<double>(GetPoolAllocationsCount() - pool_allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+// Measures only invocations of an already bound callback, which post a task
+// each time.
+void BM_RunBoundToSequenceCallback(benchmark::State& state) {
+  const int kInvocationsCount = 1000;
+  base::RunLoop run_loop;
+  auto task_runner = run_loop.TaskRunner();
+
+  int counter = 0;
+  const auto callback = base::BindPostTask(
+      task_runner, base::BindRepeating(&SmallTask, &counter), FROM_HERE);
+
+  int64_t allocations = 0;
+  int64_t pool_allocations = 0;
+  for (auto _ : state) {
+    const int64_t allocations_before = GetAllocationsCount();
+    const int64_t pool_allocations_before = GetPoolAllocationsCount();
+    for (int i = 0; i < kInvocationsCount; ++i) {
+      callback.Run(i, 1);
+    }
+    allocations += GetAllocationsCount() - allocations_before;
+    pool_allocations += GetPoolAllocationsCount() - pool_allocations_before;
+    run_loop.RunUntilIdle();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  const auto invocations =
+      static_cast<double>(state.iterations() * kInvocationsCount);
+  state.counters["allocs_per_run"] =
+      benchmark::Counter(static_cast<double>(allocations) / invocations);
+  state.counters["pool_allocs_per_run"] =
+      benchmark::Counter(static_cast<double>(pool_allocations) / invocations);
+}
+
+std::vector<int> MakeVector(int size) {
+  return std::vector<int>(static_cast<size_t>(size), 1);
+}
+
+void ConsumeVector(int* counter, std::vector<int> values) {
+  *counter += static_cast<int>(values.size());
+}
+
+void BM_PostTaskAndReplyWithResult(benchmark::State& state) {
+  const int kCallsCount = 1000;
+  base::RunLoop run_loop;
+  auto task_runner = run_loop.TaskRunner();
+
+  int counter = 0;
+  int64_t allocations = 0;
+  int64_t pool_allocations = 0;
+  int64_t pool_bytes = 0;
+  for (auto _ : state) {
+    const int64_t allocations_before = GetAllocationsCount();
+    const int64_t pool_allocations_before = GetPoolAllocationsCount();
+    const int64_t pool_bytes_before = GetPoolAllocatedBytes();
+    for (int i = 0; i < kCallsCount; ++i) {
+      task_runner->PostTaskAndReplyWithResult(
+          FROM_HERE, base::BindOnce(&MakeVector, 0),
+          base::BindOnce(&ConsumeVector, &counter));
+    }
+    run_loop.RunUntilIdle();
+    allocations += GetAllocationsCount() - allocations_before;
+    pool_allocations += GetPoolAllocationsCount() - pool_allocations_before;
+    pool_bytes += GetPoolAllocatedBytes() - pool_bytes_before;
+  }
+
+  benchmark::DoNotOptimize(counter);
+  const auto calls = static_cast<double>(state.iterations() * kCallsCount);
+  state.counters["allocs_per_call"] =
+      benchmark::Counter(static_cast<double>(allocations) / calls);
+  state.counters["pool_allocs_per_call"] =
+      benchmark::Counter(static_cast<double>(pool_allocations) / calls);
+  state.counters["pool_bytes_per_call"] =
+      benchmark::Counter(static_cast<double>(pool_bytes) / calls);
+}
+
+void BM_PostTaskAndRunUntilIdle(benchmark::State& state) {
+  const int kTasksCount = 1000;
+  base::RunLoop run_loop;
+  auto task_runner = run_loop.TaskRunner();
+
+  int counter = 0;
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    const int64_t allocations_before = GetAllocationsCount();
+    for (int i = 0; i < kTasksCount; ++i) {
+      task_runner->PostTask(FROM_HERE,
+                            base::BindOnce(&SmallTask, &counter, i, 1));
+    }
+    run_loop.RunUntilIdle();
+    allocations += GetAllocationsCount() - allocations_before;
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.counters["allocs_per_task"] = benchmark::Counter(
+      static_cast<double>(allocations) /
+      static_cast<double>(state.iterations() * kTasksCount));
+}
+
+BENCHMARK(BM_BindOnceAndRunSmall);
+BENCHMARK(BM_BindOnceAndRunLarge);
+BENCHMARK(BM_CopyRepeatingCallback);
+BENCHMARK(BM_CopyRepeatingCallbackWithVector)->Arg(16)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_ThenChain)->DenseRange(1, 8);
+BENCHMARK(BM_BindPostTaskAndRun);
+BENCHMARK(BM_RunBoundToSequenceCallback)
+    ->Unit(::benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_PostTaskAndReplyWithResult)
+    ->Unit(::benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_PostTaskAndRunUntilIdle)
+    ->Unit(::benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_PostTaskAllocations)->Unit(::benchmark::TimeUnit::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,93 @@
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/bind.h"
+#include "base/memory/pool_allocator.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+
+namespace {
+
+constexpr size_t kBatchSize = 1024;
+
+struct SystemAllocator {
+  static void* Allocate(size_t size) { return std::malloc(size); }
+  static void Free(void* ptr, size_t /*size*/) { std::free(ptr); }
+};
+
+struct PoolAllocator {
+  static void* Allocate(size_t size) {
+    return base::PoolAllocator::Allocate(size);
+  }
+  static void Free(void* ptr, size_t size) {
+    base::PoolAllocator::Free(ptr, size);
+  }
+};
+
+template <typename Allocator>
+void BM_AllocateAndFreeOnSameThread(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  std::vector<void*> blocks(kBatchSize);
+
+  for (auto _ : state) {
+    for (auto& block : blocks) {
+      block = Allocator::Allocate(size);
+      benchmark::DoNotOptimize(block);
+    }
+    for (auto* block : blocks) {
+      Allocator::Free(block, size);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+// Blocks are allocated on the benchmark's thread and freed on another one,
+// same as states of tasks posted to other threads.
+template <typename Allocator>
+void BM_AllocateAndFreeOnOtherThread(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  base::WaitableEvent event{base::WaitableEvent::ResetPolicy::kAutomatic};
+  base::Thread thread;
+  thread.Start();
+
+  for (auto _ : state) {
+    std::vector<void*> blocks(kBatchSize);
+    for (auto& block : blocks) {
+      block = Allocator::Allocate(size);
+      benchmark::DoNotOptimize(block);
+    }
+    thread.TaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](std::vector<void*> blocks_to_free, size_t block_size,
+                          base::WaitableEvent* done_event) {
+                         for (auto* block : blocks_to_free) {
+                           Allocator::Free(block, block_size);
+                         }
+                         done_event->Signal();
+                       },
+                       std::move(blocks), size, &event));
+    event.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+#define LIBBASE_ALLOCATOR_BENCHMARK(benchmark_name, allocator) \
+  BENCHMARK_TEMPLATE(benchmark_name, allocator)                \
+      ->Arg(16)                                                \
+      ->Arg(64)                                                \
+      ->Arg(256)                                               \
+      ->Arg(1024)
+
+LIBBASE_ALLOCATOR_BENCHMARK(BM_AllocateAndFreeOnSameThread, SystemAllocator);
+LIBBASE_ALLOCATOR_BENCHMARK(BM_AllocateAndFreeOnSameThread, PoolAllocator);
+LIBBASE_ALLOCATOR_BENCHMARK(BM_AllocateAndFreeOnOtherThread, SystemAllocator);
+LIBBASE_ALLOCATOR_BENCHMARK(BM_AllocateAndFreeOnOtherThread, PoolAllocator);
+
+#undef LIBBASE_ALLOCATOR_BENCHMARK
+
+}  // namespace
@@ -0,0 +1,50 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/memory/ref_counted.h"
+
+namespace {
+
+constexpr size_t kBatchSize = 1024;
+
+class Object : public base::RefCountedThreadSafe<Object> {
+ public:
+  int value = 0;
+};
+
+struct SharedPtr {
+  using Pointer = std::shared_ptr<Object>;
+  static Pointer Make() { return std::make_shared<Object>(); }
+};
+
+struct ScopedRefptr {
+  using Pointer = base::scoped_refptr<Object>;
+  static Pointer Make() { return base::MakeRefCounted<Object>(); }
+};
+
+// Copies a pointer into a batch of slots, same as posting tasks that reference
+// their task runner.
+template <typename Traits>
+void BM_CopyPointer(benchmark::State& state) {
+  const auto object = Traits::Make();
+  std::vector<typename Traits::Pointer> copies(kBatchSize);
+
+  for (auto _ : state) {
+    for (auto& copy : copies) {
+      copy = object;
+    }
+    for (auto& copy : copies) {
+      copy = nullptr;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+  state.counters["pointer_size"] = sizeof(typename Traits::Pointer);
+}
+
+BENCHMARK_TEMPLATE(BM_CopyPointer, SharedPtr);
+BENCHMARK_TEMPLATE(BM_CopyPointer, ScopedRefptr);
+
+}  // namespace
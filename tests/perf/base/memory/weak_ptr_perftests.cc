@@ -0,0 +1,89 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner_helpers.h"
+
+namespace {
+
+constexpr size_t kBatchSize = 1024;
+
+class Target {
+ public:
+  void Increment() { ++counter_; }
+
+  base::WeakPtr<Target> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+  void InvalidateWeakPtrs() { weak_factory_.InvalidateWeakPtrs(); }
+
+ private:
+  int counter_ = 0;
+  base::WeakPtrFactory<Target> weak_factory_{this};
+};
+
+// WeakPtrs are checked for being dereferenced on a valid sequence.
+class ScopedSequence {
+ public:
+  ScopedSequence()
+      : sequence_id_setter_(
+            base::detail::SequenceIdGenerator::GetNextSequenceId()) {}
+
+ private:
+  base::detail::ScopedSequenceIdSetter sequence_id_setter_;
+};
+
+void BM_WeakPtrCopy(benchmark::State& state) {
+  ScopedSequence sequence;
+  Target target;
+  const base::WeakPtr<Target> weak_ptr = target.GetWeakPtr();
+
+  for (auto _ : state) {
+    base::WeakPtr<Target> copy = weak_ptr;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+void BM_WeakPtrGet(benchmark::State& state) {
+  ScopedSequence sequence;
+  Target target;
+  const base::WeakPtr<Target> weak_ptr = target.GetWeakPtr();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(weak_ptr.Get());
+  }
+}
+
+// Hands out a batch of WeakPtrs and invalidates all of them at once.
+void BM_WeakPtrGetAndInvalidate(benchmark::State& state) {
+  ScopedSequence sequence;
+  Target target;
+  std::vector<base::WeakPtr<Target>> weak_ptrs(kBatchSize);
+
+  for (auto _ : state) {
+    for (auto& weak_ptr : weak_ptrs) {
+      weak_ptr = target.GetWeakPtr();
+    }
+    target.InvalidateWeakPtrs();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+// Binds a method to a WeakPtr receiver and runs it, as most posted tasks do.
+void BM_BindWeakMethodAndRun(benchmark::State& state) {
+  ScopedSequence sequence;
+  Target target;
+
+  for (auto _ : state) {
+    base::BindOnce(&Target::Increment, target.GetWeakPtr()).Run();
+  }
+}
+
+BENCHMARK(BM_WeakPtrCopy);
+BENCHMARK(BM_WeakPtrGet);
+BENCHMARK(BM_WeakPtrGetAndInvalidate);
+BENCHMARK(BM_BindWeakMethodAndRun);
+
+}  // namespace
@@ -0,0 +1,121 @@
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/synchronization/async_lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread_pool.h"
+#include "base/timer/elapsed_timer.h"
+
+namespace {
+
+constexpr int kThreadsCount = 4;
+constexpr int kLockingSequencesCount = 4;
+constexpr int kIndependentSequencesCount = 4;
+constexpr int kTasksPerSequence = 50;
+constexpr int kTasksCount =
+    (kLockingSequencesCount + kIndependentSequencesCount) * kTasksPerSequence;
+
+struct Progress {
+  std::atomic_int executed{0};
+  base::WaitableEvent done_event{};
+};
+
+void BusyWork(base::TimeDelta duration) {
+  const base::ElapsedTimer timer;
+  while (timer.Elapsed() < duration) {
+  }
+}
+
+void FinishTask(Progress* progress) {
+  if (++progress->executed == kTasksCount) {
+    progress->done_event.Signal();
+  }
+}
+
+void IndependentTask(Progress* progress) {
+  BusyWork(base::Microseconds(20));
+  FinishTask(progress);
+}
+
+void MutexTask(std::mutex* mutex, Progress* progress) {
+  {
+    std::lock_guard<std::mutex> guard(*mutex);
+    BusyWork(base::Microseconds(20));
+  }
+  FinishTask(progress);
+}
+
+void AsyncLockedWork(Progress* progress, base::AsyncLock::Handle handle) {
+  BusyWork(base::Microseconds(20));
+  handle.Release();
+  FinishTask(progress);
+}
+
+void AsyncLockTask(base::AsyncLock* lock, Progress* progress) {
+  lock->Acquire(FROM_HERE, base::BindOnce(&AsyncLockedWork, progress));
+}
+
+struct StdMutex {
+  std::mutex mutex;
+
+  base::OnceClosure MakeTask(Progress* progress) {
+    return base::BindOnce(&MutexTask, &mutex, progress);
+  }
+};
+
+struct AsyncLock {
+  base::AsyncLock lock;
+
+  base::OnceClosure MakeTask(Progress* progress) {
+    return base::BindOnce(&AsyncLockTask, &lock, progress);
+  }
+};
+
+// Runs sequences which need exclusive access to a shared resource next to
+// sequences doing independent work on a pool with fewer threads than there
+// are sequences. Blocking on `std::mutex` occupies threads that could run the
+// independent work in the meantime, while waiting for `base::AsyncLock` does
+// not.
+template <typename Lock>
+void BM_LockContention(benchmark::State& state) {
+  base::ThreadPool thread_pool{kThreadsCount};
+  thread_pool.Start();
+
+  std::vector<base::scoped_refptr<base::SequencedTaskRunner>> task_runners;
+  for (int i = 0; i < kLockingSequencesCount + kIndependentSequencesCount;
+       ++i) {
+    task_runners.push_back(thread_pool.CreateSequencedTaskRunner());
+  }
+
+  for (auto _ : state) {
+    Lock lock;
+    Progress progress;
+
+    for (int i = 0; i < kTasksPerSequence; ++i) {
+      for (int j = 0; j < kLockingSequencesCount; ++j) {
+        task_runners[j]->PostTask(FROM_HERE, lock.MakeTask(&progress));
+      }
+      for (size_t j = kLockingSequencesCount; j < task_runners.size(); ++j) {
+        task_runners[j]->PostTask(
+            FROM_HERE, base::BindOnce(&IndependentTask, &progress));
+      }
+    }
+    progress.done_event.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTasksCount);
+  thread_pool.Stop();
+}
+
+BENCHMARK_TEMPLATE(BM_LockContention, StdMutex)
+    ->Unit(::benchmark::TimeUnit::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_LockContention, AsyncLock)
+    ->Unit(::benchmark::TimeUnit::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
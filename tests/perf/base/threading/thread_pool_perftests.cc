@@ -0,0 +1,137 @@
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread_pool.h"
+#include "base/timer/elapsed_timer.h"
+
+namespace {
+
+constexpr int kTaskRunnersCount = 8;
+constexpr int kTasksCount = 200;
+
+struct DeadlineStats {
+  std::atomic_int executed{0};
+  std::atomic_int missed{0};
+  std::atomic_int urgent_missed{0};
+};
+
+void BusyTask(base::TimeDelta duration,
+              base::TimeTicks deadline,
+              bool urgent,
+              DeadlineStats* stats,
+              base::WaitableEvent* done_event) {
+  const base::ElapsedTimer timer;
+  while (timer.Elapsed() < duration) {
+  }
+
+  if (base::TimeTicks::Now() > deadline) {
+    ++stats->missed;
+    if (urgent) {
+      ++stats->urgent_missed;
+    }
+  }
+  if (++stats->executed == kTasksCount) {
+    done_event->Signal();
+  }
+}
+
+// Queues more work than can be finished before the latest deadline on a single
+// thread and counts how many tasks missed their deadlines. The first sequence
+// carries urgent requests with short deadlines, while the remaining ones carry
+// requests with longer (but still not achievable for all of them) deadlines.
+// Within each sequence deadlines are non-decreasing. With `edf:0` deadlines
+// are ignored and tasks are executed in FIFO order.
+void BM_DeadlineMissRate(benchmark::State& state) {
+  const bool use_deadlines = state.range(0) != 0;
+  const base::TimeDelta task_duration = base::Microseconds(50);
+  const base::TimeDelta total_work = task_duration * kTasksCount;
+
+  base::ThreadPool thread_pool{1};
+  thread_pool.Start();
+
+  std::vector<base::scoped_refptr<base::DeadlineTaskRunner>> task_runners;
+  for (int i = 0; i < kTaskRunnersCount; ++i) {
+    task_runners.push_back(thread_pool.CreateDeadlineTaskRunner());
+  }
+
+  std::mt19937 random_generator{1234};
+  std::uniform_int_distribution<int64_t> urgent_deadline_distribution(
+      total_work.InMicroseconds() / 10, total_work.InMicroseconds() / 5);
+  std::uniform_int_distribution<int64_t> deadline_distribution(
+      total_work.InMicroseconds() / 2, total_work.InMicroseconds() * 9 / 10);
+  double miss_rate_sum = 0.0;
+  double urgent_miss_rate_sum = 0.0;
+
+  for (auto _ : state) {
+    DeadlineStats stats;
+    base::WaitableEvent blocked_event{};
+    base::WaitableEvent unblock_event{};
+    base::WaitableEvent done_event{};
+
+    // Keep the thread busy, so that all the tasks are queued at once.
+    thread_pool.GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](base::WaitableEvent* ext_blocked_event,
+                          base::WaitableEvent* ext_unblock_event) {
+                         ext_blocked_event->Signal();
+                         ext_unblock_event->Wait();
+                       },
+                       &blocked_event, &unblock_event));
+    blocked_event.Wait();
+
+    std::vector<std::vector<int64_t>> deadlines(kTaskRunnersCount);
+    for (int i = 0; i < kTasksCount; ++i) {
+      const int sequence_idx = i % kTaskRunnersCount;
+      deadlines[sequence_idx].push_back(
+          sequence_idx == 0 ? urgent_deadline_distribution(random_generator)
+                            : deadline_distribution(random_generator));
+    }
+    for (auto& sequence_deadlines : deadlines) {
+      std::sort(sequence_deadlines.begin(), sequence_deadlines.end());
+    }
+
+    const auto start_time = base::TimeTicks::Now() + base::Milliseconds(1);
+    for (int i = 0; i < kTasksCount; ++i) {
+      const int sequence_idx = i % kTaskRunnersCount;
+      const auto deadline =
+          start_time +
+          base::Microseconds(deadlines[sequence_idx][i / kTaskRunnersCount]);
+      auto task = base::BindOnce(&BusyTask, task_duration, deadline,
+                                 sequence_idx == 0, &stats, &done_event);
+      if (use_deadlines) {
+        task_runners[sequence_idx]->PostTaskWithDeadline(
+            FROM_HERE, std::move(task), deadline);
+      } else {
+        task_runners[sequence_idx]->PostTask(FROM_HERE, std::move(task));
+      }
+    }
+    while (base::TimeTicks::Now() < start_time) {
+    }
+    unblock_event.Signal();
+    done_event.Wait();
+
+    miss_rate_sum += static_cast<double>(stats.missed) / kTasksCount;
+    urgent_miss_rate_sum += static_cast<double>(stats.urgent_missed) /
+                            (kTasksCount / kTaskRunnersCount);
+  }
+
+  state.counters["miss_rate"] =
+      benchmark::Counter(miss_rate_sum, benchmark::Counter::kAvgIterations);
+  state.counters["urgent_miss_rate"] = benchmark::Counter(
+      urgent_miss_rate_sum, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_DeadlineMissRate)
+    ->ArgName("edf")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(::benchmark::TimeUnit::kMillisecond)
+    ->Iterations(50);
+
+}  // namespace
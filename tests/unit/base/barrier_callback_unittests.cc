@@ -1,10 +1,12 @@
 #include "base/barrier_callback.h"
 
 #include <array>
+#include <memory>
 #include <vector>
 
 #include "gtest/gtest.h"
 
+#include "base/synchronization/waitable_event.h"
 #include "base/threading/thread.h"
 
 namespace {
@@ -110,4 +112,119 @@ TEST(BarrierCallbackTest, MultipleRunsMultiThread) {
   EXPECT_TRUE(verification_done);
 }
 
+TEST(BarrierCallbackTest, NonDefaultConstructibleElements) {
+  struct Element {
+    explicit Element(int value_) : value(value_) {}
+    int value;
+  };
+
+  std::vector<int> values;
+  auto barrier_callback = base::BarrierCallback<Element>(
+      2, base::BindOnce(
+             [](std::vector<int>* values_ptr, std::vector<Element> results) {
+               for (const auto& result : results) {
+                 values_ptr->push_back(result.value);
+               }
+             },
+             &values));
+
+  barrier_callback.Run(Element{1});
+  barrier_callback.Run(Element{2});
+  EXPECT_EQ(values, (std::vector<int>{1, 2}));
+}
+
+TEST(IndexedBarrierCallbackTest, ZeroCount) {
+  bool verification_done = false;
+  auto barrier_callback = base::IndexedBarrierCallback<int>(
+      0, base::BindOnce(
+             [](bool* done_flag, std::vector<int> results) {
+               *done_flag = true;
+               EXPECT_TRUE(results.empty());
+             },
+             &verification_done));
+  EXPECT_FALSE(barrier_callback);
+  EXPECT_TRUE(verification_done);
+}
+
+TEST(IndexedBarrierCallbackTest, ResultsInIndexOrder) {
+  constexpr size_t kRunsCount = 5;
+
+  std::vector<std::unique_ptr<int>> results;
+  auto barrier_callback = base::IndexedBarrierCallback<std::unique_ptr<int>>(
+      kRunsCount,
+      base::BindOnce(
+          [](std::vector<std::unique_ptr<int>>* results_ptr,
+             std::vector<std::unique_ptr<int>> barrier_results) {
+            *results_ptr = std::move(barrier_results);
+          },
+          &results));
+
+  for (size_t idx = kRunsCount; idx > 0; --idx) {
+    EXPECT_TRUE(results.empty());
+    barrier_callback.Run(idx - 1,
+                         std::make_unique<int>(static_cast<int>(idx - 1)));
+  }
+
+  ASSERT_EQ(results.size(), kRunsCount);
+  for (size_t idx = 0; idx < kRunsCount; ++idx) {
+    EXPECT_EQ(*results[idx], static_cast<int>(idx));
+  }
+}
+
+TEST(IndexedBarrierCallbackTest, MultipleRunsMultiThread) {
+  constexpr size_t kRunsCount = 10;
+  constexpr size_t kRunsPerThread = 100;
+
+  base::WaitableEvent done_event;
+  std::vector<size_t> results;
+  auto barrier_callback = base::IndexedBarrierCallback<size_t>(
+      kRunsCount * kRunsPerThread,
+      base::BindOnce(
+          [](std::vector<size_t>* results_ptr, base::WaitableEvent* event,
+             std::vector<size_t> barrier_results) {
+            *results_ptr = std::move(barrier_results);
+            event->Signal();
+          },
+          &results, &done_event));
+
+  std::array<base::Thread, kRunsCount> threads;
+  for (size_t thread_idx = 0; thread_idx < kRunsCount; ++thread_idx) {
+    threads[thread_idx].Start();
+    threads[thread_idx].TaskRunner()->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](base::RepeatingCallback<void(size_t, size_t)> callback,
+               size_t first_index) {
+              for (size_t idx = 0; idx < kRunsPerThread; ++idx) {
+                callback.Run(first_index + idx, first_index + idx);
+              }
+            },
+            barrier_callback, thread_idx * kRunsPerThread));
+  }
+
+  done_event.Wait();
+  ASSERT_EQ(results.size(), kRunsCount * kRunsPerThread);
+  for (size_t idx = 0; idx < results.size(); ++idx) {
+    EXPECT_EQ(results[idx], idx);
+  }
+}
+
+TEST(IndexedBarrierCallbackTest, RunWithOutOfRangeIndex) {
+  auto barrier_callback = base::IndexedBarrierCallback<int>(
+      2, base::BindOnce([](std::vector<int>) {}));
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto)
+  EXPECT_DEATH_IF_SUPPORTED(barrier_callback.Run(2, 0), "index");
+}
+
+TEST(IndexedBarrierCallbackTest, RunAfterAllRequiredRuns) {
+  auto barrier_callback = base::IndexedBarrierCallback<int>(
+      1, base::BindOnce([](std::vector<int>) {}));
+  barrier_callback.Run(0, 0);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto)
+  EXPECT_DEATH_IF_SUPPORTED(barrier_callback.Run(0, 0),
+                            "Barrier callback run more times than required");
+}
+
 }  // namespace
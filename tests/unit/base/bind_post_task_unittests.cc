@@ -1,5 +1,7 @@
 #include "base/bind_post_task.h"
 
+#include <memory>
+
 #include "base/threading/thread.h"
 
 #include "gtest/gtest.h"
@@ -9,7 +11,7 @@ namespace {
 void SetFlagIfRunningOnTaskRunner(
     bool* executed_flag,
     bool* flag,
-    std::shared_ptr<base::SequencedTaskRunner> task_runner) {
+    base::scoped_refptr<base::SequencedTaskRunner> task_runner) {
   *executed_flag = true;
   *flag = task_runner->RunsTasksInCurrentSequence();
 }
@@ -17,7 +19,7 @@ void SetFlagIfRunningOnTaskRunner(
 void IncrementIfRunningOnTaskRunner(
     int* executed_counter,
     int* counter,
-    std::shared_ptr<base::SequencedTaskRunner> task_runner) {
+    base::scoped_refptr<base::SequencedTaskRunner> task_runner) {
   *executed_counter += 1;
   *counter += task_runner->RunsTasksInCurrentSequence() ? 1 : 0;
 }
@@ -70,6 +72,52 @@ TEST_F(BindPostTaskTest, BindRepeating) {
   EXPECT_EQ(task_runner_matched, 2);
 }
 
+TEST_F(BindPostTaskTest, BindOnceWithMoveOnlyArgument) {
+  int result = 0;
+  auto callback = base::BindPostTask(
+      thread.TaskRunner(),
+      base::BindOnce(
+          [](int* result_ptr, std::unique_ptr<int> value) {
+            *result_ptr = *value;
+          },
+          &result),
+      FROM_HERE);
+
+  std::move(callback).Run(std::make_unique<int>(42));
+  thread.FlushForTesting();
+  EXPECT_EQ(result, 42);
+}
+
+TEST_F(BindPostTaskTest, BindRepeatingWithoutArguments) {
+  int counter = 0;
+  auto callback = base::BindPostTask(
+      thread.TaskRunner(),
+      base::BindRepeating([](int* counter_ptr) { ++(*counter_ptr); }, &counter),
+      FROM_HERE);
+  auto copy = callback;
+
+  callback.Run();
+  copy.Run();
+  std::move(callback).Run();
+  thread.FlushForTesting();
+  EXPECT_EQ(counter, 3);
+
+  copy.Run();
+  thread.FlushForTesting();
+  EXPECT_EQ(counter, 4);
+}
+
+TEST_F(BindPostTaskTest, DestroyedWithoutRunning) {
+  auto value = std::make_shared<int>(0);
+  auto callback = base::BindPostTask(
+      thread.TaskRunner(),
+      base::BindOnce([](std::shared_ptr<int> /*value*/) {}, value), FROM_HERE);
+  EXPECT_EQ(value.use_count(), 2);
+
+  callback = {};
+  EXPECT_EQ(value.use_count(), 1);
+}
+
 class BindToCurrentSequenceTest : public BindPostTaskTest {
  public:
   void SetUp() override {
@@ -93,8 +141,10 @@ TEST_F(BindToCurrentSequenceTest, Once) {
       FROM_HERE,
       base::BindOnce(
           [](bool* executed_ptr, bool* task_runner_matched_ptr,
-             std::shared_ptr<base::SequencedTaskRunner> expected_task_runner,
-             std::shared_ptr<base::SequencedTaskRunner> post_to_task_runner) {
+             base::scoped_refptr<base::SequencedTaskRunner>
+                 expected_task_runner,
+             base::scoped_refptr<base::SequencedTaskRunner>
+                 post_to_task_runner) {
             auto callback = base::BindToCurrentSequence(
                 base::BindOnce(&SetFlagIfRunningOnTaskRunner, executed_ptr,
                                task_runner_matched_ptr, expected_task_runner),
@@ -123,8 +173,10 @@ TEST_F(BindToCurrentSequenceTest, Repeating) {
       FROM_HERE,
       base::BindOnce(
           [](int* executed_ptr, int* task_runner_matched_ptr,
-             std::shared_ptr<base::SequencedTaskRunner> expected_task_runner,
-             std::shared_ptr<base::SequencedTaskRunner> post_to_task_runner) {
+             base::scoped_refptr<base::SequencedTaskRunner>
+                 expected_task_runner,
+             base::scoped_refptr<base::SequencedTaskRunner>
+                 post_to_task_runner) {
             auto callback = base::BindToCurrentSequence(
                 base::BindRepeating(&IncrementIfRunningOnTaskRunner,
                                     executed_ptr, task_runner_matched_ptr,
@@ -1,5 +1,11 @@
 #include "base/bind.h"
 
+#include <array>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "base/memory/pool_allocator.h"
 #include "base/sequenced_task_runner_helpers.h"
 #include "base/threading/thread.h"
 
@@ -811,6 +817,56 @@ TEST_F(WeakCallbackTest, WeakThenLambdaInvalidateAfterThen) {
   EXPECT_EQ(weak_object_.GetValue(), 3);
 }
 
+TEST_F(WeakCallbackTest, WeakCallbackIsCancelledAfterInvalidation) {
+  auto once_callback =
+      base::BindOnce(&WeakClass::IncrementBy, weak_object_.GetWeakPtr(), 1u);
+  auto repeating_callback = base::BindRepeating(&WeakClass::IncrementValue,
+                                                weak_object_.GetWeakPtr());
+  auto repeating_copy = repeating_callback;
+
+  EXPECT_FALSE(once_callback.IsCancelled());
+  EXPECT_TRUE(once_callback.MaybeValid());
+  EXPECT_FALSE(repeating_copy.IsCancelled());
+  EXPECT_TRUE(repeating_copy.MaybeValid());
+
+  weak_object_.InvalidateWeakPtrs();
+
+  EXPECT_TRUE(once_callback.IsCancelled());
+  EXPECT_FALSE(once_callback.MaybeValid());
+  EXPECT_TRUE(repeating_callback.IsCancelled());
+  EXPECT_FALSE(repeating_callback.MaybeValid());
+  EXPECT_TRUE(repeating_copy.IsCancelled());
+  EXPECT_FALSE(repeating_copy.MaybeValid());
+}
+
+TEST_F(WeakCallbackTest, NestedWeakCallbackIsCancelled) {
+  auto callback = base::BindOnce(
+      base::BindOnce(&WeakClass::IncrementBy, weak_object_.GetWeakPtr()), 1u);
+  EXPECT_FALSE(callback.IsCancelled());
+
+  weak_object_.InvalidateWeakPtrs();
+  EXPECT_TRUE(callback.IsCancelled());
+  EXPECT_FALSE(callback.MaybeValid());
+}
+
+TEST_F(WeakCallbackTest, OtherCallbacksAreNeverCancelled) {
+  auto callback = base::BindOnce(&WeakClass::IncrementValue,
+                                 base::Unretained(&weak_object_));
+  auto lambda_callback = base::BindRepeating(
+      [](base::WeakPtr<WeakClass>) {}, weak_object_.GetWeakPtr());
+
+  weak_object_.InvalidateWeakPtrs();
+
+  EXPECT_FALSE(callback.IsCancelled());
+  EXPECT_TRUE(callback.MaybeValid());
+  // Only methods invoked on a `WeakPtr` receiver are skipped once it's gone.
+  EXPECT_FALSE(lambda_callback.IsCancelled());
+  EXPECT_TRUE(lambda_callback.MaybeValid());
+
+  EXPECT_TRUE(base::OnceClosure{}.IsCancelled());
+  EXPECT_FALSE(base::OnceClosure{}.MaybeValid());
+}
+
 class ThreadedWeakCallbackTest : public WeakCallbackTest {
  public:
   void SetUp() override { thread_.Start(); }
@@ -819,7 +875,7 @@ class ThreadedWeakCallbackTest : public WeakCallbackTest {
     thread_.Stop();
   }
 
-  std::shared_ptr<base::SequencedTaskRunner> TaskRunner() {
+  base::scoped_refptr<base::SequencedTaskRunner> TaskRunner() {
     return thread_.TaskRunner();
   }
 
@@ -1111,4 +1167,231 @@ TEST(CallbackThenTest, RepeatingCallbackThenOnceCallbackNoResult) {
   EXPECT_FALSE(callback_2);
 }
 
+// Tracks the number of live instances to verify that callback states are
+// destroyed exactly once, whether they are stored inline or on the heap.
+template <size_t kPaddingSize>
+struct InstanceCounter {
+  explicit InstanceCounter(int* live_count) : live(live_count) { ++(*live); }
+  InstanceCounter(const InstanceCounter& other) : live(other.live) {
+    ++(*live);
+  }
+  InstanceCounter(InstanceCounter&& other) noexcept : live(other.live) {
+    ++(*live);
+  }
+  ~InstanceCounter() { --(*live); }
+
+  int* live;
+  char padding[kPaddingSize] = {};
+};
+
+using SmallInstanceCounter = InstanceCounter<8>;
+using LargeInstanceCounter = InstanceCounter<256>;
+
+int ReadLive(const SmallInstanceCounter& counter) {
+  return *counter.live;
+}
+
+int ReadLiveLarge(const LargeInstanceCounter& counter) {
+  return *counter.live;
+}
+
+TEST(CallbackStorageTest, SmallStatesAreStoredInline) {
+  using SmallState =
+      base::detail::FunctorCallback<false, base::detail::FunctorTraits<
+                                               void (*)(int, int)>,
+                                    void (*)(int, int), void,
+                                    std::tuple<int, int>, std::tuple<>>;
+  static_assert(base::detail::CallbackStorage::kIsStoredInline<SmallState>);
+
+  using LargeState = base::detail::FunctorCallback<
+      false, base::detail::FunctorTraits<void (*)(std::array<char, 256>)>,
+      void (*)(std::array<char, 256>), void, std::tuple<std::array<char, 256>>,
+      std::tuple<>>;
+  static_assert(!base::detail::CallbackStorage::kIsStoredInline<LargeState>);
+}
+
+TEST(CallbackStorageTest, InlineStateMovedAndDestroyed) {
+  int live = 0;
+  {
+    auto cb = base::BindOnce(&ReadLive, SmallInstanceCounter{&live});
+    EXPECT_EQ(live, 1);
+
+    auto moved_cb = std::move(cb);
+    EXPECT_EQ(live, 1);
+
+    base::OnceCallback<int()> assigned_cb;
+    assigned_cb = std::move(moved_cb);
+    EXPECT_EQ(live, 1);
+    EXPECT_EQ(std::move(assigned_cb).Run(), 1);
+    EXPECT_EQ(live, 0);
+  }
+  EXPECT_EQ(live, 0);
+}
+
+TEST(CallbackStorageTest, HeapStateMovedAndDestroyed) {
+  int live = 0;
+  {
+    auto cb = base::BindOnce(&ReadLiveLarge, LargeInstanceCounter{&live});
+    EXPECT_EQ(live, 1);
+
+    auto moved_cb = std::move(cb);
+    EXPECT_EQ(live, 1);
+    EXPECT_EQ(std::move(moved_cb).Run(), 1);
+    EXPECT_EQ(live, 0);
+  }
+  EXPECT_EQ(live, 0);
+}
+
+TEST(CallbackStorageTest, RepeatingStatesShared) {
+  int live = 0;
+  {
+    auto small_cb = base::BindRepeating(&ReadLive, SmallInstanceCounter{&live});
+    auto large_cb =
+        base::BindRepeating(&ReadLiveLarge, LargeInstanceCounter{&live});
+    EXPECT_EQ(live, 2);
+
+    auto small_copy = small_cb;
+    auto large_copy = large_cb;
+    EXPECT_EQ(small_copy.Run(), 2);
+    EXPECT_EQ(large_copy.Run(), 2);
+
+    small_cb = {};
+    large_cb = {};
+    EXPECT_EQ(small_copy.Run(), 2);
+    EXPECT_EQ(large_copy.Run(), 2);
+
+    base::OnceCallback<int()> once_cb = small_copy;
+    EXPECT_EQ(std::move(once_cb).Run(), 2);
+    EXPECT_EQ(live, 2);
+  }
+  EXPECT_EQ(live, 0);
+}
+
+// Counts copies of the bound argument.
+struct CopyCounter {
+  explicit CopyCounter(int* copies_count) : copies(copies_count) {}
+  CopyCounter(const CopyCounter& other) : copies(other.copies) {
+    ++(*copies);
+  }
+  CopyCounter(CopyCounter&& other) noexcept = default;
+
+  int* copies;
+};
+
+void TakeCopyCounter(CopyCounter /*counter*/) {}
+
+TEST(CallbackStorageTest, RepeatingCopiesDoNotCopyBoundArguments) {
+  int copies = 0;
+  auto cb = base::BindRepeating(&TakeCopyCounter, CopyCounter{&copies});
+  EXPECT_EQ(copies, 0);
+
+  auto copy_1 = cb;
+  auto copy_2 = copy_1;
+  base::OnceClosure once_cb = copy_2;
+  EXPECT_EQ(copies, 0);
+
+  // Running through a const reference has to copy the argument.
+  cb.Run();
+  EXPECT_EQ(copies, 1);
+}
+
+TEST(CallbackStorageTest, RepeatingRvalueRunMovesOutIfSoleOwner) {
+  int copies = 0;
+  auto cb = base::BindRepeating(&TakeCopyCounter, CopyCounter{&copies});
+  auto copy = cb;
+
+  // State is shared with `copy`, so the argument is copied.
+  std::move(cb).Run();
+  EXPECT_EQ(copies, 1);
+  EXPECT_FALSE(cb);
+
+  // `copy` is the sole owner now, so the argument is moved out.
+  base::OnceClosure once_cb = std::move(copy);
+  std::move(once_cb).Run();
+  EXPECT_EQ(copies, 1);
+}
+
+int AddOne(int value) {
+  return value + 1;
+}
+
+TEST(CallbackThenTest, LongChainPassesResultsInOrder) {
+  std::vector<int> order;
+  auto record = [](std::vector<int>* order_ptr, int value) {
+    order_ptr->push_back(value);
+    return value + 1;
+  };
+
+  // Grows the flattened chain a few times.
+  base::OnceCallback<int(int)> chain = base::BindOnce(record, &order);
+  for (int i = 0; i < 20; ++i) {
+    chain = std::move(chain).Then(base::BindOnce(record, &order));
+  }
+
+  EXPECT_EQ(std::move(chain).Run(0), 21);
+  ASSERT_EQ(order.size(), 21u);
+  for (int i = 0; i < 21; ++i) {
+    EXPECT_EQ(order[static_cast<size_t>(i)], i);
+  }
+}
+
+TEST(CallbackThenTest, ChainMixesVoidAndMoveOnlyResults) {
+  bool first_run = false;
+  int result = 0;
+
+  auto chain =
+      base::BindOnce([](bool* run) { *run = true; }, &first_run)
+          .Then(base::BindOnce([]() { return std::make_unique<int>(41); }))
+          .Then(base::BindOnce([](std::unique_ptr<int> value) {
+            return *value + 1;
+          }))
+          .Then(base::BindOnce([](int* out, int value) { *out = value; },
+                               &result));
+
+  std::move(chain).Run();
+  EXPECT_TRUE(first_run);
+  EXPECT_EQ(result, 42);
+}
+
+TEST(CallbackThenTest, ChainDestroysStagesWithoutRunning) {
+  int live = 0;
+  {
+    auto chain = base::BindOnce(&AddOne)
+                     .Then(base::BindOnce(
+                         [](const SmallInstanceCounter&, int value) {
+                           return value;
+                         },
+                         SmallInstanceCounter{&live}))
+                     .Then(base::BindOnce(&AddOne));
+    EXPECT_EQ(live, 1);
+  }
+  EXPECT_EQ(live, 0);
+}
+
+TEST(CallbackThenTest, ChainAllocatesOnce) {
+  const auto stats_before = base::PoolAllocator::GetStats();
+  auto chain = base::BindOnce(&AddOne).Then(base::BindOnce(&AddOne));
+  const auto stats_after = base::PoolAllocator::GetStats();
+
+  EXPECT_EQ(stats_after.allocations, stats_before.allocations + 1);
+  // Two-stage chains (e.g. tasks posted with replies) are sized for just the
+  // two stages.
+  EXPECT_LE(stats_after.allocated_bytes - stats_before.allocated_bytes, 256u);
+  EXPECT_EQ(std::move(chain).Run(0), 2);
+}
+
+TEST(CallbackThenTest, ChainGrowsGeometrically) {
+  const auto stats_before = base::PoolAllocator::GetStats();
+  base::OnceCallback<int(int)> chain = base::BindOnce(&AddOne);
+  for (int i = 0; i < 4; ++i) {
+    chain = std::move(chain).Then(base::BindOnce(&AddOne));
+  }
+  const auto stats_after = base::PoolAllocator::GetStats();
+
+  // Sized for 2, 4 and then 8 stages.
+  EXPECT_EQ(stats_after.allocations, stats_before.allocations + 3);
+  EXPECT_EQ(stats_after.frees, stats_before.frees + 2);
+  EXPECT_EQ(std::move(chain).Run(0), 5);
+}
+
 }  // namespace
@@ -0,0 +1,237 @@
+#include "base/callback_list.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/bind.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+void AppendValue(std::vector<int>* results, int value) {
+  results->push_back(value);
+}
+
+void AppendTenfoldValue(std::vector<int>* results, int value) {
+  results->push_back(value * 10);
+}
+
+void Increment(int* counter) {
+  ++(*counter);
+}
+
+void SetTrue(bool* flag) {
+  *flag = true;
+}
+
+TEST(CallbackListTest, NotifyRunsAllCallbacks) {
+  base::RepeatingCallbackList<void(int)> list;
+  EXPECT_TRUE(list.empty());
+
+  std::vector<int> results;
+  auto subscription_1 = list.Add(base::BindRepeating(&AppendValue, &results));
+  auto subscription_2 =
+      list.Add(base::BindRepeating(&AppendTenfoldValue, &results));
+  EXPECT_FALSE(list.empty());
+
+  list.Notify(1);
+  list.Notify(2);
+  EXPECT_EQ(results, (std::vector<int>{1, 10, 2, 20}));
+}
+
+TEST(CallbackListTest, DestroyedSubscriptionRemovesCallback) {
+  base::RepeatingClosureList list;
+
+  int counter = 0;
+  auto subscription = list.Add(base::BindRepeating(&Increment, &counter));
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+
+  subscription = {};
+  EXPECT_FALSE(subscription);
+  EXPECT_TRUE(list.empty());
+
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+}
+
+TEST(CallbackListTest, MovedSubscriptionKeepsCallback) {
+  base::RepeatingClosureList list;
+
+  int counter = 0;
+  std::optional<base::CallbackListSubscription> moved_subscription;
+  {
+    auto subscription = list.Add(base::BindRepeating(&Increment, &counter));
+    moved_subscription.emplace(std::move(subscription));
+  }
+
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+
+  moved_subscription.reset();
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+}
+
+TEST(CallbackListTest, SubscriptionOutlivesList) {
+  base::CallbackListSubscription subscription;
+  {
+    base::RepeatingClosureList list;
+    subscription = list.Add(base::BindRepeating([]() {}));
+  }
+  EXPECT_TRUE(subscription);
+  // Destroying the subscription must be a no-op.
+}
+
+TEST(CallbackListTest, CallbackRemovesItselfDuringNotify) {
+  base::RepeatingClosureList list;
+
+  int counter = 0;
+  std::unique_ptr<base::CallbackListSubscription> subscription;
+  subscription = std::make_unique<base::CallbackListSubscription>(
+      list.Add(base::BindRepeating(
+          [](int* run_count,
+             std::unique_ptr<base::CallbackListSubscription>* self) {
+            ++(*run_count);
+            self->reset();
+          },
+          &counter, &subscription)));
+
+  int other_counter = 0;
+  auto other_subscription =
+      list.Add(base::BindRepeating(&Increment, &other_counter));
+
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+  EXPECT_EQ(other_counter, 1);
+
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+  EXPECT_EQ(other_counter, 2);
+}
+
+TEST(CallbackListTest, CallbackRemovesOtherDuringNotify) {
+  base::RepeatingClosureList list;
+
+  int counter = 0;
+  base::CallbackListSubscription removed_subscription;
+  auto removing_subscription = list.Add(base::BindRepeating(
+      [](base::CallbackListSubscription* other) { *other = {}; },
+      &removed_subscription));
+  removed_subscription = list.Add(base::BindRepeating(&Increment, &counter));
+
+  list.Notify();
+  EXPECT_EQ(counter, 0);
+  EXPECT_FALSE(list.empty());
+}
+
+TEST(CallbackListTest, CallbackAddedDuringNotifyIsRun) {
+  base::RepeatingClosureList list;
+
+  int counter = 0;
+  base::CallbackListSubscription added_subscription;
+  auto adding_subscription = list.Add(base::BindRepeating(
+      [](base::RepeatingClosureList* target_list, int* run_count,
+         base::CallbackListSubscription* added) {
+        if (!*added) {
+          *added = target_list->Add(base::BindRepeating(&Increment, run_count));
+        }
+      },
+      &list, &counter, &added_subscription));
+
+  list.Notify();
+  EXPECT_EQ(counter, 1);
+  list.Notify();
+  EXPECT_EQ(counter, 2);
+}
+
+TEST(CallbackListTest, NestedNotify) {
+  base::RepeatingCallbackList<void(int)> list;
+
+  std::vector<int> results;
+  auto subscription_1 = list.Add(base::BindRepeating(
+      [](base::RepeatingCallbackList<void(int)>* target_list,
+         std::vector<int>* out, int depth) {
+        out->push_back(depth);
+        if (depth == 0) {
+          target_list->Notify(depth + 1);
+        }
+      },
+      &list, &results));
+  base::CallbackListSubscription subscription_2;
+  subscription_2 = list.Add(base::BindRepeating(
+      [](base::CallbackListSubscription* self, std::vector<int>* out,
+         int depth) {
+        out->push_back(depth * 10);
+        *self = {};
+      },
+      &subscription_2, &results));
+
+  list.Notify(0);
+  EXPECT_EQ(results, (std::vector<int>{0, 1, 10}));
+  EXPECT_FALSE(list.empty());
+}
+
+TEST(OnceCallbackListTest, CallbacksAreRunOnce) {
+  base::OnceCallbackList<void(int)> list;
+
+  std::vector<int> results;
+  auto subscription_1 = list.Add(base::BindOnce(&AppendValue, &results));
+  auto subscription_2 = list.Add(base::BindOnce(&AppendTenfoldValue, &results));
+
+  list.Notify(1);
+  EXPECT_TRUE(list.empty());
+  list.Notify(2);
+  EXPECT_EQ(results, (std::vector<int>{1, 10}));
+
+  auto subscription_3 = list.Add(base::BindOnce(&AppendValue, &results));
+  list.Notify(3);
+  EXPECT_EQ(results, (std::vector<int>{1, 10, 3}));
+}
+
+TEST(OnceCallbackListTest, DestroyedSubscriptionRemovesCallback) {
+  base::OnceClosureList list;
+
+  bool called = false;
+  {
+    auto subscription = list.Add(base::BindOnce(&SetTrue, &called));
+  }
+  EXPECT_TRUE(list.empty());
+
+  list.Notify();
+  EXPECT_FALSE(called);
+}
+
+TEST(OnceCallbackListTest, CallbackDestroysOwnSubscription) {
+  base::OnceClosureList list;
+
+  bool called = false;
+  std::unique_ptr<base::CallbackListSubscription> subscription;
+  subscription = std::make_unique<base::CallbackListSubscription>(
+      list.Add(base::BindOnce(
+          [](bool* flag,
+             std::unique_ptr<base::CallbackListSubscription>* self) {
+            *flag = true;
+            self->reset();
+          },
+          &called, &subscription)));
+
+  list.Notify();
+  EXPECT_TRUE(called);
+  EXPECT_FALSE(subscription);
+}
+
+TEST(OnceCallbackListTest, SubscriptionOfRunCallbackOutlivesList) {
+  base::CallbackListSubscription subscription;
+  bool called = false;
+  {
+    base::OnceClosureList list;
+    subscription = list.Add(base::BindOnce(&SetTrue, &called));
+    list.Notify();
+  }
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(subscription);
+}
+
+}  // namespace
@@ -0,0 +1,179 @@
+#include "base/memory/pool_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr size_t kTestedSizes[] = {1, 8, 16, 17, 100, 255, 512, 1000, 1024};
+
+TEST(PoolAllocatorTest, AllocatesAlignedBlocks) {
+  for (size_t size : kTestedSizes) {
+    void* ptr = base::PoolAllocator::Allocate(size);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0u);
+    std::memset(ptr, 0xAB, size);
+    base::PoolAllocator::Free(ptr, size);
+  }
+}
+
+TEST(PoolAllocatorTest, ReusesFreedBlocks) {
+  void* first = base::PoolAllocator::Allocate(48);
+  base::PoolAllocator::Free(first, 48);
+
+  void* second = base::PoolAllocator::Allocate(48);
+  EXPECT_EQ(first, second);
+  base::PoolAllocator::Free(second, 48);
+}
+
+TEST(PoolAllocatorTest, DoesNotPoolLargeAllocations) {
+  const auto stats_before = base::PoolAllocator::GetStats();
+
+  const size_t size = base::PoolAllocator::kMaxPooledSize + 1;
+  void* ptr = base::PoolAllocator::Allocate(size);
+  base::PoolAllocator::Free(ptr, size);
+
+  const auto stats_after = base::PoolAllocator::GetStats();
+  EXPECT_EQ(stats_after.unpooled_allocations,
+            stats_before.unpooled_allocations + 1);
+}
+
+TEST(PoolAllocatorTest, ReusesBlocksFreedOnOtherThread) {
+  const size_t kSize = 768;
+  const size_t kBlocksCount = 201;
+
+  // Every other block is kept, so that slabs of the freed blocks don't become
+  // empty and returned to the system.
+  std::vector<void*> kept_blocks;
+  std::set<void*> freed_blocks;
+  for (size_t i = 0; i < kBlocksCount; ++i) {
+    void* ptr = base::PoolAllocator::Allocate(kSize);
+    if (i % 2 == 0) {
+      kept_blocks.push_back(ptr);
+    } else {
+      freed_blocks.insert(ptr);
+    }
+  }
+
+  const auto stats_before = base::PoolAllocator::GetStats();
+  std::thread{[&]() {
+    for (void* ptr : freed_blocks) {
+      base::PoolAllocator::Free(ptr, kSize);
+    }
+  }}.join();
+  const auto stats_after = base::PoolAllocator::GetStats();
+  EXPECT_EQ(stats_after.remote_frees,
+            stats_before.remote_frees + freed_blocks.size());
+
+  // Blocks freed remotely are eventually handed out again by this thread.
+  std::vector<void*> reallocated_blocks;
+  size_t reused_count = 0;
+  while (reused_count < freed_blocks.size() &&
+         reallocated_blocks.size() < 100 * kBlocksCount) {
+    reallocated_blocks.push_back(base::PoolAllocator::Allocate(kSize));
+    reused_count += freed_blocks.count(reallocated_blocks.back());
+  }
+  EXPECT_EQ(reused_count, freed_blocks.size());
+
+  for (void* ptr : reallocated_blocks) {
+    base::PoolAllocator::Free(ptr, kSize);
+  }
+  for (void* ptr : kept_blocks) {
+    base::PoolAllocator::Free(ptr, kSize);
+  }
+}
+
+TEST(PoolAllocatorTest, UsesIntermediateSizeClasses) {
+  const size_t kSize = 288;
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 100; ++i) {
+    blocks.push_back(base::PoolAllocator::Allocate(kSize));
+  }
+
+  // Blocks of the next power of two (512 bytes) would be too wasteful.
+  std::sort(blocks.begin(), blocks.end());
+  uintptr_t min_distance = UINTPTR_MAX;
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    min_distance = std::min(min_distance,
+                            reinterpret_cast<uintptr_t>(blocks[i]) -
+                                reinterpret_cast<uintptr_t>(blocks[i - 1]));
+  }
+  EXPECT_LE(min_distance, 320u);
+
+  for (void* ptr : blocks) {
+    base::PoolAllocator::Free(ptr, kSize);
+  }
+}
+
+TEST(PoolAllocatorTest, ReleasesEmptySlabs) {
+  const size_t kSize = 512;
+  const size_t kBlocksCount = 1000;
+
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < kBlocksCount; ++i) {
+    blocks.push_back(base::PoolAllocator::Allocate(kSize));
+  }
+  const auto stats_allocated = base::PoolAllocator::GetStats();
+
+  for (void* ptr : blocks) {
+    base::PoolAllocator::Free(ptr, kSize);
+  }
+
+  // Empty slabs are kept for a while, unless the cache is trimmed.
+  base::PoolAllocator::Trim();
+  const auto stats_trimmed = base::PoolAllocator::GetStats();
+  EXPECT_LT(stats_trimmed.reserved_bytes, stats_allocated.reserved_bytes);
+}
+
+TEST(PoolAllocatorTest, FreesBlocksOfExitedThreads) {
+  std::vector<void*> blocks;
+  std::thread{[&]() {
+    for (size_t size : kTestedSizes) {
+      blocks.push_back(base::PoolAllocator::Allocate(size));
+    }
+  }}.join();
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    base::PoolAllocator::Free(blocks[i], kTestedSizes[i]);
+  }
+}
+
+TEST(PoolAllocatorTest, ReusesCachesOfExitedThreads) {
+  auto allocate_and_free = []() {
+    void* ptr = base::PoolAllocator::Allocate(32);
+    base::PoolAllocator::Free(ptr, 32);
+  };
+
+  std::thread{allocate_and_free}.join();
+  const auto stats_before = base::PoolAllocator::GetStats();
+  for (int i = 0; i < 10; ++i) {
+    std::thread{allocate_and_free}.join();
+  }
+  const auto stats_after = base::PoolAllocator::GetStats();
+
+  EXPECT_EQ(stats_after.thread_caches, stats_before.thread_caches);
+}
+
+TEST(PoolAllocatorTest, StlAllocator) {
+  std::list<std::vector<int>, base::PoolStlAllocator<std::vector<int>>> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.push_back(std::vector<int>(3, i));
+  }
+
+  int expected = 0;
+  for (const auto& element : list) {
+    EXPECT_EQ(element[2], expected++);
+  }
+  list.clear();
+  EXPECT_TRUE(list.empty());
+}
+
+}  // namespace
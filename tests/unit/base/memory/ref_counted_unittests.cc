@@ -0,0 +1,169 @@
+#include "base/memory/ref_counted.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class Object : public base::RefCountedThreadSafe<Object> {
+ public:
+  explicit Object(int* destroyed_count) : destroyed_count_(destroyed_count) {}
+  virtual ~Object() { ++(*destroyed_count_); }
+
+ private:
+  int* destroyed_count_;
+};
+
+class DerivedObject : public Object {
+ public:
+  DerivedObject(int* destroyed_count, int* derived_destroyed_count)
+      : Object(destroyed_count),
+        derived_destroyed_count_(derived_destroyed_count) {}
+  ~DerivedObject() override { ++(*derived_destroyed_count_); }
+
+ private:
+  int* derived_destroyed_count_;
+};
+
+class AtomicObject : public base::RefCountedThreadSafe<AtomicObject> {
+ public:
+  explicit AtomicObject(std::atomic_int* destroyed_count)
+      : destroyed_count_(destroyed_count) {}
+
+ private:
+  friend class base::RefCountedThreadSafe<AtomicObject>;
+
+  ~AtomicObject() { ++(*destroyed_count_); }
+
+  std::atomic_int* destroyed_count_;
+};
+
+TEST(RefCountedTest, MakeRefCountedHoldsSingleReference) {
+  int destroyed_count = 0;
+
+  auto object = base::MakeRefCounted<Object>(&destroyed_count);
+  ASSERT_TRUE(object);
+  EXPECT_TRUE(object->HasOneRef());
+
+  object.reset();
+  EXPECT_FALSE(object);
+  EXPECT_EQ(destroyed_count, 1);
+}
+
+TEST(RefCountedTest, DestroyedWithLastReference) {
+  int destroyed_count = 0;
+
+  auto object = base::MakeRefCounted<Object>(&destroyed_count);
+  {
+    base::scoped_refptr<Object> copy = object;
+    EXPECT_EQ(copy, object);
+    EXPECT_FALSE(object->HasOneRef());
+  }
+  EXPECT_TRUE(object->HasOneRef());
+  EXPECT_EQ(destroyed_count, 0);
+
+  object = nullptr;
+  EXPECT_EQ(destroyed_count, 1);
+}
+
+TEST(RefCountedTest, MoveTransfersReference) {
+  int destroyed_count = 0;
+
+  auto object = base::MakeRefCounted<Object>(&destroyed_count);
+  Object* raw_object = object.get();
+
+  base::scoped_refptr<Object> moved = std::move(object);
+  EXPECT_FALSE(object);
+  EXPECT_EQ(moved.get(), raw_object);
+  EXPECT_TRUE(moved->HasOneRef());
+
+  object = std::move(moved);
+  EXPECT_EQ(object.get(), raw_object);
+  EXPECT_EQ(destroyed_count, 0);
+}
+
+TEST(RefCountedTest, RawPointerTakesNewReference) {
+  int destroyed_count = 0;
+
+  auto object = base::MakeRefCounted<Object>(&destroyed_count);
+  base::scoped_refptr<Object> other = object.get();
+  EXPECT_FALSE(object->HasOneRef());
+
+  object.reset();
+  EXPECT_EQ(destroyed_count, 0);
+  EXPECT_TRUE(other->HasOneRef());
+}
+
+TEST(RefCountedTest, SelfAssignmentKeepsReference) {
+  int destroyed_count = 0;
+
+  auto object = base::MakeRefCounted<Object>(&destroyed_count);
+  auto& same_object = object;
+  object = same_object;
+
+  EXPECT_TRUE(object->HasOneRef());
+  EXPECT_EQ(destroyed_count, 0);
+}
+
+TEST(RefCountedTest, ConvertsToBaseClass) {
+  int destroyed_count = 0;
+  int derived_destroyed_count = 0;
+
+  base::scoped_refptr<Object> object = base::MakeRefCounted<DerivedObject>(
+      &destroyed_count, &derived_destroyed_count);
+  EXPECT_TRUE(object->HasOneRef());
+
+  object.reset();
+  EXPECT_EQ(destroyed_count, 1);
+  EXPECT_EQ(derived_destroyed_count, 1);
+}
+
+TEST(RefCountedTest, ComparesAndHashesByPointer) {
+  int destroyed_count = 0;
+
+  auto first = base::MakeRefCounted<Object>(&destroyed_count);
+  auto second = base::MakeRefCounted<Object>(&destroyed_count);
+  base::scoped_refptr<Object> empty;
+
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first, first.get());
+  EXPECT_EQ(empty, nullptr);
+  EXPECT_NE(nullptr, first);
+  EXPECT_TRUE((first < second) != (second < first));
+
+  std::unordered_set<base::scoped_refptr<Object>> objects{first, second};
+  EXPECT_EQ(objects.size(), 2u);
+  EXPECT_EQ(objects.count(first), 1u);
+  EXPECT_EQ(objects.count(empty), 0u);
+}
+
+TEST(RefCountedTest, ReleasedConcurrentlyOnManyThreads) {
+  const size_t kThreadsCount = 8;
+  const size_t kCopiesPerThread = 1000;
+  std::atomic_int destroyed_count{0};
+
+  auto object = base::MakeRefCounted<AtomicObject>(&destroyed_count);
+
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx < kThreadsCount; ++idx) {
+    threads.emplace_back([object]() {
+      for (size_t copy_idx = 0; copy_idx < kCopiesPerThread; ++copy_idx) {
+        base::scoped_refptr<AtomicObject> copy = object;
+        EXPECT_FALSE(copy->HasOneRef());
+      }
+    });
+  }
+  object.reset();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(destroyed_count.load(), 1);
+}
+
+}  // namespace
@@ -176,6 +176,38 @@ TEST_F(WeakPtrFactoryTest, Move) {
   EXPECT_EQ(weak_ptr4.Get(), weak_class_.get());
 }
 
+TEST_F(WeakPtrFactoryTest, CopyAssignmentTracksWeakPtrs) {
+  CreateWeakPtrFactoryOwner();
+
+  auto weak_ptr1 = std::make_unique<base::WeakPtr<WeakPtrFactoryOwner>>(
+      GetWeakPtr());
+  base::WeakPtr<WeakPtrFactoryOwner> weak_ptr2;
+  weak_ptr2 = *weak_ptr1;
+  weak_ptr2 = *weak_ptr1;
+
+  weak_ptr1.reset();
+  EXPECT_TRUE(HasWeakPtrs());
+  EXPECT_EQ(weak_ptr2.Get(), weak_class_.get());
+
+  weak_ptr2 = {};
+  EXPECT_FALSE(HasWeakPtrs());
+}
+
+TEST_F(WeakPtrFactoryTest, WeakPtrsOutliveFactory) {
+  CreateWeakPtrFactoryOwner();
+
+  auto weak_ptr1 = GetWeakPtr();
+  InvalidateWeakPtrs();
+  auto weak_ptr2 = GetWeakPtr();
+  DestroyWeakPtrFactoryOwner();
+
+  auto weak_ptr3 = weak_ptr2;
+  EXPECT_TRUE(weak_ptr1.WasInvalidated());
+  EXPECT_TRUE(weak_ptr2.WasInvalidated());
+  EXPECT_TRUE(weak_ptr3.WasInvalidated());
+  EXPECT_FALSE(weak_ptr3.MaybeValid());
+}
+
 TEST_F(WeakPtrFactoryTest, NullptrComparison) {
   base::WeakPtr<WeakPtrFactoryOwner> weak_ptr1;
   EXPECT_EQ(weak_ptr1, nullptr);
@@ -24,7 +24,7 @@ using ::testing::Test;
 base::MessagePump::PendingTask CreateSequencedPendingTask(
     base::OnceClosure task,
     std::optional<base::SequenceId> sequence_id,
-    std::weak_ptr<base::SequencedTaskRunner> task_runner) {
+    base::scoped_refptr<base::SequencedTaskRunner> task_runner) {
   return {std::move(task), std::move(sequence_id), {}, std::move(task_runner)};
 }
 
@@ -45,13 +45,17 @@ class MessageLoopImplTest : public Test {
  public:
   void SetUp() override {
     const base::MessagePump::ExecutorId executor_id = 0;
-    mock_sequenced_task_runner_ = std::make_shared<MockSequencedTaskRunner>();
-    mock_message_pump_ = std::make_shared<MockMessagePump>();
+    mock_sequenced_task_runner_ =
+        base::MakeRefCounted<MockSequencedTaskRunner>();
+    mock_message_pump_ = base::MakeRefCounted<MockMessagePump>();
     message_loop_impl_ = std::make_unique<base::MessageLoopImpl>(
         executor_id, mock_message_pump_);
 
     EXPECT_CALL(*mock_sequenced_task_runner_, RunsTasksInCurrentSequence())
         .WillRepeatedly(Return(true));
+    // Loops look for idle tasks whenever they run out of regular ones.
+    EXPECT_CALL(*mock_message_pump_, GetNextIdleTask(_))
+        .WillRepeatedly([]() { return base::MessagePump::PendingIdleTask{}; });
   }
 
   void TearDown() override {
@@ -76,8 +80,8 @@ class MessageLoopImplTest : public Test {
   }
 
  protected:
-  std::shared_ptr<MockSequencedTaskRunner> mock_sequenced_task_runner_;
-  std::shared_ptr<MockMessagePump> mock_message_pump_;
+  base::scoped_refptr<MockSequencedTaskRunner> mock_sequenced_task_runner_;
+  base::scoped_refptr<MockMessagePump> mock_message_pump_;
   std::unique_ptr<base::MessageLoopImpl> message_loop_impl_;
 };
 
@@ -1,9 +1,13 @@
 #include <atomic>
 #include <future>
+#include <memory>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/callback_helpers.h"
+#include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_pump_impl.h"
 
 #include "gtest/gtest.h"
@@ -21,7 +25,7 @@ base::MessagePump::PendingTask CreateExecutorTask(
   return {std::move(task),
           {},
           std::move(executor_id),
-          std::weak_ptr<base::SequencedTaskRunner>{}};
+          base::scoped_refptr<base::SequencedTaskRunner>{}};
 }
 
 base::MessagePump::PendingTask CreateSequenceTask(
@@ -30,7 +34,7 @@ base::MessagePump::PendingTask CreateSequenceTask(
   return {std::move(task),
           std::move(sequence_id),
           {},
-          std::weak_ptr<base::SequencedTaskRunner>{}};
+          base::scoped_refptr<base::SequencedTaskRunner>{}};
 }
 
 base::MessagePump::PendingTask CreateTask(base::OnceClosure task) {
@@ -65,6 +69,94 @@ base::MessagePump::PendingTask CreateSetterSequenceTask(
       std::move(sequence_id));
 }
 
+base::MessagePump::PendingTask CreateDeadlineTask(
+    std::vector<int>& order,
+    int value,
+    std::optional<base::SequenceId> sequence_id,
+    std::optional<base::TimeTicks> deadline) {
+  return {base::BindOnce([](std::vector<int>* ext_order,
+                            int ext_value) { ext_order->push_back(ext_value); },
+                         &order, value),
+          std::move(sequence_id),
+          {},
+          base::scoped_refptr<base::SequencedTaskRunner>{},
+          std::move(deadline)};
+}
+
+base::MessagePump::PendingTask CreateConcurrencyLimitedTask(
+    std::vector<int>& order,
+    int value,
+    std::optional<base::MessagePump::ConcurrencyLimit> concurrency_limit,
+    std::optional<base::TimeTicks> deadline = {}) {
+  return {base::BindOnce([](std::vector<int>* ext_order,
+                            int ext_value) { ext_order->push_back(ext_value); },
+                         &order, value),
+          {},
+          {},
+          base::scoped_refptr<base::SequencedTaskRunner>{},
+          std::move(deadline),
+          {},
+          std::move(concurrency_limit)};
+}
+
+base::MessagePump::PendingTask CreateExpiringTask(
+    bool& flag,
+    base::TimeTicks expiration_time,
+    base::OnceClosure on_dropped) {
+  EXPECT_FALSE(flag);
+  return {base::BindOnce([](bool* ext_flag) { *ext_flag = true; }, &flag),
+          {},
+          {},
+          base::scoped_refptr<base::SequencedTaskRunner>{},
+          {},
+          std::make_unique<base::MessagePump::TaskExpiry>(
+              base::MessagePump::TaskExpiry{expiration_time,
+                                            std::move(on_dropped), FROM_HERE})};
+}
+
+base::MessagePump::PendingIdleTask CreateSetterIdleTask(
+    std::optional<base::MessagePump::ExecutorId> executor_id,
+    bool& flag) {
+  EXPECT_FALSE(flag);
+  return {base::BindOnce([](bool* ext_flag,
+                            base::TimeTicks /*deadline*/) { *ext_flag = true; },
+                         &flag),
+          {},
+          std::move(executor_id),
+          base::scoped_refptr<base::SequencedTaskRunner>{}};
+}
+
+class WeakTarget {
+ public:
+  void SetFlag(bool* flag) { *flag = true; }
+  void Consume(std::shared_ptr<int> /*value*/) {}
+
+  base::WeakPtr<WeakTarget> GetWeakPtr() const {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  base::WeakPtrFactory<WeakTarget> weak_factory_{this};
+};
+
+// Queues a task setting |flag| to |pump| when destroyed.
+class PostsOnDestruction {
+ public:
+  PostsOnDestruction(base::MessagePump* pump, bool* flag)
+      : pump_(pump), flag_(flag) {}
+  PostsOnDestruction(PostsOnDestruction&& other) noexcept
+      : pump_(std::exchange(other.pump_, nullptr)), flag_(other.flag_) {}
+  ~PostsOnDestruction() {
+    if (pump_) {
+      pump_->QueuePendingTask(CreateSetterTask(*flag_));
+    }
+  }
+
+ private:
+  base::MessagePump* pump_;
+  bool* flag_;
+};
+
 class MessagePumpImplTest : public ::testing::Test {
  public:
   MessagePumpImplTest() : pump(kExecutorCount) {}
@@ -100,6 +192,25 @@ TEST_F(MessagePumpImplTest, NoTasksAfterStopAndTaskQueued) {
   EXPECT_FALSE(pump.GetNextPendingTask(kExecutorId, true));
 }
 
+TEST_F(MessagePumpImplTest, DropPendingTasksDestroysQueuedTasks) {
+  auto value = std::make_shared<int>(0);
+  bool idle_task_flag = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateExecutorTask(
+      base::BindOnce([](std::shared_ptr<int> /*value*/) {}, value),
+      kOtherExecutorId)));
+  EXPECT_TRUE(
+      pump.QueueIdleTask(CreateSetterIdleTask(kExecutorId, idle_task_flag)));
+  pump.Stop(CreateEmptyTask());
+  EXPECT_EQ(value.use_count(), 2);
+
+  pump.DropPendingTasks();
+  EXPECT_EQ(value.use_count(), 1);
+  EXPECT_FALSE(pump.GetNextPendingTask(kOtherExecutorId, false));
+  EXPECT_FALSE(pump.GetNextIdleTask(kExecutorId));
+  EXPECT_FALSE(idle_task_flag);
+}
+
 TEST_F(MessagePumpImplTest, DequeueInCorrectOrder) {
   bool task1_flag = false;
   bool task2_flag = false;
@@ -195,6 +306,76 @@ TEST_F(MessagePumpImplTest, DequeueSkipsTasksFromActiveSequences) {
   EXPECT_TRUE(task3_sequence2);
 }
 
+TEST_F(MessagePumpImplTest, HasPendingTasksForExecutor) {
+  const auto sequence_1 =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+
+  bool task1_sequence1 = false;
+  bool task2_sequence1 = false;
+  bool task3_other_executor = false;
+
+  EXPECT_FALSE(pump.HasPendingTasks(kExecutorId));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateSetterSequenceTask(sequence_1, task1_sequence1)));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateSetterSequenceTask(sequence_1, task2_sequence1)));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateSetterExecutorTask(kOtherExecutorId, task3_other_executor)));
+
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task1.task);
+
+  // Second task of the sequence waits only for the executor processing the
+  // first one.
+  EXPECT_TRUE(pump.HasPendingTasks(kExecutorId));
+  EXPECT_TRUE(pump.HasPendingTasks(kOtherExecutorId));
+
+  auto task3 = pump.GetNextPendingTask(kOtherExecutorId, false);
+  ASSERT_TRUE(task3.task);
+  EXPECT_TRUE(pump.HasPendingTasks(kExecutorId));
+  EXPECT_FALSE(pump.HasPendingTasks(kOtherExecutorId));
+
+  pump.Stop({});
+  EXPECT_FALSE(pump.HasPendingTasks(kExecutorId));
+}
+
+TEST_F(MessagePumpImplTest, HasPendingTasksBeyondIdleExecutors) {
+  bool task1_executed = false;
+  bool task2_executed = false;
+  bool task3_executed = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task1_executed)));
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task1.task);
+
+  // The other executor is idle and picks up a single task on its own.
+  EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task2_executed)));
+  EXPECT_FALSE(pump.HasPendingTasks(kExecutorId));
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task3_executed)));
+  EXPECT_TRUE(pump.HasPendingTasks(kExecutorId));
+}
+
+TEST_F(MessagePumpImplTest, HasPendingTasksIgnoresCancelledTasks) {
+  auto target = std::make_unique<WeakTarget>();
+  bool task_executed = false;
+  bool cancelled_task_executed = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateSetterExecutorTask(kExecutorId, task_executed)));
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task.task);
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateExecutorTask(
+      base::BindOnce(&WeakTarget::SetFlag, target->GetWeakPtr(),
+                     &cancelled_task_executed),
+      kExecutorId)));
+  EXPECT_TRUE(pump.HasPendingTasks(kExecutorId));
+
+  target.reset();
+  EXPECT_FALSE(pump.HasPendingTasks(kExecutorId));
+}
+
 TEST_F(MessagePumpImplTest, DequeueOnEmptyPumpWaitsForStop) {
   using namespace std::chrono_literals;
 
@@ -252,4 +433,395 @@ TEST_F(MessagePumpImplTest, DequeueOnBlockedSequencedWaitsForStop) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(MessagePumpImplTest, IdleTaskDequeuedOnlyWithoutPendingTasks) {
+  bool task_executed = false;
+  bool idle_task_executed = false;
+
+  EXPECT_TRUE(pump.QueueIdleTask(
+      CreateSetterIdleTask(kExecutorId, idle_task_executed)));
+  EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task_executed)));
+  EXPECT_FALSE(pump.GetNextIdleTask(kExecutorId));
+
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task);
+  std::move(task.task).Run();
+  EXPECT_TRUE(task_executed);
+
+  auto idle_task = pump.GetNextIdleTask(kExecutorId);
+  ASSERT_TRUE(idle_task);
+  std::move(idle_task.task).Run(base::TimeTicks::Now());
+  EXPECT_TRUE(idle_task_executed);
+
+  EXPECT_FALSE(pump.GetNextIdleTask(kExecutorId));
+}
+
+TEST_F(MessagePumpImplTest, IdleTaskDequeuedOnlyForAllowedExecutor) {
+  bool idle_task_executed = false;
+
+  EXPECT_TRUE(pump.QueueIdleTask(
+      CreateSetterIdleTask(kExecutorId, idle_task_executed)));
+  EXPECT_FALSE(pump.GetNextIdleTask(kOtherExecutorId));
+
+  auto idle_task = pump.GetNextIdleTask(kExecutorId);
+  ASSERT_TRUE(idle_task);
+  std::move(idle_task.task).Run(base::TimeTicks::Now());
+  EXPECT_TRUE(idle_task_executed);
+}
+
+TEST_F(MessagePumpImplTest, NoIdleTasksAfterStop) {
+  bool idle_task_executed = false;
+
+  EXPECT_TRUE(pump.QueueIdleTask(
+      CreateSetterIdleTask(kExecutorId, idle_task_executed)));
+  pump.Stop(CreateEmptyTask());
+
+  EXPECT_FALSE(pump.GetNextIdleTask(kExecutorId));
+  EXPECT_FALSE(pump.QueueIdleTask(
+      CreateSetterIdleTask(kExecutorId, idle_task_executed)));
+}
+
+TEST_F(MessagePumpImplTest, DequeueOnEmptyPumpWakesUpForIdleTask) {
+  using namespace std::chrono_literals;
+
+  bool idle_task_executed = false;
+  std::atomic_bool dequeue_finished = false;
+
+  const auto async_result = std::async(std::launch::async, [&]() {
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(dequeue_finished);
+    EXPECT_TRUE(pump.QueueIdleTask(
+        CreateSetterIdleTask(kExecutorId, idle_task_executed)));
+  });
+  const auto result = pump.GetNextPendingTask(kExecutorId, true);
+  dequeue_finished = true;
+  EXPECT_FALSE(result);
+  EXPECT_TRUE(pump.GetNextIdleTask(kExecutorId));
+}
+
+TEST_F(MessagePumpImplTest, TracksDelayedWakeUpsPerExecutor) {
+  const auto now = base::TimeTicks::Now();
+
+  EXPECT_FALSE(pump.GetNextDelayedWakeUp(kExecutorId));
+
+  pump.AddDelayedWakeUp(now + base::Seconds(1), kOtherExecutorId);
+  pump.AddDelayedWakeUp(now + base::Seconds(3), kExecutorId);
+  EXPECT_EQ(pump.GetNextDelayedWakeUp(kExecutorId), now + base::Seconds(3));
+  EXPECT_EQ(pump.GetNextDelayedWakeUp(kOtherExecutorId),
+            now + base::Seconds(1));
+
+  // Tasks that are not bound to any executor wake up all of them.
+  pump.AddDelayedWakeUp(now + base::Seconds(2), std::nullopt);
+  EXPECT_EQ(pump.GetNextDelayedWakeUp(kExecutorId), now + base::Seconds(2));
+
+  pump.RemoveDelayedWakeUp(now + base::Seconds(2), std::nullopt);
+  pump.RemoveDelayedWakeUp(now + base::Seconds(3), kExecutorId);
+  EXPECT_FALSE(pump.GetNextDelayedWakeUp(kExecutorId));
+  EXPECT_EQ(pump.GetNextDelayedWakeUp(kOtherExecutorId),
+            now + base::Seconds(1));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEarliestDeadlineFirst) {
+  const auto now = base::TimeTicks::Now();
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateDeadlineTask(order, 4, {}, {})));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 3, {}, now + base::Seconds(3))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 1, {}, now + base::Seconds(1))));
+  EXPECT_TRUE(pump.QueuePendingTask(CreateDeadlineTask(order, 5, {}, {})));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 2, {}, now + base::Seconds(2))));
+
+  while (auto task = pump.GetNextPendingTask(kExecutorId, false)) {
+    std::move(task.task).Run();
+  }
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEarliestDeadlineFirstKeepsSequenceOrder) {
+  const auto now = base::TimeTicks::Now();
+  const auto sequence_id_1 =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+  const auto sequence_id_2 =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 2, sequence_id_1, now + base::Seconds(3))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 3, sequence_id_1, now + base::Seconds(1))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 1, sequence_id_2, now + base::Seconds(2))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 4, sequence_id_2, now + base::Seconds(4))));
+
+  while (auto task = pump.GetNextPendingTask(kExecutorId, false)) {
+    std::move(task.task).Run();
+  }
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEarliestDeadlineSkipsActiveSequences) {
+  const auto now = base::TimeTicks::Now();
+  const auto sequence_id =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 1, sequence_id, now + base::Seconds(1))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 2, sequence_id, now + base::Seconds(2))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 3, {}, now + base::Seconds(3))));
+
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  auto task3 = pump.GetNextPendingTask(kOtherExecutorId, false);
+  EXPECT_FALSE(pump.GetNextPendingTask(kOtherExecutorId, false));
+  ASSERT_TRUE(task1);
+  ASSERT_TRUE(task3);
+  std::move(task1.task).Run();
+  std::move(task3.task).Run();
+
+  auto task2 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task2);
+  std::move(task2.task).Run();
+  EXPECT_EQ(order, (std::vector<int>{1, 3, 2}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueRespectsConcurrencyLimit) {
+  const base::MessagePump::ConcurrencyLimit concurrency_limit{1, 1};
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateConcurrencyLimitedTask(order, 1, concurrency_limit)));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateConcurrencyLimitedTask(order, 2, concurrency_limit)));
+  EXPECT_TRUE(
+      pump.QueuePendingTask(CreateConcurrencyLimitedTask(order, 3, {})));
+
+  // The limit is reached, so the other executor skips to the unlimited task.
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  auto task3 = pump.GetNextPendingTask(kOtherExecutorId, false);
+  EXPECT_FALSE(pump.GetNextPendingTask(kOtherExecutorId, false));
+  ASSERT_TRUE(task1);
+  ASSERT_TRUE(task3);
+  std::move(task1.task).Run();
+  std::move(task3.task).Run();
+
+  auto task2 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task2);
+  std::move(task2.task).Run();
+  EXPECT_EQ(order, (std::vector<int>{1, 3, 2}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEarliestDeadlineRespectsConcurrencyLimit) {
+  const auto now = base::TimeTicks::Now();
+  const base::MessagePump::ConcurrencyLimit concurrency_limit{2, 1};
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateConcurrencyLimitedTask(
+      order, 1, concurrency_limit, now + base::Seconds(1))));
+  EXPECT_TRUE(pump.QueuePendingTask(CreateConcurrencyLimitedTask(
+      order, 2, concurrency_limit, now + base::Seconds(2))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateConcurrencyLimitedTask(order, 3, {}, now + base::Seconds(3))));
+
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  auto task3 = pump.GetNextPendingTask(kOtherExecutorId, false);
+  ASSERT_TRUE(task1);
+  ASSERT_TRUE(task3);
+  std::move(task1.task).Run();
+  std::move(task3.task).Run();
+
+  auto task2 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task2);
+  std::move(task2.task).Run();
+  EXPECT_EQ(order, (std::vector<int>{1, 3, 2}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEqualDeadlinesInFifoOrder) {
+  const auto deadline = base::TimeTicks::Now() + base::Seconds(1);
+  const auto sequence_id =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 1, sequence_id, deadline)));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 2, sequence_id, deadline)));
+  EXPECT_TRUE(
+      pump.QueuePendingTask(CreateDeadlineTask(order, 3, {}, deadline)));
+
+  auto task1 = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task1);
+  std::move(task1.task).Run();
+
+  // Queued after the tasks above, so it runs after them despite the deadline.
+  EXPECT_TRUE(
+      pump.QueuePendingTask(CreateDeadlineTask(order, 4, {}, deadline)));
+
+  while (auto task = pump.GetNextPendingTask(kExecutorId, false)) {
+    std::move(task.task).Run();
+  }
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST_F(MessagePumpImplTest, DequeueEarliestDeadlineFirstAfterSweep) {
+  const auto now = base::TimeTicks::Now();
+  const auto sequence_id =
+      base::detail::SequenceIdGenerator::GetNextSequenceId();
+  auto target = std::make_unique<WeakTarget>();
+  bool cancelled_task_executed = false;
+  std::vector<int> order;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateSequenceTask(base::BindOnce(&WeakTarget::SetFlag,
+                                        target->GetWeakPtr(),
+                                        &cancelled_task_executed),
+                         sequence_id)));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 3, sequence_id, now + base::Seconds(1))));
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 1, {}, now + base::Seconds(2))));
+  target.reset();
+
+  // Sweeps the cancelled task, so the sequence's deadline task comes first.
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(pump.QueuePendingTask(CreateEmptyTask()));
+  }
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateDeadlineTask(order, 2, {}, now + base::Seconds(3))));
+
+  while (auto task = pump.GetNextPendingTask(kExecutorId, false)) {
+    if (task.deadline) {
+      std::move(task.task).Run();
+    }
+  }
+  EXPECT_FALSE(cancelled_task_executed);
+  EXPECT_EQ(order, (std::vector<int>{3, 1, 2}));
+}
+
+TEST_F(MessagePumpImplTest, ExpiredTasksAreDropped) {
+  const auto now = base::TimeTicks::Now();
+  bool expired_task_executed = false;
+  bool task_executed = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateExpiringTask(expired_task_executed, now, {})));
+  EXPECT_TRUE(pump.QueuePendingTask(CreateExpiringTask(
+      task_executed, now + base::Seconds(60), base::OnceClosure{})));
+
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task);
+  std::move(task.task).Run();
+  EXPECT_FALSE(expired_task_executed);
+  EXPECT_TRUE(task_executed);
+  EXPECT_FALSE(pump.GetNextPendingTask(kExecutorId, false));
+}
+
+TEST_F(MessagePumpImplTest, ExpiredTaskReplacedWithOnDropped) {
+  bool task_executed = false;
+  bool on_dropped_executed = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(CreateExpiringTask(
+      task_executed, base::TimeTicks::Now() - base::Seconds(1),
+      base::BindOnce([](bool* ext_flag) { *ext_flag = true; },
+                     &on_dropped_executed))));
+
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task);
+  std::move(task.task).Run();
+  EXPECT_FALSE(task_executed);
+  EXPECT_TRUE(on_dropped_executed);
+}
+
+TEST_F(MessagePumpImplTest, DroppedTasksAreDestroyedOutsideOfLock) {
+  auto target = std::make_unique<WeakTarget>();
+  bool cancelled_task_executed = false;
+  bool posted_task_executed = false;
+
+  auto cancelled_task = CreateTask(base::BindOnce(
+      &WeakTarget::SetFlag, target->GetWeakPtr(), &cancelled_task_executed));
+  cancelled_task.expiry = std::make_unique<base::MessagePump::TaskExpiry>(
+      base::MessagePump::TaskExpiry{
+          base::TimeTicks::Now() + base::Seconds(60),
+          base::BindOnce([](const PostsOnDestruction&) {},
+                         PostsOnDestruction{&pump, &posted_task_executed}),
+          FROM_HERE});
+  EXPECT_TRUE(pump.QueuePendingTask(std::move(cancelled_task)));
+  target.reset();
+
+  // Destroying the notification of the dropped task queues a new one.
+  EXPECT_FALSE(pump.GetNextPendingTask(kExecutorId, false));
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task);
+  std::move(task.task).Run();
+  EXPECT_FALSE(cancelled_task_executed);
+  EXPECT_TRUE(posted_task_executed);
+}
+
+TEST_F(MessagePumpImplTest, DequeueWaitsAfterDroppingExpiredTasks) {
+  using namespace std::chrono_literals;
+
+  bool expired_task_executed = false;
+  bool task_executed = false;
+  std::atomic_bool dequeue_finished = false;
+
+  const auto async_result = std::async(std::launch::async, [&]() {
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(pump.QueuePendingTask(CreateExpiringTask(
+        expired_task_executed, base::TimeTicks::Now(), {})));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(dequeue_finished);
+    EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task_executed)));
+  });
+  auto result = pump.GetNextPendingTask(kExecutorId, true);
+  dequeue_finished = true;
+  ASSERT_TRUE(result);
+
+  std::move(result.task).Run();
+  EXPECT_FALSE(expired_task_executed);
+  EXPECT_TRUE(task_executed);
+}
+
+TEST_F(MessagePumpImplTest, CancelledTasksAreDropped) {
+  auto target = std::make_unique<WeakTarget>();
+  bool cancelled_task_executed = false;
+  bool task_executed = false;
+
+  EXPECT_TRUE(pump.QueuePendingTask(
+      CreateTask(base::BindOnce(&WeakTarget::SetFlag, target->GetWeakPtr(),
+                                &cancelled_task_executed))));
+  EXPECT_TRUE(pump.QueuePendingTask(CreateSetterTask(task_executed)));
+  target.reset();
+
+  auto task = pump.GetNextPendingTask(kExecutorId, false);
+  ASSERT_TRUE(task);
+  std::move(task.task).Run();
+  EXPECT_FALSE(cancelled_task_executed);
+  EXPECT_TRUE(task_executed);
+  EXPECT_FALSE(pump.GetNextPendingTask(kExecutorId, false));
+}
+
+TEST_F(MessagePumpImplTest, CancelledTasksAreSweptWhenQueueGrows) {
+  auto target = std::make_unique<WeakTarget>();
+  auto value = std::make_shared<int>(0);
+  const std::weak_ptr<int> weak_value = value;
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(pump.QueuePendingTask(CreateTask(
+        base::BindOnce(&WeakTarget::Consume, target->GetWeakPtr(), value))));
+  }
+  value.reset();
+  target.reset();
+  EXPECT_FALSE(weak_value.expired());
+
+  // Cancelled tasks are released without dequeuing anything.
+  for (int i = 0; i < 1000 && !weak_value.expired(); ++i) {
+    EXPECT_TRUE(pump.QueuePendingTask(CreateEmptyTask()));
+  }
+  EXPECT_TRUE(weak_value.expired());
+}
+
 }  // namespace
@@ -1,5 +1,11 @@
 #include "base/message_loop/run_loop.h"
 
+#include <memory>
+#include <vector>
+
+#include "base/callback_helpers.h"
+#include "base/threading/thread.h"
+
 #include "gtest/gtest.h"
 
 namespace {
@@ -63,14 +69,14 @@ TEST_F(RunLoopTest, RunUntilIdle_MultipleTasks) {
   run_loop_->TaskRunner()->PostTask(
       FROM_HERE, base::BindOnce(&SetFlag, &first_task_executed));
   run_loop_->TaskRunner()->PostTask(
-      FROM_HERE, base::BindOnce(
-                     [](std::shared_ptr<base::SequencedTaskRunner> task_runner,
-                        bool* posted_task_executed_ptr) {
-                       task_runner->PostTask(
-                           FROM_HERE,
-                           base::BindOnce(&SetFlag, posted_task_executed_ptr));
-                     },
-                     run_loop_->TaskRunner(), &posted_task_executed));
+      FROM_HERE,
+      base::BindOnce(
+          [](base::scoped_refptr<base::SequencedTaskRunner> task_runner,
+             bool* posted_task_executed_ptr) {
+            task_runner->PostTask(
+                FROM_HERE, base::BindOnce(&SetFlag, posted_task_executed_ptr));
+          },
+          run_loop_->TaskRunner(), &posted_task_executed));
   run_loop_->TaskRunner()->PostTask(
       FROM_HERE, base::BindOnce(&SetFlag, &second_task_executed));
 
@@ -166,4 +172,114 @@ TEST_F(RunLoopTest, Run_Advanced) {
   EXPECT_FALSE(can_still_run_once_or_until_idle);
 }
 
+TEST_F(RunLoopTest, IdleTaskRunsAfterPendingTasks) {
+  std::vector<int> order;
+  const auto push = [](std::vector<int>* ext_order, int value) {
+    ext_order->push_back(value);
+  };
+
+  run_loop_->TaskRunner()->PostIdleTask(
+      FROM_HERE, base::BindOnce(
+                     [](std::vector<int>* ext_order,
+                        base::RepeatingClosure quit_closure,
+                        base::TimeTicks /*deadline*/) {
+                       ext_order->push_back(3);
+                       quit_closure.Run();
+                     },
+                     &order, run_loop_->QuitClosure()));
+  run_loop_->TaskRunner()->PostTask(FROM_HERE,
+                                    base::BindOnce(push, &order, 1));
+  run_loop_->TaskRunner()->PostTask(FROM_HERE,
+                                    base::BindOnce(push, &order, 2));
+  run_loop_->Run();
+
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(RunLoopTest, IdleTaskDeadlineBeforeNextDelayedTask) {
+  const auto delay = base::Milliseconds(20);
+  bool delayed_task_executed = false;
+  bool idle_task_executed = false;
+
+  run_loop_->TaskRunner()->PostDelayedTask(
+      FROM_HERE, base::BindOnce(&SetFlag, &delayed_task_executed), delay);
+  const auto delayed_task_time = base::TimeTicks::Now() + delay;
+  run_loop_->TaskRunner()->PostIdleTask(
+      FROM_HERE, base::BindOnce(
+                     [](bool* executed_flag, base::TimeTicks max_deadline,
+                        base::RepeatingClosure quit_closure,
+                        base::TimeTicks deadline) {
+                       *executed_flag = true;
+                       EXPECT_GT(deadline, base::TimeTicks::Now());
+                       EXPECT_LE(deadline, max_deadline);
+                       quit_closure.Run();
+                     },
+                     &idle_task_executed, delayed_task_time,
+                     run_loop_->QuitClosure()));
+  run_loop_->Run();
+
+  EXPECT_TRUE(idle_task_executed);
+  EXPECT_FALSE(delayed_task_executed);
+}
+
+TEST_F(RunLoopTest, IdleTaskDeadlineIgnoresDelayedTasksOfOtherThreads) {
+  base::Thread thread;
+  thread.Start();
+
+  const auto other_delayed_task_time =
+      base::TimeTicks::Now() + base::Milliseconds(10);
+  thread.TaskRunner()->PostDelayedTask(FROM_HERE, base::DoNothing(),
+                                       base::Milliseconds(10));
+  run_loop_->TaskRunner()->PostIdleTask(
+      FROM_HERE, base::BindOnce(
+                     [](base::TimeTicks min_deadline,
+                        base::RepeatingClosure quit_closure,
+                        base::TimeTicks deadline) {
+                       EXPECT_GT(deadline, min_deadline);
+                       quit_closure.Run();
+                     },
+                     other_delayed_task_time, run_loop_->QuitClosure()));
+  run_loop_->Run();
+
+  thread.Stop();
+}
+
+TEST_F(RunLoopTest, IdleTaskCanRepostItself) {
+  int runs = 0;
+  base::RepeatingCallback<void(base::TimeTicks)> idle_task;
+  idle_task = base::BindRepeating(
+      [](int* ext_runs, base::RunLoop* run_loop,
+         base::RepeatingCallback<void(base::TimeTicks)>* self,
+         base::TimeTicks /*deadline*/) {
+        if (++(*ext_runs) == 3) {
+          run_loop->Quit();
+          return;
+        }
+        run_loop->TaskRunner()->PostIdleTask(FROM_HERE, *self);
+      },
+      &runs, run_loop_.get(), &idle_task);
+
+  run_loop_->TaskRunner()->PostIdleTask(FROM_HERE, idle_task);
+  run_loop_->Run();
+
+  EXPECT_EQ(runs, 3);
+}
+
+// Tasks keep their task runner (and so the pump) alive, so the ones that were
+// never run have to be destroyed along with the run loop.
+TEST_F(RunLoopTest, DestroysTasksThatWereNotRun) {
+  auto value = std::make_shared<int>(0);
+  run_loop_->TaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce([](std::shared_ptr<int> /*value*/) {}, value));
+  run_loop_->TaskRunner()->PostIdleTask(
+      FROM_HERE,
+      base::BindOnce([](std::shared_ptr<int> /*value*/,
+                        base::TimeTicks /*deadline*/) {},
+                     value));
+  EXPECT_EQ(value.use_count(), 3);
+
+  run_loop_.reset();
+  EXPECT_EQ(value.use_count(), 1);
+}
+
 }  // namespace
@@ -11,8 +11,9 @@ namespace {
 
 class DeleteNotifier {
  public:
-  DeleteNotifier(bool* flag,
-                 std::shared_ptr<base::SequencedTaskRunner> delete_task_runner)
+  DeleteNotifier(
+      bool* flag,
+      base::scoped_refptr<base::SequencedTaskRunner> delete_task_runner)
       : flag_(flag), delete_task_runner_(std::move(delete_task_runner)) {}
 
   ~DeleteNotifier() {
@@ -32,7 +33,7 @@ class DeleteNotifier {
 
  private:
   bool* flag_;
-  std::shared_ptr<base::SequencedTaskRunner> delete_task_runner_;
+  base::scoped_refptr<base::SequencedTaskRunner> delete_task_runner_;
 };
 
 class SequencedTaskRunnerTest : public ::testing::Test {
@@ -49,7 +50,7 @@ class SequencedTaskRunnerTest : public ::testing::Test {
   }
 
   std::unique_ptr<base::Thread> thread;
-  std::shared_ptr<base::SequencedTaskRunner> task_runner;
+  base::scoped_refptr<base::SequencedTaskRunner> task_runner;
 };
 
 TEST_F(SequencedTaskRunnerTest, DeleteSoonRawPtr) {
@@ -0,0 +1,180 @@
+#include "base/synchronization/async_lock.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void StoreHandle(base::AsyncLock::Handle* output,
+                 base::AsyncLock::Handle handle) {
+  *output = std::move(handle);
+}
+
+void RecordAndRelease(std::vector<std::string>* events,
+                      std::string event,
+                      base::AsyncLock::Handle handle) {
+  EXPECT_TRUE(handle.is_held());
+  events->push_back(std::move(event));
+}
+
+void AcquireAndStore(base::AsyncLock* lock, base::AsyncLock::Handle* output) {
+  lock->Acquire(FROM_HERE, base::BindOnce(&StoreHandle, output));
+}
+
+struct CriticalSectionStats {
+  std::atomic_bool in_critical_section{false};
+  std::atomic_int overlaps{0};
+  int counter = 0;
+};
+
+void RunCriticalSection(CriticalSectionStats* stats,
+                        base::AsyncLock::Handle handle) {
+  EXPECT_TRUE(handle.is_held());
+  if (stats->in_critical_section.exchange(true)) {
+    ++stats->overlaps;
+  }
+  ++stats->counter;
+  stats->in_critical_section = false;
+}
+
+void AcquireForCriticalSection(base::AsyncLock* lock,
+                               CriticalSectionStats* stats) {
+  lock->Acquire(FROM_HERE, base::BindOnce(&RunCriticalSection, stats));
+}
+
+class AsyncLockTest : public ::testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::AsyncLock lock_;
+};
+
+TEST_F(AsyncLockTest, CallbackIsPostedWhenLockIsFree) {
+  base::AsyncLock::Handle handle;
+  lock_.Acquire(FROM_HERE, base::BindOnce(&StoreHandle, &handle));
+  EXPECT_TRUE(lock_.IsLockedForTesting());
+  EXPECT_FALSE(handle.is_held());
+
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(handle.is_held());
+
+  handle.Release();
+  EXPECT_FALSE(handle.is_held());
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+}
+
+TEST_F(AsyncLockTest, GrantsLockInOrder) {
+  std::vector<std::string> events;
+  base::AsyncLock::Handle handle;
+
+  lock_.Acquire(FROM_HERE, base::BindOnce(&StoreHandle, &handle));
+  lock_.Acquire(FROM_HERE,
+                base::BindOnce(&RecordAndRelease, &events, "first"));
+  lock_.Acquire(FROM_HERE,
+                base::BindOnce(&RecordAndRelease, &events, "second"));
+  EXPECT_EQ(lock_.WaitersCountForTesting(), 2u);
+
+  // Waiters are not granted the lock while it's held.
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(handle.is_held());
+  EXPECT_TRUE(events.empty());
+
+  handle.Release();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events, (std::vector<std::string>{"first", "second"}));
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+}
+
+TEST_F(AsyncLockTest, HandleCanBeMoved) {
+  base::AsyncLock::Handle handle;
+  lock_.Acquire(FROM_HERE, base::BindOnce(&StoreHandle, &handle));
+  task_environment_.RunUntilIdle();
+
+  base::AsyncLock::Handle other_handle = std::move(handle);
+  EXPECT_FALSE(handle.is_held());
+  EXPECT_TRUE(other_handle.is_held());
+  EXPECT_TRUE(lock_.IsLockedForTesting());
+
+  other_handle = base::AsyncLock::Handle{};
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+}
+
+TEST_F(AsyncLockTest, CallbackIsPostedToCallersSequence) {
+  base::Thread thread;
+  thread.Start();
+
+  base::AsyncLock::Handle main_handle;
+  base::AsyncLock::Handle thread_handle;
+  lock_.Acquire(FROM_HERE, base::BindOnce(&StoreHandle, &main_handle));
+  thread.TaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AcquireAndStore, &lock_, &thread_handle));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(main_handle.is_held());
+  EXPECT_FALSE(thread_handle.is_held());
+
+  main_handle.Release();
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(thread_handle.is_held());
+
+  thread.TaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&base::AsyncLock::Handle::Release,
+                                base::Unretained(&thread_handle)));
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+
+  thread.Stop();
+}
+
+TEST_F(AsyncLockTest, LockIsReleasedIfCallbackCannotRun) {
+  base::Thread thread;
+  thread.Start();
+
+  base::AsyncLock::Handle main_handle;
+  base::AsyncLock::Handle thread_handle;
+  lock_.Acquire(FROM_HERE, base::BindOnce(&StoreHandle, &main_handle));
+  thread.TaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AcquireAndStore, &lock_, &thread_handle));
+  task_environment_.RunUntilIdle();
+  thread.Stop();
+
+  main_handle.Release();
+  EXPECT_FALSE(thread_handle.is_held());
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+}
+
+TEST_F(AsyncLockTest, ProvidesMutualExclusionAcrossSequences) {
+  constexpr int kSequencesCount = 4;
+  constexpr int kAcquiresPerSequence = 100;
+
+  base::ThreadPool thread_pool{4};
+  thread_pool.Start();
+  CriticalSectionStats stats;
+
+  std::vector<base::scoped_refptr<base::SequencedTaskRunner>> task_runners;
+  for (int i = 0; i < kSequencesCount; ++i) {
+    task_runners.push_back(thread_pool.CreateSequencedTaskRunner());
+  }
+  for (int i = 0; i < kAcquiresPerSequence; ++i) {
+    for (const auto& task_runner : task_runners) {
+      task_runner->PostTask(
+          FROM_HERE,
+          base::BindOnce(&AcquireForCriticalSection, &lock_, &stats));
+    }
+  }
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(stats.counter, kSequencesCount * kAcquiresPerSequence);
+  EXPECT_EQ(stats.overlaps, 0);
+  EXPECT_FALSE(lock_.IsLockedForTesting());
+
+  thread_pool.Stop();
+}
+
+}  // namespace
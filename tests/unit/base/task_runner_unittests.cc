@@ -24,11 +24,11 @@ class TaskRunnerTest : public ::testing::Test {
     thread2.reset();
   }
 
-  std::shared_ptr<base::SequencedTaskRunner> TaskRunner1() {
+  base::scoped_refptr<base::SequencedTaskRunner> TaskRunner1() {
     return thread1->TaskRunner();
   }
 
-  std::shared_ptr<base::SequencedTaskRunner> TaskRunner2() {
+  base::scoped_refptr<base::SequencedTaskRunner> TaskRunner2() {
     return thread2->TaskRunner();
   }
 
@@ -114,4 +114,59 @@ TEST_F(TaskRunnerPostTaskAndReplyWithResultTest, PostTaskAndReplyWithResult) {
   EXPECT_EQ(*task3_result, (7 / 2));
 }
 
+TEST_F(TaskRunnerPostTaskAndReplyWithResultTest, MoveOnlyResult) {
+  base::WaitableEvent finished_event{};
+  std::optional<int> result;
+
+  TaskRunner1()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::scoped_refptr<base::SequencedTaskRunner> task_runner,
+             std::optional<int>* result_ptr, base::AutoSignaller guard) {
+            task_runner->PostTaskAndReplyWithResult(
+                FROM_HERE,
+                base::BindOnce([]() { return std::make_unique<int>(3); }),
+                base::BindOnce(
+                    [](std::optional<int>* reply_result_ptr,
+                       base::AutoSignaller, std::unique_ptr<int> value) {
+                      *reply_result_ptr = *value;
+                    },
+                    result_ptr, std::move(guard)));
+          },
+          TaskRunner2(), &result, base::AutoSignaller{&finished_event}));
+  finished_event.Wait();
+
+  ASSERT_TRUE(result);
+  EXPECT_EQ(*result, 3);
+}
+
+TEST_F(TaskRunnerPostTaskAndReplyWithResultTest, DestroysNotRunReply) {
+  base::WaitableEvent finished_event{};
+  auto value = std::make_shared<int>(0);
+  std::weak_ptr<int> weak_value = value;
+
+  // Tasks posted to a stopped thread are dropped without being run.
+  auto stopped_task_runner = thread2->TaskRunner();
+  thread2->Stop();
+
+  TaskRunner1()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::scoped_refptr<base::SequencedTaskRunner> task_runner,
+             std::shared_ptr<int> value_ptr, base::AutoSignaller) {
+            task_runner->PostTaskAndReplyWithResult(
+                FROM_HERE, base::BindOnce([]() { return 0; }),
+                base::BindOnce(
+                    [](std::shared_ptr<int>, int) {
+                      ADD_FAILURE() << "Reply should not run";
+                    },
+                    std::move(value_ptr)));
+          },
+          stopped_task_runner, std::move(value),
+          base::AutoSignaller{&finished_event}));
+  finished_event.Wait();
+
+  EXPECT_TRUE(weak_value.expired());
+}
+
 }  // namespace
@@ -0,0 +1,149 @@
+#include "base/test/task_environment.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_pool.h"
+#include "base/timer/timer.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using TimeSource = base::test::TaskEnvironment::TimeSource;
+
+void Increment(std::atomic_int* counter) {
+  ++(*counter);
+}
+
+TEST(TaskEnvironmentTest, MockTimeDoesNotAdvanceOnItsOwn) {
+  base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+
+  const auto start_time = base::TimeTicks::Now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(base::TimeTicks::Now(), start_time);
+
+  task_environment.AdvanceClock(base::Seconds(5));
+  EXPECT_EQ(base::TimeTicks::Now(), start_time + base::Seconds(5));
+}
+
+TEST(TaskEnvironmentTest, FastForwardByRunsDelayedTasksOnTime) {
+  base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+  const auto start_time = task_environment.NowTicks();
+  std::vector<base::TimeDelta> run_times;
+
+  const auto record_time = [](std::vector<base::TimeDelta>* ext_run_times,
+                              base::TimeTicks ext_start_time) {
+    ext_run_times->push_back(base::TimeTicks::Now() - ext_start_time);
+  };
+  auto task_runner = task_environment.GetMainThreadTaskRunner();
+  task_runner->PostDelayedTask(
+      FROM_HERE, base::BindOnce(record_time, &run_times, start_time),
+      base::Hours(2));
+  task_runner->PostDelayedTask(
+      FROM_HERE, base::BindOnce(record_time, &run_times, start_time),
+      base::Hours(1));
+
+  task_environment.FastForwardBy(base::Minutes(59));
+  EXPECT_TRUE(run_times.empty());
+
+  task_environment.FastForwardBy(base::Hours(2));
+  EXPECT_EQ(run_times,
+            (std::vector<base::TimeDelta>{base::Hours(1), base::Hours(2)}));
+  EXPECT_EQ(task_environment.NowTicks() - start_time,
+            base::Minutes(59) + base::Hours(2));
+}
+
+TEST(TaskEnvironmentTest, FastForwardByDrivesThreads) {
+  base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+  std::atomic_int counter = 0;
+
+  base::Thread thread;
+  thread.Start();
+  base::ThreadPool thread_pool{2};
+  thread_pool.Start();
+
+  thread.TaskRunner()->PostDelayedTask(
+      FROM_HERE, base::BindOnce(&Increment, &counter), base::Seconds(30));
+  thread_pool.CreateSequencedTaskRunner()->PostDelayedTask(
+      FROM_HERE, base::BindOnce(&Increment, &counter), base::Seconds(60));
+
+  task_environment.FastForwardBy(base::Seconds(29));
+  EXPECT_EQ(counter, 0);
+  task_environment.FastForwardBy(base::Seconds(1));
+  EXPECT_EQ(counter, 1);
+  task_environment.FastForwardBy(base::Seconds(30));
+  EXPECT_EQ(counter, 2);
+}
+
+TEST(TaskEnvironmentTest, RunUntilIdleWaitsForTasksPostedAcrossThreads) {
+  base::test::TaskEnvironment task_environment;
+  std::atomic_int counter = 0;
+
+  base::Thread thread;
+  thread.Start();
+
+  // Main thread -> other thread -> main thread.
+  thread.TaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::scoped_refptr<base::SingleThreadTaskRunner> main_task_runner,
+             std::atomic_int* ext_counter) {
+            ++(*ext_counter);
+            main_task_runner->PostTask(FROM_HERE,
+                                       base::BindOnce(&Increment, ext_counter));
+          },
+          task_environment.GetMainThreadTaskRunner(), &counter));
+
+  task_environment.RunUntilIdle();
+  EXPECT_EQ(counter, 2);
+}
+
+TEST(TaskEnvironmentTest, RepeatingTimer) {
+  base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+  std::atomic_int counter = 0;
+
+  base::RepeatingTimer timer;
+  timer.Start(FROM_HERE, base::Seconds(1),
+              base::BindRepeating(&Increment, &counter));
+
+  task_environment.FastForwardBy(base::Seconds(10));
+  EXPECT_EQ(counter, 10);
+
+  timer.Stop();
+  task_environment.FastForwardBy(base::Seconds(10));
+  EXPECT_EQ(counter, 10);
+}
+
+TEST(TaskEnvironmentTest, FastForwardUntilNoTasksRemain) {
+  base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+  const auto start_time = task_environment.NowTicks();
+  std::atomic_int counter = 0;
+
+  auto task_runner = task_environment.GetMainThreadTaskRunner();
+  task_runner->PostDelayedTask(FROM_HERE, base::BindOnce(&Increment, &counter),
+                               base::Days(1));
+  task_runner->PostDelayedTask(FROM_HERE, base::BindOnce(&Increment, &counter),
+                               base::Days(3));
+
+  task_environment.FastForwardUntilNoTasksRemain();
+  EXPECT_EQ(counter, 2);
+  EXPECT_EQ(task_environment.NowTicks() - start_time, base::Days(3));
+}
+
+TEST(TaskEnvironmentTest, RestoresSystemClock) {
+  base::TimeTicks mock_time;
+  {
+    base::test::TaskEnvironment task_environment{TimeSource::kMockTime};
+    task_environment.AdvanceClock(base::Days(365));
+    mock_time = task_environment.NowTicks();
+  }
+
+  EXPECT_LT(base::TimeTicks::Now(), mock_time);
+}
+
+}  // namespace
@@ -0,0 +1,184 @@
+#include "base/threading/bounded_sequenced_task_runner.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/test/task_environment.h"
+#include "base/threading/task_runner_test_utils.h"
+#include "base/threading/thread.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using OverflowPolicy = base::BoundedSequencedTaskRunner::OverflowPolicy;
+
+void StoreRunsInSequence(base::BoundedSequencedTaskRunner* task_runner,
+                         bool* result) {
+  *result = task_runner->RunsTasksInCurrentSequence();
+}
+
+class BoundedSequencedTaskRunnerTest : public ::testing::Test {
+ protected:
+  base::scoped_refptr<base::BoundedSequencedTaskRunner> CreateTaskRunner(
+      size_t capacity,
+      OverflowPolicy overflow_policy) {
+    return base::BoundedSequencedTaskRunner::Create(
+        task_environment_.GetMainThreadTaskRunner(), capacity,
+        overflow_policy);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::kMockTime};
+  std::vector<std::string> events_;
+};
+
+TEST_F(BoundedSequencedTaskRunnerTest, RunsTasksInOrder) {
+  auto task_runner = CreateTaskRunner(10, OverflowPolicy::kReject);
+
+  for (const char* event : {"a", "b", "c"}) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE, base::BindOnce(&AppendEvent, &events_, event)));
+  }
+  EXPECT_EQ(task_runner->GetQueueDepth(), 3u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(task_runner->GetQueueDepth(), 0u);
+  EXPECT_EQ(task_runner->GetMaxQueueDepth(), 3u);
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, RejectsTasksWhenFull) {
+  auto task_runner = CreateTaskRunner(2, OverflowPolicy::kReject);
+
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "a")));
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "b")));
+  EXPECT_FALSE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "c")));
+  EXPECT_EQ(task_runner->GetQueueDepth(), 2u);
+  EXPECT_EQ(task_runner->GetRejectedTasksCount(), 1u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b"}));
+
+  // There is space again once the tasks are executed.
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "d")));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b", "d"}));
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, DropsOldestTasksWhenFull) {
+  auto task_runner = CreateTaskRunner(2, OverflowPolicy::kDropOldest);
+  int destroyed_count = 0;
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&Consume, std::make_unique<DestructionCounter>(
+                                     &destroyed_count))));
+  }
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "a")));
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "b")));
+
+  // Dropped tasks are destroyed right away.
+  EXPECT_EQ(destroyed_count, 10);
+  EXPECT_EQ(task_runner->GetQueueDepth(), 2u);
+  EXPECT_EQ(task_runner->GetMaxQueueDepth(), 2u);
+  EXPECT_EQ(task_runner->GetDroppedTasksCount(), 10u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, TryPostTaskKeepsTaskWhenFull) {
+  auto task_runner = CreateTaskRunner(1, OverflowPolicy::kReject);
+  base::OnceClosure task_a = base::BindOnce(&AppendEvent, &events_, "a");
+  base::OnceClosure task_b = base::BindOnce(&AppendEvent, &events_, "b");
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, task_a, base::DoNothing()));
+  EXPECT_FALSE(task_runner->TryPostTask(
+      FROM_HERE, task_b, base::BindOnce(&AppendEvent, &events_, "space")));
+  EXPECT_TRUE(task_b);
+  EXPECT_EQ(task_runner->GetQueueDepth(), 1u);
+  EXPECT_EQ(task_runner->GetRejectedTasksCount(), 0u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "space"}));
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, task_b, base::DoNothing()));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "space", "b"}));
+  EXPECT_EQ(task_runner->GetMaxQueueDepth(), 1u);
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, KeepsSingleSpaceWaiterPerSequence) {
+  auto task_runner = CreateTaskRunner(1, OverflowPolicy::kReject);
+  base::OnceClosure task_a = base::BindOnce(&AppendEvent, &events_, "a");
+  base::OnceClosure task_b = base::BindOnce(&AppendEvent, &events_, "b");
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, task_a, base::DoNothing()));
+  for (const char* event : {"space 1", "space 2", "space 3"}) {
+    EXPECT_FALSE(task_runner->TryPostTask(
+        FROM_HERE, task_b, base::BindOnce(&AppendEvent, &events_, event)));
+  }
+
+  // Only the most recent notification is kept.
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "space 3"}));
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, DropsTasksWhenUnderlyingRunnerStopped) {
+  base::Thread thread;
+  thread.Start();
+  auto task_runner = base::BoundedSequencedTaskRunner::Create(
+      thread.TaskRunner(), 2, OverflowPolicy::kReject);
+  thread.Stop();
+  int destroyed_count = 0;
+
+  EXPECT_FALSE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&Consume, std::make_unique<DestructionCounter>(
+                                              &destroyed_count))));
+  EXPECT_EQ(destroyed_count, 1);
+  EXPECT_EQ(task_runner->GetQueueDepth(), 0u);
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, QueuesDelayedTasksWhenDue) {
+  auto task_runner = CreateTaskRunner(1, OverflowPolicy::kReject);
+
+  task_runner->PostDelayedTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "delayed"),
+      base::Milliseconds(10));
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "a")));
+  EXPECT_EQ(task_runner->GetQueueDepth(), 1u);
+
+  task_environment_.FastForwardBy(base::Milliseconds(10));
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "delayed"}));
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, RunsTasksOnUnderlyingSequence) {
+  base::Thread thread;
+  thread.Start();
+  auto task_runner = base::BoundedSequencedTaskRunner::Create(
+      thread.TaskRunner(), 1, OverflowPolicy::kReject);
+  bool runs_in_sequence = false;
+
+  EXPECT_FALSE(task_runner->RunsTasksInCurrentSequence());
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&StoreRunsInSequence, task_runner.get(),
+                                &runs_in_sequence)));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(runs_in_sequence);
+
+  thread.Stop();
+}
+
+}  // namespace
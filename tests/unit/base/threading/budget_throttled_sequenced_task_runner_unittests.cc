@@ -0,0 +1,125 @@
+#include "base/threading/budget_throttled_sequenced_task_runner.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Simulates a task that takes |duration| to execute.
+void RunFor(base::test::TaskEnvironment* task_environment,
+            base::TimeDelta duration,
+            std::vector<std::string>* events,
+            std::string event) {
+  task_environment->AdvanceClock(duration);
+  events->push_back(std::move(event));
+}
+
+class BudgetThrottledSequencedTaskRunnerTest : public ::testing::Test {
+ protected:
+  base::scoped_refptr<base::BudgetThrottledSequencedTaskRunner>
+  CreateTaskRunner(double budget_ratio, base::TimeDelta max_budget) {
+    return base::BudgetThrottledSequencedTaskRunner::Create(
+        task_environment_.GetMainThreadTaskRunner(), budget_ratio, max_budget);
+  }
+
+  void PostTaskRunningFor(base::SequencedTaskRunner* task_runner,
+                          base::TimeDelta duration,
+                          std::string event) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE, base::BindOnce(&RunFor, &task_environment_, duration,
+                                  &events_, std::move(event))));
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::kMockTime};
+  std::vector<std::string> events_;
+};
+
+TEST_F(BudgetThrottledSequencedTaskRunnerTest, RunsTasksWithinBudget) {
+  auto task_runner = CreateTaskRunner(0.5, base::Milliseconds(100));
+
+  for (const char* event : {"a", "b", "c", "d"}) {
+    PostTaskRunningFor(task_runner.get(), base::Milliseconds(10), event);
+  }
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b", "c", "d"}));
+  EXPECT_FALSE(task_runner->IsThrottled());
+  EXPECT_EQ(task_runner->GetThrottledCount(), 0u);
+  // Budget is capped, but refills by 5ms while each task is running.
+  EXPECT_EQ(task_runner->GetRemainingBudget(), base::Milliseconds(75));
+}
+
+TEST_F(BudgetThrottledSequencedTaskRunnerTest, HoldsTasksBackUntilRefilled) {
+  auto task_runner = CreateTaskRunner(0.5, base::Milliseconds(100));
+
+  for (const char* event : {"a", "b", "c"}) {
+    PostTaskRunningFor(task_runner.get(), base::Milliseconds(100), event);
+  }
+  task_environment_.RunUntilIdle();
+
+  // The second task overdraws the budget by 50ms, which refills in 100ms.
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b"}));
+  EXPECT_TRUE(task_runner->IsThrottled());
+  EXPECT_EQ(task_runner->GetRemainingBudget(), base::Milliseconds(-50));
+
+  task_environment_.FastForwardBy(base::Milliseconds(99));
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b"}));
+
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(task_runner->GetThrottledCount(), 1u);
+}
+
+TEST_F(BudgetThrottledSequencedTaskRunnerTest, BudgetRefillsWhileIdle) {
+  auto task_runner = CreateTaskRunner(0.25, base::Milliseconds(100));
+
+  PostTaskRunningFor(task_runner.get(), base::Milliseconds(200), "a");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(task_runner->GetRemainingBudget(), base::Milliseconds(-100));
+
+  // No task is held back once the budget refilled.
+  task_environment_.AdvanceClock(base::Milliseconds(400));
+  PostTaskRunningFor(task_runner.get(), base::Milliseconds(10), "b");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "b"}));
+  EXPECT_FALSE(task_runner->IsThrottled());
+  EXPECT_EQ(task_runner->GetThrottledCount(), 0u);
+}
+
+TEST_F(BudgetThrottledSequencedTaskRunnerTest, LimitsShareOfExecutionTime) {
+  auto task_runner = CreateTaskRunner(0.2, base::Milliseconds(10));
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
+  for (int i = 0; i < 50; ++i) {
+    PostTaskRunningFor(task_runner.get(), base::Milliseconds(10),
+                       std::to_string(i));
+  }
+  task_environment_.FastForwardUntilNoTasksRemain();
+
+  // Apart from the first two tasks (run with the initial budget), each 10ms
+  // task is followed by 40ms of throttling.
+  EXPECT_EQ(events_.size(), 50u);
+  EXPECT_EQ(base::TimeTicks::Now() - start_time, base::Milliseconds(2420));
+}
+
+TEST_F(BudgetThrottledSequencedTaskRunnerTest, RunsDelayedTasks) {
+  auto task_runner = CreateTaskRunner(0.5, base::Milliseconds(100));
+
+  task_runner->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&RunFor, &task_environment_, base::TimeDelta{}, &events_,
+                     "delayed"),
+      base::Milliseconds(10));
+  PostTaskRunningFor(task_runner.get(), base::TimeDelta{}, "a");
+
+  task_environment_.FastForwardBy(base::Milliseconds(10));
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "delayed"}));
+}
+
+}  // namespace
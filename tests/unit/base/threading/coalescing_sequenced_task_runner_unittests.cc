@@ -0,0 +1,133 @@
+#include "base/threading/coalescing_sequenced_task_runner.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "base/threading/task_runner_test_utils.h"
+#include "base/threading/thread.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using CoalescingPolicy = base::CoalescingSequencedTaskRunner::CoalescingPolicy;
+
+void PostCoalescedEvent(base::CoalescingSequencedTaskRunner* task_runner,
+                        std::vector<std::string>* events,
+                        std::string key,
+                        std::string event) {
+  task_runner->PostCoalescedTask(
+      FROM_HERE, key, base::BindOnce(&AppendEvent, events, std::move(event)));
+}
+
+class CoalescingSequencedTaskRunnerTest : public ::testing::Test {
+ protected:
+  base::scoped_refptr<base::CoalescingSequencedTaskRunner> CreateTaskRunner() {
+    return base::CoalescingSequencedTaskRunner::Create(
+        task_environment_.GetMainThreadTaskRunner());
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::vector<std::string> events_;
+};
+
+TEST_F(CoalescingSequencedTaskRunnerTest, ReplacesPendingTask) {
+  auto task_runner = CreateTaskRunner();
+
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "a")));
+  for (const char* event : {"x1", "x2", "x3"}) {
+    EXPECT_TRUE(task_runner->PostCoalescedTask(
+        FROM_HERE, "x", base::BindOnce(&AppendEvent, &events_, event)));
+  }
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&AppendEvent, &events_, "b")));
+  EXPECT_EQ(task_runner->GetPendingCoalescedTasksCount(), 1u);
+  EXPECT_EQ(task_runner->GetReplacedTasksCount(), 2u);
+  EXPECT_EQ(task_runner->GetDroppedTasksCount(), 0u);
+
+  // The last task is executed in place of the first one.
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "x3", "b"}));
+  EXPECT_EQ(task_runner->GetPendingCoalescedTasksCount(), 0u);
+}
+
+TEST_F(CoalescingSequencedTaskRunnerTest, KeepsPendingTask) {
+  auto task_runner = CreateTaskRunner();
+
+  for (const char* event : {"x1", "x2", "x3"}) {
+    EXPECT_TRUE(task_runner->PostCoalescedTask(
+        FROM_HERE, "x", base::BindOnce(&AppendEvent, &events_, event),
+        CoalescingPolicy::kKeepPending));
+  }
+  EXPECT_EQ(task_runner->GetReplacedTasksCount(), 0u);
+  EXPECT_EQ(task_runner->GetDroppedTasksCount(), 2u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"x1"}));
+}
+
+TEST_F(CoalescingSequencedTaskRunnerTest, CoalescesOnlyTasksWithSameKey) {
+  auto task_runner = CreateTaskRunner();
+
+  task_runner->PostCoalescedTask(FROM_HERE, "x",
+                                 base::BindOnce(&AppendEvent, &events_, "x1"));
+  task_runner->PostCoalescedTask(FROM_HERE, "y",
+                                 base::BindOnce(&AppendEvent, &events_, "y1"));
+  task_runner->PostCoalescedTask(FROM_HERE, "x",
+                                 base::BindOnce(&AppendEvent, &events_, "x2"));
+  EXPECT_EQ(task_runner->GetPendingCoalescedTasksCount(), 2u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"x2", "y1"}));
+}
+
+TEST_F(CoalescingSequencedTaskRunnerTest, RunningTaskIsNotCoalesced) {
+  auto task_runner = CreateTaskRunner();
+
+  // The first task is no longer pending when it posts the next one.
+  task_runner->PostCoalescedTask(
+      FROM_HERE, "x",
+      base::BindOnce(&PostCoalescedEvent, task_runner.get(), &events_, "x",
+                     "x2"));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"x2"}));
+  EXPECT_EQ(task_runner->GetReplacedTasksCount(), 0u);
+}
+
+TEST_F(CoalescingSequencedTaskRunnerTest, DestroysCoalescedTasks) {
+  auto task_runner = CreateTaskRunner();
+  int destroyed_count = 0;
+
+  for (int i = 0; i < 10; ++i) {
+    task_runner->PostCoalescedTask(
+        FROM_HERE, "x",
+        base::BindOnce(&Consume,
+                       std::make_unique<DestructionCounter>(&destroyed_count)));
+  }
+  EXPECT_EQ(destroyed_count, 9);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(destroyed_count, 10);
+}
+
+TEST_F(CoalescingSequencedTaskRunnerTest, DroppedTaskIsNoLongerPending) {
+  base::Thread thread;
+  thread.Start();
+  auto task_runner =
+      base::CoalescingSequencedTaskRunner::Create(thread.TaskRunner());
+  thread.Stop();
+
+  EXPECT_FALSE(task_runner->PostCoalescedTask(
+      FROM_HERE, "x", base::BindOnce(&AppendEvent, &events_, "x1")));
+  EXPECT_EQ(task_runner->GetPendingCoalescedTasksCount(), 0u);
+  EXPECT_FALSE(task_runner->PostCoalescedTask(
+      FROM_HERE, "x", base::BindOnce(&AppendEvent, &events_, "x2")));
+  EXPECT_EQ(task_runner->GetReplacedTasksCount(), 0u);
+  EXPECT_TRUE(events_.empty());
+}
+
+}  // namespace
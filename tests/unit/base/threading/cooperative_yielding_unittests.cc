@@ -0,0 +1,140 @@
+#include "base/threading/cooperative_yielding.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void AppendEvent(std::vector<std::string>* events, std::string event) {
+  events->push_back(std::move(event));
+}
+
+void StoreShouldYield(bool* result) {
+  *result = base::ShouldYield();
+}
+
+void PostTaskAndStoreShouldYield(
+    base::scoped_refptr<base::SequencedTaskRunner> task_runner,
+    bool* result) {
+  task_runner->PostTask(FROM_HERE, base::DoNothing());
+  *result = base::ShouldYield();
+}
+
+// Single step of a loop with |steps_count| steps. The step with index
+// |post_at_step| also posts another task to the current sequence. Each step
+// takes |step_duration| of mock time.
+bool RunStep(base::test::TaskEnvironment* task_environment,
+             base::TimeDelta step_duration,
+             std::vector<std::string>* events,
+             int* step,
+             int steps_count,
+             int post_at_step) {
+  const int current_step = (*step)++;
+  events->push_back("step" + std::to_string(current_step));
+  if (current_step == post_at_step) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&AppendEvent, events, "other"));
+  }
+  task_environment->AdvanceClock(step_duration);
+  return *step < steps_count;
+}
+
+void StartYieldingLoop(base::test::TaskEnvironment* task_environment,
+                       base::TimeDelta step_duration,
+                       std::vector<std::string>* events,
+                       int* step,
+                       int steps_count,
+                       int post_at_step) {
+  base::RunYieldingLoop(
+      FROM_HERE,
+      base::BindRepeating(&RunStep, task_environment, step_duration, events,
+                          step, steps_count, post_at_step),
+      base::BindOnce(&AppendEvent, events, "done"));
+}
+
+class CooperativeYieldingTest : public ::testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::kMockTime};
+  std::vector<std::string> events_;
+};
+
+TEST_F(CooperativeYieldingTest, ShouldNotYieldOutsideOfTasks) {
+  EXPECT_FALSE(base::ShouldYield());
+}
+
+TEST_F(CooperativeYieldingTest, ShouldNotYieldWithoutOtherWork) {
+  bool should_yield = true;
+  task_environment_.GetMainThreadTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&StoreShouldYield, &should_yield));
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(should_yield);
+}
+
+TEST_F(CooperativeYieldingTest, ShouldYieldWhenTaskIsPostedToSameSequence) {
+  bool should_yield = false;
+  auto task_runner = task_environment_.GetMainThreadTaskRunner();
+  task_runner->PostTask(FROM_HERE,
+                        base::BindOnce(&PostTaskAndStoreShouldYield,
+                                       task_runner, &should_yield));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(should_yield);
+}
+
+TEST_F(CooperativeYieldingTest, ShouldYieldWhenOtherSequenceWaits) {
+  base::ThreadPool thread_pool{1};
+  thread_pool.Start();
+
+  bool should_yield = false;
+  thread_pool.CreateSequencedTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&PostTaskAndStoreShouldYield,
+                     thread_pool.CreateSequencedTaskRunner(), &should_yield));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(should_yield);
+
+  thread_pool.Stop();
+}
+
+TEST_F(CooperativeYieldingTest, YieldingLoopRunsAllStepsWithoutOtherWork) {
+  int step = 0;
+  task_environment_.GetMainThreadTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&StartYieldingLoop, &task_environment_,
+                     base::Milliseconds(10), &events_, &step, 3, -1));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_,
+            (std::vector<std::string>{"step0", "step1", "step2", "done"}));
+}
+
+TEST_F(CooperativeYieldingTest, YieldingLoopLetsOtherTasksRunInBetween) {
+  int step = 0;
+  task_environment_.GetMainThreadTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&StartYieldingLoop, &task_environment_,
+                     base::Milliseconds(10), &events_, &step, 4, 1));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"step0", "step1", "other",
+                                                "step2", "step3", "done"}));
+}
+
+TEST_F(CooperativeYieldingTest, YieldingLoopDoesNotCheckAfterEveryShortStep) {
+  int step = 0;
+  task_environment_.GetMainThreadTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&StartYieldingLoop, &task_environment_,
+                     base::Microseconds(1), &events_, &step, 4, 1));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"step0", "step1", "step2",
+                                                "step3", "done", "other"}));
+}
+
+}  // namespace
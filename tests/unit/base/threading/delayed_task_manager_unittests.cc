@@ -2,10 +2,13 @@
 
 #include <atomic>
 #include <memory>
+#include <utility>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_pump.h"
+#include "base/message_loop/message_pump_impl.h"
 #include "base/message_loop/mock_message_pump.h"
 #include "base/synchronization/auto_signaller.h"
 #include "base/synchronization/waitable_event.h"
@@ -53,13 +56,46 @@ bool ExecutePendingTask(base::MessagePump::PendingTask pending_task) {
   return true;
 }
 
+class WeakTarget {
+ public:
+  void Consume(std::shared_ptr<int> /*value*/) {}
+
+  base::WeakPtr<WeakTarget> GetWeakPtr() const {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  base::WeakPtrFactory<WeakTarget> weak_factory_{this};
+};
+
+// Queues an empty delayed task to |dtm| when destroyed.
+class PostsOnDestruction {
+ public:
+  PostsOnDestruction(base::DelayedTaskManager* dtm,
+                     base::scoped_refptr<base::MessagePump> message_pump)
+      : dtm_(dtm), message_pump_(std::move(message_pump)) {}
+  PostsOnDestruction(PostsOnDestruction&& other) noexcept
+      : dtm_(std::exchange(other.dtm_, nullptr)),
+        message_pump_(std::move(other.message_pump_)) {}
+  ~PostsOnDestruction() {
+    if (dtm_) {
+      dtm_->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+          AsTimeTicks(base::Seconds(2)), message_pump_, GetEmptyPendingTask()});
+    }
+  }
+
+ private:
+  base::DelayedTaskManager* dtm_;
+  base::scoped_refptr<base::MessagePump> message_pump_;
+};
+
 class DelayedTaskManagerTest : public ::testing::Test {
  public:
   void SetUp() override {
     SetMockedTimeTicks(base::TimeTicks{});
 
     dtm = std::make_unique<base::DelayedTaskManager>(GetTimeTicksProvider());
-    mock_message_pump_ = std::make_unique<MockMessagePump>();
+    mock_message_pump_ = base::MakeRefCounted<MockMessagePump>();
 
     ON_CALL(*mock_message_pump_, QueuePendingTask)
         .WillByDefault(&ExecutePendingTask);
@@ -75,7 +111,7 @@ class DelayedTaskManagerTest : public ::testing::Test {
   }
 
   std::unique_ptr<base::DelayedTaskManager> dtm;
-  std::shared_ptr<MockMessagePump> mock_message_pump_;
+  base::scoped_refptr<MockMessagePump> mock_message_pump_;
 };
 
 TEST_F(DelayedTaskManagerTest, QueueImmediatelyAtTaskTime) {
@@ -118,6 +154,87 @@ TEST_F(DelayedTaskManagerTest, QueueAfterTimeProgresses) {
   dtm->ScheduleAllReadyTasksForTests();
 }
 
+TEST_F(DelayedTaskManagerTest, CancelledTasksAreNotScheduled) {
+  auto target = std::make_unique<WeakTarget>();
+
+  EXPECT_CALL(*mock_message_pump_, QueuePendingTask).Times(0);
+  dtm->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+      AsTimeTicks(base::Seconds(1)), mock_message_pump_,
+      GetPendingTask(base::BindOnce(&WeakTarget::Consume, target->GetWeakPtr(),
+                                    nullptr))});
+  target.reset();
+
+  SetMockedTimeTicks(base::Seconds(1));
+  dtm->ScheduleAllReadyTasksForTests();
+  EXPECT_FALSE(dtm->NextDelayedTaskTime());
+}
+
+TEST_F(DelayedTaskManagerTest, CancelledTasksAreDestroyedOutsideOfLock) {
+  auto target = std::make_unique<WeakTarget>();
+
+  EXPECT_CALL(*mock_message_pump_, QueuePendingTask).Times(0);
+  auto pending_task = GetPendingTask(
+      base::BindOnce(&WeakTarget::Consume, target->GetWeakPtr(), nullptr));
+  pending_task.expiry = std::make_unique<base::MessagePump::TaskExpiry>(
+      base::MessagePump::TaskExpiry{
+          AsTimeTicks(base::Seconds(60)),
+          base::BindOnce([](const PostsOnDestruction&) {},
+                         PostsOnDestruction{dtm.get(), mock_message_pump_}),
+          FROM_HERE});
+  dtm->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+      AsTimeTicks(base::Seconds(1)), mock_message_pump_,
+      std::move(pending_task)});
+  target.reset();
+
+  // Destroying the notification of the cancelled task queues a new one.
+  SetMockedTimeTicks(base::Seconds(1));
+  dtm->ScheduleAllReadyTasksForTests();
+  EXPECT_EQ(dtm->NextDelayedTaskTime(), AsTimeTicks(base::Seconds(2)));
+}
+
+TEST_F(DelayedTaskManagerTest, CancelledTasksAreSweptWhenQueueGrows) {
+  auto target = std::make_unique<WeakTarget>();
+  auto value = std::make_shared<int>(0);
+  const std::weak_ptr<int> weak_value = value;
+
+  EXPECT_CALL(*mock_message_pump_, QueuePendingTask).Times(0);
+  for (int i = 0; i < 10; ++i) {
+    dtm->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+        AsTimeTicks(base::Seconds(1)), mock_message_pump_,
+        GetPendingTask(base::BindOnce(&WeakTarget::Consume,
+                                      target->GetWeakPtr(), value))});
+  }
+  value.reset();
+  target.reset();
+  EXPECT_FALSE(weak_value.expired());
+
+  // Cancelled tasks are released long before they are due.
+  for (int i = 0; i < 1000 && !weak_value.expired(); ++i) {
+    dtm->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+        AsTimeTicks(base::Seconds(2)), mock_message_pump_,
+        GetEmptyPendingTask()});
+  }
+  EXPECT_TRUE(weak_value.expired());
+  EXPECT_EQ(dtm->NextDelayedTaskTime(), AsTimeTicks(base::Seconds(2)));
+}
+
+TEST_F(DelayedTaskManagerTest, InformsPumpAboutDelayedWakeUps) {
+  const base::MessagePump::ExecutorId kExecutorId = 0;
+  auto pump = base::MakeRefCounted<base::MessagePumpImpl>(1);
+
+  dtm->QueueDelayedTask(base::DelayedTaskManager::DelayedTask{
+      AsTimeTicks(base::Seconds(1)), pump,
+      {base::DoNothing{}, {}, kExecutorId, {}}});
+  EXPECT_EQ(pump->GetNextDelayedWakeUp(kExecutorId),
+            AsTimeTicks(base::Seconds(1)));
+
+  // Wake-up is removed once the task is queued to the pump.
+  SetMockedTimeTicks(base::Seconds(1));
+  dtm->ScheduleAllReadyTasksForTests();
+  EXPECT_FALSE(pump->GetNextDelayedWakeUp(kExecutorId));
+  EXPECT_TRUE(pump->GetNextPendingTask(kExecutorId, false));
+}
+
 //
 //
 //
@@ -0,0 +1,138 @@
+#include "base/threading/dropped_task_counters.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "base/bind.h"
+#include "base/message_loop/run_loop.h"
+#include "base/mock_sequenced_task_runner.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void SetFlag(bool* flag) {
+  *flag = true;
+}
+
+class DroppedTaskCountersTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    base::DroppedTaskCounters::ResetForTesting();
+    run_loop_ = std::make_unique<base::RunLoop>();
+  }
+  void TearDown() override { run_loop_.reset(); }
+
+ protected:
+  std::unique_ptr<base::RunLoop> run_loop_;
+};
+
+TEST_F(DroppedTaskCountersTest, CountsPerLocation) {
+  const auto location_1 = FROM_HERE;
+  const auto location_2 = FROM_HERE;
+
+  base::DroppedTaskCounters::RecordDroppedTask(location_1);
+  base::DroppedTaskCounters::RecordDroppedTask(location_1);
+  base::DroppedTaskCounters::RecordDroppedTask(location_2);
+
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location_1), 2u);
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location_2), 1u);
+  EXPECT_EQ(base::DroppedTaskCounters::GetAllDroppedTasksCounts().size(), 2u);
+
+  base::DroppedTaskCounters::ResetForTesting();
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location_1), 0u);
+}
+
+TEST_F(DroppedTaskCountersTest, ComparesFileNamesByContents) {
+  std::string file_1 = "file.cc";
+  const std::string file_2 = "file.cc";
+
+  base::DroppedTaskCounters::RecordDroppedTask({file_1.c_str(), 13});
+  base::DroppedTaskCounters::RecordDroppedTask({file_2.c_str(), 13});
+  // Returned counters don't refer to the recorded file names.
+  file_1.assign("other.cc");
+
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount({"file.cc", 13}),
+            2u);
+  const auto counters = base::DroppedTaskCounters::GetAllDroppedTasksCounts();
+  ASSERT_EQ(counters.size(), 1u);
+  EXPECT_EQ(counters[0].first.first, "file.cc");
+  EXPECT_EQ(counters[0].first.second, 13u);
+  EXPECT_EQ(counters[0].second, 2u);
+}
+
+TEST_F(DroppedTaskCountersTest, ExpiredTaskIsDroppedAndCounted) {
+  const auto location = FROM_HERE;
+  bool task_executed = false;
+  bool on_dropped_executed = false;
+
+  run_loop_->TaskRunner()->PostTaskWithExpiry(
+      location, base::BindOnce(&SetFlag, &task_executed),
+      base::TimeTicks::Now(), base::BindOnce(&SetFlag, &on_dropped_executed));
+  run_loop_->RunUntilIdle();
+
+  EXPECT_FALSE(task_executed);
+  EXPECT_TRUE(on_dropped_executed);
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location), 1u);
+}
+
+TEST_F(DroppedTaskCountersTest, TaskWithinMaxQueueingDelayIsExecuted) {
+  const auto location = FROM_HERE;
+  bool task_executed = false;
+  bool on_dropped_executed = false;
+
+  run_loop_->TaskRunner()->PostTaskWithMaxQueueingDelay(
+      location, base::BindOnce(&SetFlag, &task_executed), base::Seconds(60),
+      base::BindOnce(&SetFlag, &on_dropped_executed));
+  run_loop_->RunUntilIdle();
+
+  EXPECT_TRUE(task_executed);
+  EXPECT_FALSE(on_dropped_executed);
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location), 0u);
+}
+
+TEST_F(DroppedTaskCountersTest, TaskStuckInQueueExpires) {
+  const auto location = FROM_HERE;
+  bool task_executed = false;
+
+  run_loop_->TaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }));
+  run_loop_->TaskRunner()->PostTaskWithMaxQueueingDelay(
+      location, base::BindOnce(&SetFlag, &task_executed),
+      base::Milliseconds(5));
+  run_loop_->RunUntilIdle();
+
+  EXPECT_FALSE(task_executed);
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location), 1u);
+}
+
+TEST_F(DroppedTaskCountersTest, DefaultImplementationChecksExpiryBeforeRun) {
+  const auto location = FROM_HERE;
+  bool task_executed = false;
+  bool on_dropped_executed = false;
+  base::OnceClosure posted_task;
+
+  MockSequencedTaskRunner task_runner;
+  EXPECT_CALL(task_runner, PostDelayedTask)
+      .WillOnce([&](base::SourceLocation, base::OnceClosure task,
+                    base::TimeDelta) {
+        posted_task = std::move(task);
+        return true;
+      });
+
+  EXPECT_TRUE(task_runner.PostTaskWithExpiry(
+      location, base::BindOnce(&SetFlag, &task_executed),
+      base::TimeTicks::Now(), base::BindOnce(&SetFlag, &on_dropped_executed)));
+  ASSERT_TRUE(posted_task);
+  std::move(posted_task).Run();
+
+  EXPECT_FALSE(task_executed);
+  EXPECT_TRUE(on_dropped_executed);
+  EXPECT_EQ(base::DroppedTaskCounters::GetDroppedTasksCount(location), 1u);
+}
+
+}  // namespace
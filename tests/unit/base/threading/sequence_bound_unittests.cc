@@ -0,0 +1,246 @@
+#include "base/threading/sequence_bound.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/mock_sequenced_task_runner.h"
+#include "base/sequence_checker.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Events {
+  std::vector<std::string> events;
+};
+
+class Counter {
+ public:
+  Counter(Events* events, int initial_value)
+      : events_(events), value_(initial_value) {
+    events_->events.push_back("constructed");
+  }
+
+  ~Counter() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    events_->events.push_back("destroyed");
+  }
+
+  void Increment() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    ++value_;
+  }
+
+  void Add(int value) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    value_ += value;
+  }
+
+  int AddAndGet(int value) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    value_ += value;
+    return value_;
+  }
+
+  int Get() const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return value_;
+  }
+
+  void Consume(std::unique_ptr<int> value) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    value_ += *value;
+  }
+
+ private:
+  Events* events_;
+  int value_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+void StoreValue(int* result, int value) {
+  *result = value;
+}
+
+void SetFlag(bool* flag) {
+  *flag = true;
+}
+
+class SequenceBoundTest : public ::testing::Test {
+ public:
+  void SetUp() override { thread_.Start(); }
+
+  void TearDown() override {
+    task_environment_.RunUntilIdle();
+    thread_.Stop();
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::Thread thread_;
+  Events events_;
+};
+
+TEST_F(SequenceBoundTest, DefaultConstructedIsNull) {
+  base::SequenceBound<Counter> counter;
+  EXPECT_TRUE(counter.is_null());
+  EXPECT_FALSE(counter);
+  counter.Reset();
+}
+
+TEST_F(SequenceBoundTest, ConstructsAndDestroysOnItsSequence) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+  EXPECT_FALSE(counter.is_null());
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_.events, std::vector<std::string>{"constructed"});
+
+  counter.Reset();
+  EXPECT_TRUE(counter.is_null());
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_.events,
+            (std::vector<std::string>{"constructed", "destroyed"}));
+}
+
+TEST_F(SequenceBoundTest, CallsAreRunInOrder) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 1};
+  int result = 0;
+
+  counter.AsyncCall(FROM_HERE, &Counter::Increment);
+  counter.AsyncCall(FROM_HERE, &Counter::Add).WithArgs(10);
+  counter.AsyncCall(FROM_HERE, &Counter::Consume)
+      .WithArgs(std::make_unique<int>(100));
+  counter.AsyncCall(FROM_HERE, &Counter::Get)
+      .Then(base::BindOnce(&StoreValue, &result));
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(result, 112);
+}
+
+TEST_F(SequenceBoundTest, RepliesWithResult) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 5};
+  int result = 0;
+
+  counter.AsyncCall(FROM_HERE, &Counter::AddAndGet)
+      .WithArgs(2)
+      .Then(base::BindOnce(&StoreValue, &result));
+  EXPECT_EQ(result, 0);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(result, 7);
+}
+
+TEST_F(SequenceBoundTest, RepliesToVoidCalls) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+  bool first_replied = false;
+  bool second_replied = false;
+
+  counter.AsyncCall(FROM_HERE, &Counter::Increment)
+      .Then(base::BindOnce(&SetFlag, &first_replied));
+  counter.AsyncCall(FROM_HERE, &Counter::Add)
+      .WithArgs(1)
+      .Then(base::BindOnce(&SetFlag, &second_replied));
+
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(first_replied);
+  EXPECT_TRUE(second_replied);
+}
+
+TEST_F(SequenceBoundTest, IgnoresResultWithoutReply) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+  int result = 0;
+
+  counter.AsyncCall(FROM_HERE, &Counter::AddAndGet).WithArgs(3);
+  counter.AsyncCall(FROM_HERE, &Counter::Get);
+  counter.AsyncCall(FROM_HERE, &Counter::Get)
+      .Then(base::BindOnce(&StoreValue, &result));
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(result, 3);
+}
+
+TEST_F(SequenceBoundTest, DestroyedAfterPendingCalls) {
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+  int result = 0;
+
+  counter.AsyncCall(FROM_HERE, &Counter::Increment);
+  counter.AsyncCall(FROM_HERE, &Counter::Get)
+      .Then(base::BindOnce(&StoreValue, &result));
+  counter.Reset();
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(result, 1);
+  EXPECT_EQ(events_.events,
+            (std::vector<std::string>{"constructed", "destroyed"}));
+}
+
+TEST_F(SequenceBoundTest, MoveTransfersOwnership) {
+  Events other_events;
+  base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+  base::SequenceBound<Counter> other = std::move(counter);
+  EXPECT_TRUE(counter.is_null());
+  EXPECT_FALSE(other.is_null());
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_.events, std::vector<std::string>{"constructed"});
+
+  // Assigning to a non-null instance destroys its previous object.
+  other = base::SequenceBound<Counter>{thread_.TaskRunner(), &other_events, 0};
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_.events,
+            (std::vector<std::string>{"constructed", "destroyed"}));
+  EXPECT_EQ(other_events.events, std::vector<std::string>{"constructed"});
+
+  // The object is destroyed on |thread_|, so it has to be gone before
+  // |other_events| goes out of scope.
+  other.Reset();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(other_events.events,
+            (std::vector<std::string>{"constructed", "destroyed"}));
+}
+
+TEST_F(SequenceBoundTest, DestroyedWithOwner) {
+  {
+    base::SequenceBound<Counter> counter{thread_.TaskRunner(), &events_, 0};
+    counter.AsyncCall(FROM_HERE, &Counter::Increment);
+  }
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_.events,
+            (std::vector<std::string>{"constructed", "destroyed"}));
+}
+
+TEST_F(SequenceBoundTest, CallsArePostedFromGivenLocation) {
+  auto task_runner = base::MakeRefCounted<MockSequencedTaskRunner>();
+  std::vector<base::OnceClosure> tasks;
+  std::vector<size_t> lines;
+  EXPECT_CALL(*task_runner, PostDelayedTask(testing::_, testing::_, testing::_))
+      .WillRepeatedly([&](base::SourceLocation location, base::OnceClosure task,
+                          base::TimeDelta) {
+        lines.push_back(location.line);
+        tasks.push_back(std::move(task));
+        return true;
+      });
+
+  const auto location = FROM_HERE;
+  {
+    base::SequenceBound<Counter> counter{task_runner, &events_, 0};
+    counter.AsyncCall(location, &Counter::Increment);
+  }
+  for (auto& task : tasks) {
+    std::move(task).Run();
+  }
+
+  // Construction, the call and destruction.
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_EQ(lines[1], location.line);
+}
+
+}  // namespace
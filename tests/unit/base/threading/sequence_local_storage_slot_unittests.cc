@@ -0,0 +1,187 @@
+#include "base/threading/sequence_local_storage_slot.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class Tracked {
+ public:
+  Tracked(int* destroyed_count, int value)
+      : destroyed_count_(destroyed_count), value_(value) {}
+  ~Tracked() { ++(*destroyed_count_); }
+
+  int value() const { return value_; }
+
+ private:
+  int* destroyed_count_;
+  int value_;
+};
+
+void IncrementSlotValue(base::SequenceLocalStorageSlot<int>* slot) {
+  ++slot->GetOrCreateValue();
+}
+
+void StoreSlotValue(base::SequenceLocalStorageSlot<int>* slot, int* result) {
+  *result = slot->GetOrCreateValue();
+}
+
+void EmplaceTracked(base::SequenceLocalStorageSlot<Tracked>* slot,
+                    int* destroyed_count,
+                    int value) {
+  slot->emplace(destroyed_count, value);
+}
+
+class DestroyedOn {
+ public:
+  explicit DestroyedOn(std::thread::id* destroyed_on)
+      : destroyed_on_(destroyed_on) {}
+  ~DestroyedOn() { *destroyed_on_ = std::this_thread::get_id(); }
+
+ private:
+  std::thread::id* destroyed_on_;
+};
+
+void EmplaceDestroyedOn(base::SequenceLocalStorageSlot<DestroyedOn>* slot,
+                        std::thread::id* destroyed_on) {
+  slot->emplace(destroyed_on);
+}
+
+TEST(SequenceLocalStorageSlotTest, UsableOnMainThread) {
+  base::test::TaskEnvironment task_environment;
+  base::SequenceLocalStorageSlot<int> slot;
+
+  EXPECT_FALSE(slot);
+  EXPECT_EQ(slot.GetValuePointer(), nullptr);
+
+  slot.GetOrCreateValue() = 5;
+  EXPECT_TRUE(slot);
+  EXPECT_EQ(*slot, 5);
+  EXPECT_EQ(*slot.GetValuePointer(), 5);
+}
+
+TEST(SequenceLocalStorageSlotTest, EmplaceReplacesAndResetDestroysValue) {
+  base::test::TaskEnvironment task_environment;
+  base::SequenceLocalStorageSlot<Tracked> slot;
+  int destroyed_count = 0;
+
+  slot.emplace(&destroyed_count, 1);
+  EXPECT_EQ(slot->value(), 1);
+  EXPECT_EQ(destroyed_count, 0);
+
+  slot.emplace(&destroyed_count, 2);
+  EXPECT_EQ(slot->value(), 2);
+  EXPECT_EQ(destroyed_count, 1);
+
+  slot.reset();
+  EXPECT_FALSE(slot);
+  EXPECT_EQ(destroyed_count, 2);
+
+  // Resetting an empty slot does nothing.
+  slot.reset();
+  EXPECT_EQ(destroyed_count, 2);
+}
+
+TEST(SequenceLocalStorageSlotTest, SlotsAreIndependent) {
+  base::test::TaskEnvironment task_environment;
+  base::SequenceLocalStorageSlot<int> first_slot;
+  base::SequenceLocalStorageSlot<int> second_slot;
+
+  first_slot.emplace(1);
+  EXPECT_FALSE(second_slot);
+
+  second_slot.emplace(2);
+  EXPECT_EQ(*first_slot, 1);
+  EXPECT_EQ(*second_slot, 2);
+}
+
+TEST(SequenceLocalStorageSlotTest, ValuesAreSeparatePerSequence) {
+  base::test::TaskEnvironment task_environment;
+  base::ThreadPool thread_pool{2};
+  thread_pool.Start();
+
+  auto first_task_runner = thread_pool.CreateSequencedTaskRunner();
+  auto second_task_runner = thread_pool.CreateSequencedTaskRunner();
+  base::SequenceLocalStorageSlot<int> slot;
+
+  for (int i = 0; i < 10; ++i) {
+    first_task_runner->PostTask(FROM_HERE,
+                                base::BindOnce(&IncrementSlotValue, &slot));
+  }
+  for (int i = 0; i < 3; ++i) {
+    second_task_runner->PostTask(FROM_HERE,
+                                 base::BindOnce(&IncrementSlotValue, &slot));
+  }
+
+  int first_result = 0;
+  int second_result = 0;
+  first_task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&StoreSlotValue, &slot, &first_result));
+  second_task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&StoreSlotValue, &slot, &second_result));
+  task_environment.RunUntilIdle();
+
+  EXPECT_EQ(first_result, 10);
+  EXPECT_EQ(second_result, 3);
+  EXPECT_FALSE(slot);
+
+  thread_pool.Stop();
+}
+
+TEST(SequenceLocalStorageSlotTest, ValuesAreDestroyedWithTaskRunner) {
+  base::test::TaskEnvironment task_environment;
+  base::SequenceLocalStorageSlot<Tracked> slot;
+  int destroyed_count = 0;
+
+  {
+    base::Thread thread;
+    thread.Start();
+    thread.TaskRunner()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&EmplaceTracked, &slot, &destroyed_count, 1));
+    task_environment.RunUntilIdle();
+    EXPECT_EQ(destroyed_count, 0);
+
+    thread.Stop();
+  }
+
+  EXPECT_EQ(destroyed_count, 1);
+}
+
+TEST(SequenceLocalStorageSlotTest, ValuesAreDestroyedWithLastTaskRunnerRef) {
+  base::test::TaskEnvironment task_environment;
+  base::SequenceLocalStorageSlot<DestroyedOn> slot;
+  std::thread::id destroyed_on;
+
+  base::ThreadPool thread_pool{2};
+  thread_pool.Start();
+  auto task_runner = thread_pool.CreateSequencedTaskRunner();
+  task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&EmplaceDestroyedOn, &slot, &destroyed_on));
+  task_environment.RunUntilIdle();
+  thread_pool.Stop();
+  EXPECT_EQ(destroyed_on, std::thread::id{});
+
+  // Values outlive the threads of the sequence and are destroyed on the thread
+  // which releases the last reference to its task runner.
+  task_runner.reset();
+  EXPECT_EQ(destroyed_on, std::this_thread::get_id());
+}
+
+TEST(SequenceLocalStorageSlotTest, UnusableOutsideOfSequence) {
+  base::SequenceLocalStorageSlot<int> slot;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto)
+  EXPECT_DEATH_IF_SUPPORTED(slot.GetOrCreateValue(),
+                            "SequenceLocalStorageSlot can only be used");
+}
+
+}  // namespace
@@ -0,0 +1,179 @@
+#include "base/threading/task_group.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void AppendEvent(std::vector<std::string>* events, std::string event) {
+  events->push_back(std::move(event));
+}
+
+void Increment(std::atomic_int* counter) {
+  ++(*counter);
+}
+
+class DestructionCounter {
+ public:
+  explicit DestructionCounter(int* destroyed_count)
+      : destroyed_count_(destroyed_count) {}
+  ~DestructionCounter() { ++(*destroyed_count_); }
+
+ private:
+  int* destroyed_count_;
+};
+
+void Consume(std::unique_ptr<DestructionCounter>) {}
+
+// Task runner that keeps posted tasks without running them.
+class RecordingTaskRunner : public base::TaskRunner {
+ public:
+  bool PostDelayedTask(base::SourceLocation /*location*/,
+                       base::OnceClosure task,
+                       base::TimeDelta /*delay*/) override {
+    tasks.push_back(std::move(task));
+    return true;
+  }
+
+  std::vector<base::OnceClosure> tasks;
+};
+
+class TaskGroupTest : public ::testing::Test {
+ protected:
+  base::TaskRunner& main_task_runner() {
+    return *task_environment_.GetMainThreadTaskRunner();
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::vector<std::string> events_;
+};
+
+TEST_F(TaskGroupTest, JoinsAfterAllTasksFinished) {
+  base::ThreadPool thread_pool{2};
+  thread_pool.Start();
+  base::TaskGroup task_group;
+  std::atomic_int counter{0};
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(task_group.PostTask(*thread_pool.CreateSequencedTaskRunner(),
+                                    FROM_HERE,
+                                    base::BindOnce(&Increment, &counter)));
+  }
+  task_group.Join(base::BindOnce(&AppendEvent, &events_, "joined"));
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(counter, 10);
+  EXPECT_EQ(events_, (std::vector<std::string>{"joined"}));
+  EXPECT_EQ(task_group.GetPendingTasksCount(), 0u);
+  EXPECT_FALSE(task_group.IsCancelled());
+
+  thread_pool.Stop();
+}
+
+TEST_F(TaskGroupTest, JoinsEmptyGroup) {
+  base::TaskGroup task_group;
+
+  task_group.Join(base::BindOnce(&AppendEvent, &events_, "joined"));
+  EXPECT_TRUE(events_.empty());
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"joined"}));
+}
+
+TEST_F(TaskGroupTest, CancelledTasksNeverRun) {
+  base::TaskGroup task_group;
+
+  for (const char* event : {"a", "b", "c"}) {
+    EXPECT_TRUE(task_group.PostTask(
+        main_task_runner(), FROM_HERE,
+        base::BindOnce(&AppendEvent, &events_, event)));
+  }
+  task_group.Join(base::BindOnce(&AppendEvent, &events_, "joined"));
+  EXPECT_EQ(task_group.GetPendingTasksCount(), 3u);
+
+  task_group.Cancel();
+  EXPECT_TRUE(task_group.IsCancelled());
+  EXPECT_EQ(task_group.GetPendingTasksCount(), 0u);
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"joined"}));
+
+  // Tasks can't be added to a cancelled group.
+  EXPECT_FALSE(task_group.PostTask(
+      main_task_runner(), FROM_HERE,
+      base::BindOnce(&AppendEvent, &events_, "d")));
+}
+
+TEST_F(TaskGroupTest, CancelDestroysTasksAndMarksThemCancelled) {
+  auto task_runner = base::MakeRefCounted<RecordingTaskRunner>();
+  base::TaskGroup task_group;
+  int destroyed_count = 0;
+
+  EXPECT_TRUE(task_group.PostTask(
+      *task_runner, FROM_HERE,
+      base::BindOnce(&Consume,
+                     std::make_unique<DestructionCounter>(&destroyed_count))));
+  ASSERT_EQ(task_runner->tasks.size(), 1u);
+  EXPECT_TRUE(task_runner->tasks[0].MaybeValid());
+
+  // Task runners can drop cancelled tasks without dispatching them.
+  task_group.Cancel();
+  EXPECT_EQ(destroyed_count, 1);
+  EXPECT_FALSE(task_runner->tasks[0].MaybeValid());
+  EXPECT_TRUE(task_runner->tasks[0].IsCancelled());
+}
+
+TEST_F(TaskGroupTest, TaskCanCancelRestOfGroup) {
+  base::TaskGroup task_group;
+
+  EXPECT_TRUE(task_group.PostTask(
+      main_task_runner(), FROM_HERE,
+      base::BindOnce(&AppendEvent, &events_, "a")));
+  EXPECT_TRUE(task_group.PostTask(main_task_runner(), FROM_HERE,
+                                  task_group.GetCancelCallback()));
+  EXPECT_TRUE(task_group.PostTask(
+      main_task_runner(), FROM_HERE,
+      base::BindOnce(&AppendEvent, &events_, "b")));
+  task_group.Join(base::BindOnce(&AppendEvent, &events_, "joined"));
+
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"a", "joined"}));
+  EXPECT_TRUE(task_group.IsCancelled());
+}
+
+TEST_F(TaskGroupTest, TasksDroppedByTaskRunnerAreNotWaitedFor) {
+  auto task_runner = base::MakeRefCounted<RecordingTaskRunner>();
+  base::TaskGroup task_group;
+
+  EXPECT_TRUE(task_group.PostTask(
+      *task_runner, FROM_HERE, base::BindOnce(&AppendEvent, &events_, "a")));
+  task_group.Join(base::BindOnce(&AppendEvent, &events_, "joined"));
+  EXPECT_EQ(task_group.GetPendingTasksCount(), 1u);
+
+  task_runner->tasks.clear();
+  EXPECT_EQ(task_group.GetPendingTasksCount(), 0u);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(events_, (std::vector<std::string>{"joined"}));
+}
+
+TEST_F(TaskGroupTest, DestroyingGroupCancelsTasks) {
+  {
+    base::TaskGroup task_group;
+    EXPECT_TRUE(task_group.PostTask(
+        main_task_runner(), FROM_HERE,
+        base::BindOnce(&AppendEvent, &events_, "a")));
+  }
+
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(events_.empty());
+}
+
+}  // namespace
@@ -0,0 +1,194 @@
+#include "base/threading/thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void AppendValue(std::vector<int>* values, int value) {
+  values->push_back(value);
+}
+
+struct ConcurrencyStats {
+  std::atomic_int running{0};
+  std::atomic_int max_running{0};
+  std::atomic_int finished{0};
+};
+
+void TrackConcurrency(ConcurrencyStats* stats,
+                      int tasks_count,
+                      base::WaitableEvent* done_event) {
+  const int running = ++stats->running;
+  int max_running = stats->max_running;
+  while (running > max_running &&
+         !stats->max_running.compare_exchange_weak(max_running, running)) {
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  --stats->running;
+  if (++stats->finished == tasks_count) {
+    done_event->Signal();
+  }
+}
+
+void BlockUntilSignaled(base::WaitableEvent* started_event,
+                        base::WaitableEvent* unblock_event) {
+  started_event->Signal();
+  unblock_event->Wait();
+}
+
+void SetFlag(bool* flag) {
+  *flag = true;
+}
+
+class ThreadPoolTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    thread_pool = std::make_unique<base::ThreadPool>(1);
+    thread_pool->Start();
+  }
+  void TearDown() override { thread_pool.reset(); }
+
+  // Blocks the only thread of the pool until returned event is signaled.
+  std::unique_ptr<base::WaitableEvent> BlockPool() {
+    auto unblock_event = std::make_unique<base::WaitableEvent>();
+    base::WaitableEvent blocked_event{};
+    thread_pool->GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](base::WaitableEvent* ext_blocked_event,
+                          base::WaitableEvent* ext_unblock_event) {
+                         ext_blocked_event->Signal();
+                         ext_unblock_event->Wait();
+                       },
+                       &blocked_event, unblock_event.get()));
+    blocked_event.Wait();
+    return unblock_event;
+  }
+
+  std::unique_ptr<base::ThreadPool> thread_pool;
+};
+
+TEST_F(ThreadPoolTest, SequencedTaskRunnerRunsTasks) {
+  base::WaitableEvent event{};
+  auto task_runner = thread_pool->CreateSequencedTaskRunner();
+
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&base::WaitableEvent::Signal,
+                                base::Unretained(&event))));
+  event.Wait();
+}
+
+TEST_F(ThreadPoolTest, DeadlineTaskRunnerRunsEarliestDeadlineFirst) {
+  const auto now = base::TimeTicks::Now();
+  auto first_task_runner = thread_pool->CreateDeadlineTaskRunner();
+  auto second_task_runner = thread_pool->CreateDeadlineTaskRunner();
+  std::vector<int> order;
+
+  auto unblock_event = BlockPool();
+  thread_pool->GetTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AppendValue, &order, 5));
+  first_task_runner->PostTaskWithDeadline(
+      FROM_HERE, base::BindOnce(&AppendValue, &order, 3),
+      now + base::Seconds(3));
+  first_task_runner->PostTaskWithDeadline(
+      FROM_HERE, base::BindOnce(&AppendValue, &order, 4),
+      now + base::Seconds(1));
+  second_task_runner->PostTaskWithDeadline(
+      FROM_HERE, base::BindOnce(&AppendValue, &order, 1),
+      now + base::Seconds(1));
+  second_task_runner->PostTaskWithDeadline(
+      FROM_HERE, base::BindOnce(&AppendValue, &order, 2),
+      now + base::Seconds(2));
+  unblock_event->Signal();
+
+  base::WaitableEvent done_event{};
+  first_task_runner->PostTask(FROM_HERE,
+                              base::BindOnce(&base::WaitableEvent::Signal,
+                                             base::Unretained(&done_event)));
+  done_event.Wait();
+
+  // Tasks from the first runner keep their relative order, even though the
+  // second one has an earlier deadline.
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST_F(ThreadPoolTest, DeadlineTaskRunnerRunsInSequence) {
+  base::WaitableEvent event{};
+  auto task_runner = thread_pool->CreateDeadlineTaskRunner();
+
+  task_runner->PostTaskWithDeadline(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::DeadlineTaskRunner* ext_task_runner,
+             base::WaitableEvent* ext_event) {
+            EXPECT_TRUE(ext_task_runner->RunsTasksInCurrentSequence());
+            ext_event->Signal();
+          },
+          task_runner.get(), &event),
+      base::TimeTicks::Now());
+  event.Wait();
+  EXPECT_FALSE(task_runner->RunsTasksInCurrentSequence());
+}
+
+TEST(ThreadPoolParallelTaskRunnerTest, LimitsConcurrency) {
+  constexpr int kTasksCount = 20;
+  base::ThreadPool thread_pool{4};
+  thread_pool.Start();
+  auto task_runner = thread_pool.CreateParallelTaskRunner(2);
+
+  ConcurrencyStats stats;
+  base::WaitableEvent done_event{};
+  for (int i = 0; i < kTasksCount; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&TrackConcurrency, &stats, kTasksCount, &done_event)));
+  }
+  done_event.Wait();
+
+  EXPECT_GE(stats.max_running, 1);
+  EXPECT_LE(stats.max_running, 2);
+  thread_pool.Stop();
+}
+
+TEST(ThreadPoolParallelTaskRunnerTest, LeavesRemainingThreadsToOthers) {
+  base::ThreadPool thread_pool{2};
+  thread_pool.Start();
+  auto task_runner = thread_pool.CreateParallelTaskRunner(1);
+
+  base::WaitableEvent started_event{};
+  base::WaitableEvent unblock_event{};
+  bool second_task_run = false;
+  task_runner->PostTask(FROM_HERE, base::BindOnce(&BlockUntilSignaled,
+                                                  &started_event,
+                                                  &unblock_event));
+  task_runner->PostTask(FROM_HERE, base::BindOnce(&SetFlag, &second_task_run));
+  started_event.Wait();
+
+  // The second thread is not occupied by the limited task runner.
+  base::WaitableEvent other_task_event{};
+  thread_pool.GetTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&base::WaitableEvent::Signal,
+                                base::Unretained(&other_task_event)));
+  other_task_event.Wait();
+  EXPECT_FALSE(second_task_run);
+
+  unblock_event.Signal();
+  base::WaitableEvent done_event{};
+  task_runner->PostTask(FROM_HERE,
+                        base::BindOnce(&base::WaitableEvent::Signal,
+                                       base::Unretained(&done_event)));
+  done_event.Wait();
+  EXPECT_TRUE(second_task_run);
+  thread_pool.Stop();
+}
+
+}  // namespace
@@ -65,4 +65,45 @@ TEST_F(ThreadTest, AllQueuedTasksAreExecuted) {
   EXPECT_TRUE(last_task_executed);
 }
 
+TEST_F(ThreadTest, IdleTaskRunsOnlyWhenIdle) {
+  thread->Start();
+
+  base::WaitableEvent blocking_task_started_event{};
+  base::WaitableEvent unblock_event{};
+  base::WaitableEvent idle_task_finished_event{};
+  thread->TaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](base::WaitableEvent* task_started_event,
+             base::WaitableEvent* ext_unblock_event) {
+            task_started_event->Signal();
+            ext_unblock_event->Wait();
+          },
+          &blocking_task_started_event, &unblock_event));
+  blocking_task_started_event.Wait();
+
+  bool task_executed = false;
+  bool task_executed_before_idle_task = false;
+  thread->TaskRunner()->PostIdleTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](bool* executed_flag, bool* result_flag,
+             base::WaitableEvent* finished_event,
+             base::TimeTicks /*deadline*/) {
+            *result_flag = *executed_flag;
+            finished_event->Signal();
+          },
+          &task_executed, &task_executed_before_idle_task,
+          &idle_task_finished_event));
+  thread->TaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce([](bool* executed_flag) { *executed_flag = true; },
+                     &task_executed));
+  unblock_event.Signal();
+
+  idle_task_finished_event.Wait();
+  EXPECT_TRUE(task_executed_before_idle_task);
+  thread->Stop();
+}
+
 }  // namespace
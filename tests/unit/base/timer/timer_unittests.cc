@@ -0,0 +1,309 @@
+#include "base/timer/timer.h"
+
+#include <memory>
+
+#include "base/bind.h"
+#include "base/message_loop/run_loop.h"
+#include "base/timer/elapsed_timer.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const base::TimeDelta kDelay = base::Milliseconds(10);
+
+void Increment(int* counter) {
+  ++(*counter);
+}
+
+struct Payload {
+  int value = 0;
+};
+
+// Restarts |timer| with a task that quits the run loop and reads |payload|
+// (bound to the task that is still running) afterwards.
+template <typename TimerType>
+void RestartTimer(TimerType* timer,
+                  base::RepeatingClosure quit_closure,
+                  int* result,
+                  Payload* payload) {
+  timer->Start(FROM_HERE, kDelay, std::move(quit_closure));
+  *result = payload->value;
+}
+
+class TimerTest : public ::testing::Test {
+ public:
+  void SetUp() override { run_loop_ = std::make_unique<base::RunLoop>(); }
+  void TearDown() override { run_loop_.reset(); }
+
+  void QuitAfter(base::TimeDelta delay) {
+    run_loop_->TaskRunner()->PostDelayedTask(
+        FROM_HERE, run_loop_->QuitClosure(), delay);
+  }
+
+ protected:
+  std::unique_ptr<base::RunLoop> run_loop_;
+};
+
+TEST_F(TimerTest, OneShotTimer_Runs) {
+  base::OneShotTimer timer;
+  base::ElapsedTimer elapsed_timer;
+
+  EXPECT_FALSE(timer.IsRunning());
+  timer.Start(FROM_HERE, kDelay, run_loop_->QuitClosure());
+  EXPECT_TRUE(timer.IsRunning());
+
+  run_loop_->Run();
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_GE(elapsed_timer.Elapsed(), kDelay);
+}
+
+TEST_F(TimerTest, OneShotTimer_Stop) {
+  int counter = 0;
+  base::OneShotTimer timer;
+
+  timer.Start(FROM_HERE, kDelay, base::BindOnce(&Increment, &counter));
+  timer.Stop();
+  EXPECT_FALSE(timer.IsRunning());
+
+  QuitAfter(kDelay * 3);
+  run_loop_->Run();
+  EXPECT_EQ(counter, 0);
+}
+
+TEST_F(TimerTest, OneShotTimer_Restart) {
+  int first_counter = 0;
+  int second_counter = 0;
+  base::OneShotTimer timer;
+
+  timer.Start(FROM_HERE, kDelay, base::BindOnce(&Increment, &first_counter));
+  timer.Start(FROM_HERE, kDelay, base::BindOnce(&Increment, &second_counter));
+
+  QuitAfter(kDelay * 3);
+  run_loop_->Run();
+  EXPECT_EQ(first_counter, 0);
+  EXPECT_EQ(second_counter, 1);
+}
+
+TEST_F(TimerTest, OneShotTimer_RestartEarlier) {
+  int counter = 0;
+  base::OneShotTimer timer;
+  base::ElapsedTimer elapsed_timer;
+
+  timer.Start(FROM_HERE, base::Seconds(10),
+              base::BindOnce(&Increment, &counter));
+  timer.Start(FROM_HERE, kDelay, run_loop_->QuitClosure());
+
+  run_loop_->Run();
+  EXPECT_EQ(counter, 0);
+  EXPECT_LT(elapsed_timer.Elapsed(), base::Seconds(10));
+}
+
+TEST_F(TimerTest, OneShotTimer_FireNow) {
+  int counter = 0;
+  base::OneShotTimer timer;
+
+  timer.Start(FROM_HERE, base::Seconds(10),
+              base::BindOnce(&Increment, &counter));
+  timer.FireNow();
+  EXPECT_EQ(counter, 1);
+  EXPECT_FALSE(timer.IsRunning());
+
+  timer.FireNow();
+  EXPECT_EQ(counter, 1);
+}
+
+TEST_F(TimerTest, OneShotTimer_DestroyedBeforeFiring) {
+  int counter = 0;
+  {
+    base::OneShotTimer timer;
+    timer.Start(FROM_HERE, kDelay, base::BindOnce(&Increment, &counter));
+  }
+
+  QuitAfter(kDelay * 3);
+  run_loop_->Run();
+  EXPECT_EQ(counter, 0);
+}
+
+TEST_F(TimerTest, RetainingOneShotTimer_Reset) {
+  int counter = 0;
+  base::RetainingOneShotTimer timer;
+
+  timer.Start(FROM_HERE, kDelay, base::BindRepeating(&Increment, &counter));
+  EXPECT_EQ(timer.GetCurrentDelay(), kDelay);
+
+  run_loop_->TaskRunner()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](int* runs, base::RetainingOneShotTimer* retaining_timer) {
+            EXPECT_EQ(*runs, 1);
+            EXPECT_FALSE(retaining_timer->IsRunning());
+            retaining_timer->Reset();
+            EXPECT_TRUE(retaining_timer->IsRunning());
+          },
+          &counter, &timer),
+      kDelay * 3);
+
+  QuitAfter(kDelay * 6);
+  run_loop_->Run();
+  EXPECT_EQ(counter, 2);
+}
+
+TEST_F(TimerTest, RetainingOneShotTimer_ResetPostpones) {
+  int counter = 0;
+  base::RetainingOneShotTimer timer;
+
+  timer.Start(FROM_HERE, kDelay * 4,
+              base::BindRepeating(&Increment, &counter));
+
+  // Keep resetting the timer before it fires.
+  base::RepeatingTimer resetter;
+  resetter.Start(FROM_HERE, kDelay,
+                 base::BindRepeating(&base::RetainingOneShotTimer::Reset,
+                                     base::Unretained(&timer)));
+
+  QuitAfter(kDelay * 10);
+  run_loop_->Run();
+  EXPECT_EQ(counter, 0);
+  EXPECT_TRUE(timer.IsRunning());
+}
+
+TEST_F(TimerTest, RetainingOneShotTimer_RestartFromUserTask) {
+  int result = 0;
+  base::RetainingOneShotTimer timer;
+
+  timer.Start(
+      FROM_HERE, kDelay,
+      base::BindRepeating(&RestartTimer<base::RetainingOneShotTimer>, &timer,
+                          run_loop_->QuitClosure(), &result,
+                          base::Owned(new Payload{42})));
+
+  run_loop_->Run();
+  EXPECT_EQ(result, 42);
+}
+
+TEST_F(TimerTest, RepeatingTimer_RunsRepeatedly) {
+  const int kExpectedRuns = 5;
+  int counter = 0;
+  base::RepeatingTimer timer;
+  base::ElapsedTimer elapsed_timer;
+
+  timer.Start(FROM_HERE, kDelay,
+              base::BindRepeating(
+                  [](int* runs, base::RepeatingTimer* repeating_timer,
+                     base::RepeatingClosure quit_closure) {
+                    if (++(*runs) == kExpectedRuns) {
+                      repeating_timer->Stop();
+                      quit_closure.Run();
+                    }
+                  },
+                  &counter, &timer, run_loop_->QuitClosure()));
+
+  run_loop_->Run();
+  EXPECT_EQ(counter, kExpectedRuns);
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_GE(elapsed_timer.Elapsed(), kDelay * kExpectedRuns);
+}
+
+TEST_F(TimerTest, RepeatingTimer_RestartFromUserTask) {
+  int result = 0;
+  base::RepeatingTimer timer;
+
+  timer.Start(FROM_HERE, kDelay,
+              base::BindRepeating(&RestartTimer<base::RepeatingTimer>, &timer,
+                                  run_loop_->QuitClosure(), &result,
+                                  base::Owned(new Payload{42})));
+
+  run_loop_->Run();
+  EXPECT_EQ(result, 42);
+  EXPECT_TRUE(timer.IsRunning());
+}
+
+TEST_F(TimerTest, RepeatingTimer_DoesNotDrift) {
+  const int kExpectedRuns = 5;
+  const base::TimeDelta kPeriod = kDelay * 2;
+  const base::TimeDelta kTaskDuration = kPeriod / 2;
+  int counter = 0;
+  base::RepeatingTimer timer;
+  base::ElapsedTimer elapsed_timer;
+
+  // Each run takes a half of the period. If the next run was scheduled
+  // relative to the end of previous one, this would take 1.5x longer.
+  timer.Start(FROM_HERE, kPeriod,
+              base::BindRepeating(
+                  [](int* runs, base::RepeatingTimer* repeating_timer,
+                     base::RepeatingClosure quit_closure,
+                     base::TimeDelta task_duration) {
+                    base::ElapsedTimer task_timer;
+                    while (task_timer.Elapsed() < task_duration) {
+                    }
+                    if (++(*runs) == kExpectedRuns) {
+                      repeating_timer->Stop();
+                      quit_closure.Run();
+                    }
+                  },
+                  &counter, &timer, run_loop_->QuitClosure(), kTaskDuration));
+
+  run_loop_->Run();
+  EXPECT_EQ(counter, kExpectedRuns);
+  EXPECT_LT(elapsed_timer.Elapsed(),
+            kPeriod * kExpectedRuns + kTaskDuration * (kExpectedRuns - 1));
+}
+
+TEST_F(TimerTest, RepeatingTimer_StopAndReset) {
+  int counter = 0;
+  base::RepeatingTimer timer;
+
+  timer.Start(FROM_HERE, kDelay, base::BindRepeating(&Increment, &counter));
+  timer.Stop();
+  EXPECT_FALSE(timer.IsRunning());
+
+  run_loop_->TaskRunner()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](int* runs, base::RepeatingTimer* repeating_timer) {
+            EXPECT_EQ(*runs, 0);
+            repeating_timer->Reset();
+            EXPECT_TRUE(repeating_timer->IsRunning());
+            EXPECT_EQ(repeating_timer->GetCurrentDelay(), kDelay);
+          },
+          &counter, &timer),
+      kDelay * 3);
+
+  QuitAfter(kDelay * 6);
+  run_loop_->Run();
+  EXPECT_GE(counter, 1);
+}
+
+TEST_F(TimerTest, DeadlineTimer_Runs) {
+  base::DeadlineTimer timer;
+  const auto deadline = base::TimeTicks::Now() + kDelay;
+
+  timer.Start(FROM_HERE, deadline, run_loop_->QuitClosure());
+  EXPECT_TRUE(timer.IsRunning());
+
+  run_loop_->Run();
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_GE(base::TimeTicks::Now(), deadline);
+}
+
+TEST_F(TimerTest, DeadlineTimer_PastDeadline) {
+  base::DeadlineTimer timer;
+
+  timer.Start(FROM_HERE, base::TimeTicks::Now() - kDelay,
+              run_loop_->QuitClosure());
+  run_loop_->Run();
+  EXPECT_FALSE(timer.IsRunning());
+}
+
+TEST_F(TimerTest, CustomTaskRunner) {
+  base::OneShotTimer timer;
+
+  timer.SetTaskRunner(run_loop_->TaskRunner());
+  timer.Start(FROM_HERE, kDelay, run_loop_->QuitClosure());
+
+  run_loop_->Run();
+  EXPECT_FALSE(timer.IsRunning());
+}
+
+}  // namespace
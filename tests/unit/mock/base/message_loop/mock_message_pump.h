@@ -11,5 +11,7 @@ class MockMessagePump : public base::MessagePump {
   // MessagePump
   MOCK_METHOD(PendingTask, GetNextPendingTask, (ExecutorId, bool), (override));
   MOCK_METHOD(bool, QueuePendingTask, (PendingTask), (override));
+  MOCK_METHOD(PendingIdleTask, GetNextIdleTask, (ExecutorId), (override));
+  MOCK_METHOD(bool, QueueIdleTask, (PendingIdleTask), (override));
   MOCK_METHOD(void, Stop, (PendingTask), (override));
 };
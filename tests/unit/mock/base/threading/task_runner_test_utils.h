@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Helpers shared by tests of task runners that run tasks on top of other task
+// runners.
+
+inline void AppendEvent(std::vector<std::string>* events, std::string event) {
+  events->push_back(std::move(event));
+}
+
+class DestructionCounter {
+ public:
+  explicit DestructionCounter(int* destroyed_count)
+      : destroyed_count_(destroyed_count) {}
+  ~DestructionCounter() { ++(*destroyed_count_); }
+
+ private:
+  int* destroyed_count_;
+};
+
+inline void Consume(std::unique_ptr<DestructionCounter>) {}